@@ -4824,6 +4824,7 @@ enum e_network_message_type
 
 	_custom_network_message_text_chat = k_old_network_message_type_count,
 	_custom_network_message_directed_search,
+	_custom_network_message_determinism_verification,
 
 	k_network_message_type_count,
 
@@ -1,6 +1,10 @@
 #include "animations/animation_definitions.hpp"
 
+#include "animations/animation_node_matrices.hpp"
 #include "cache/cache_files.hpp"
+#include "memory/module.hpp"
+
+HOOK_DECLARE_CLASS_MEMBER(0x00785E40, c_model_animation_graph, node_matrices_from_orientations);
 
 const c_model_animation_graph* __cdecl c_model_animation_graph::get(int32 definition_index)
 {
@@ -93,7 +97,29 @@ s_animation_graph_node* c_model_animation_graph::get_node(int32 node_index) cons
 //.text:00785DA0 ; 
 //.text:00785DE0 ; 
 //.text:00785E00 ; 
-//.text:00785E40 ; public: void __cdecl c_model_animation_graph::node_matrices_from_orientations(real_matrix4x3 restrict*, real_orientation const restrict*, real_matrix4x3 const restrict*) const
+
+void __thiscall c_model_animation_graph::node_matrices_from_orientations(real_matrix4x3* node_matrices, const real_orientation* orientations, const real_matrix4x3* root_matrix)
+{
+	//INVOKE_CLASS_MEMBER(0x00785E40, c_model_animation_graph, node_matrices_from_orientations, node_matrices, orientations, root_matrix);
+
+	s_animation_node_hierarchy* hierarchy = animation_node_hierarchy_get(this);
+	int32 state = hierarchy ? hierarchy->state.peek() : _animation_node_hierarchy_empty;
+	if (state == _animation_node_hierarchy_verified && !animation_node_hierarchy_should_sample(hierarchy))
+	{
+		animation_node_matrices_compose_batched(hierarchy, node_matrices, orientations, root_matrix);
+		g_animation_node_matrices_globals.batched_compositions.increment();
+		return;
+	}
+
+	HOOK_INVOKE_CLASS_MEMBER(, c_model_animation_graph, node_matrices_from_orientations, node_matrices, orientations, root_matrix);
+	g_animation_node_matrices_globals.original_compositions.increment();
+
+	if (state == _animation_node_hierarchy_unverified || state == _animation_node_hierarchy_verified)
+	{
+		animation_node_hierarchy_verify(hierarchy, node_matrices, orientations, root_matrix);
+	}
+}
+
 //.text:00785E60 ; public: void __cdecl c_model_animation_graph::node_matrices_from_orientations_with_gun_hand_swap(real_matrix4x3 restrict*, real_orientation const restrict*, real_matrix4x3 const restrict*, int32, int32) const
 //.text:007860D0 ; 
 //.text:00786100 ; 
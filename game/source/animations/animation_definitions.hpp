@@ -161,6 +161,7 @@ public:
 	static const c_model_animation_graph* __cdecl get(int32 definition_index);
 	static const c_model_animation_graph* __cdecl get_from_object_definition(int32 object_definition_index);
 	s_animation_graph_node* get_node(int32 node_index) const;
+	void __thiscall node_matrices_from_orientations(real_matrix4x3* node_matrices, const real_orientation* orientations, const real_matrix4x3* root_matrix);// const
 
 //protected:
 	c_animation_graph_definitions definitions;
@@ -0,0 +1,587 @@
+#include "animations/animation_node_matrices.hpp"
+
+#include "animations/animation_definitions.hpp"
+#include "cseries/cseries_system_memory.hpp"
+#include "math/real_math.hpp"
+#include "objects/objects.hpp"
+#include "profiler/profiler_stopwatch.hpp"
+#include "units/bipeds.hpp"
+
+#include <math.h>
+#include <xmmintrin.h>
+
+s_animation_node_matrices_globals g_animation_node_matrices_globals
+{
+	.enabled = false,
+};
+
+// matrices are a scale followed by twelve floats, loaded and stored as three groups of four plus the last position float
+enum
+{
+	k_animation_node_matrix_floats = sizeof(real_matrix4x3) / sizeof(real32),
+};
+static_assert(k_animation_node_matrix_floats == 13);
+
+static c_stop_watch* animation_node_matrices_stop_watch()
+{
+	static c_stop_watch stop_watch(true);
+	return &stop_watch;
+}
+
+static bool animation_node_hierarchy_build(s_animation_node_hierarchy* hierarchy, const c_model_animation_graph* graph)
+{
+	const c_typed_tag_block<s_animation_graph_node>* skeleton_nodes = &graph->definitions.skeleton_nodes;
+	int32 node_count = skeleton_nodes->count;
+	if (!IN_RANGE_INCLUSIVE(node_count, 1, k_maximum_animation_node_hierarchy_nodes))
+	{
+		return false;
+	}
+
+	int16 depths[k_maximum_animation_node_hierarchy_nodes]{};
+	int32 level_counts[k_maximum_animation_node_hierarchy_nodes]{};
+	int32 level_count = 0;
+	for (int32 node_index = 0; node_index < node_count; node_index++)
+	{
+		// a parent that is out of range or a chain longer than the skeleton is a cycle, the original handles those
+		int32 depth = 0;
+		int32 parent_node_index = skeleton_nodes->begin()[node_index].parent_node_index;
+		while (parent_node_index != NONE)
+		{
+			if (!VALID_INDEX(parent_node_index, node_count) || ++depth >= node_count)
+			{
+				return false;
+			}
+
+			parent_node_index = skeleton_nodes->begin()[parent_node_index].parent_node_index;
+		}
+
+		depths[node_index] = int16(depth);
+		level_counts[depth]++;
+		level_count = MAX(level_count, depth + 1);
+	}
+
+	hierarchy->graph = graph;
+	hierarchy->node_count = node_count;
+	hierarchy->level_count = level_count;
+	hierarchy->level_first_position[0] = 0;
+	for (int32 level_index = 0; level_index < level_count; level_index++)
+	{
+		hierarchy->level_first_position[level_index + 1] = int16(hierarchy->level_first_position[level_index] + level_counts[level_index]);
+	}
+
+	// nodes keep their graph order within a level
+	int32 level_positions[k_maximum_animation_node_hierarchy_nodes]{};
+	for (int32 node_index = 0; node_index < node_count; node_index++)
+	{
+		int32 depth = depths[node_index];
+		int32 position = hierarchy->level_first_position[depth] + level_positions[depth]++;
+		hierarchy->node_indices[position] = int16(node_index);
+		hierarchy->parent_node_indices[position] = skeleton_nodes->begin()[node_index].parent_node_index;
+	}
+
+	return true;
+}
+
+void animation_node_matrices_dispose_from_old_map()
+{
+	s_animation_node_matrices_globals* globals = &g_animation_node_matrices_globals;
+
+	// the graphs of the old map are gone, a new graph may be loaded where one of them was
+	for (int32 hierarchy_index = 0; hierarchy_index < k_maximum_animation_node_hierarchies; hierarchy_index++)
+	{
+		globals->hierarchies[hierarchy_index].state.set(_animation_node_hierarchy_empty);
+	}
+}
+
+// returns the hierarchy of `graph`, flattening it the first time it is seen, `NULL` when batching is off, the table is
+// full or another thread is flattening a graph in the way
+s_animation_node_hierarchy* animation_node_hierarchy_get(const c_model_animation_graph* graph)
+{
+	s_animation_node_matrices_globals* globals = &g_animation_node_matrices_globals;
+
+	if (!globals->enabled || !graph)
+	{
+		return NULL;
+	}
+
+	int32 home_index = int32(uns32(uintptr_t(graph) >> 4) * 0x9E3779B1 % k_maximum_animation_node_hierarchies);
+	for (int32 probe_index = 0; probe_index < k_maximum_animation_node_hierarchies; probe_index++)
+	{
+		s_animation_node_hierarchy* hierarchy = &globals->hierarchies[(home_index + probe_index) % k_maximum_animation_node_hierarchies];
+
+		int32 state = hierarchy->state.peek();
+		if (state == _animation_node_hierarchy_empty)
+		{
+			if (hierarchy->state.set_if_equal(_animation_node_hierarchy_building, _animation_node_hierarchy_empty) != _animation_node_hierarchy_empty)
+			{
+				return NULL;
+			}
+
+			if (!animation_node_hierarchy_build(hierarchy, graph))
+			{
+				hierarchy->graph = graph;
+				hierarchy->state.set(_animation_node_hierarchy_mismatched);
+				return hierarchy;
+			}
+
+			hierarchy->matched_poses.set(0);
+			hierarchy->batched_compositions.set(0);
+			hierarchy->state.set(_animation_node_hierarchy_unverified);
+			return hierarchy;
+		}
+
+		if (state == _animation_node_hierarchy_building)
+		{
+			return NULL;
+		}
+
+		if (hierarchy->graph == graph)
+		{
+			return hierarchy;
+		}
+	}
+
+	return NULL;
+}
+
+// a verified graph sends one in every `k_animation_node_hierarchy_sample_interval` compositions through the original
+bool animation_node_hierarchy_should_sample(s_animation_node_hierarchy* hierarchy)
+{
+	ASSERT(hierarchy);
+
+	return hierarchy->batched_compositions.increment() % k_animation_node_hierarchy_sample_interval == 0;
+}
+
+// the whole skeleton is composed and compared against the matrices the original produced, a graph is only batched
+// once `k_animation_node_hierarchy_verification_poses` poses in a row matched bit for bit, and it stops being batched
+// on the first pose that doesn't, whether that's while it's being verified or in one of the later samples
+void animation_node_hierarchy_verify(s_animation_node_hierarchy* hierarchy, const real_matrix4x3* original_node_matrices, const real_orientation* orientations, const real_matrix4x3* root_matrix)
+{
+	s_animation_node_matrices_globals* globals = &g_animation_node_matrices_globals;
+	ASSERT(hierarchy);
+	ASSERT(original_node_matrices);
+
+	real_matrix4x3 node_matrices[k_maximum_animation_node_hierarchy_nodes];
+	animation_node_matrices_compose_batched(hierarchy, node_matrices, orientations, root_matrix);
+
+	bool matched = csmemcmp(node_matrices, original_node_matrices, hierarchy->node_count * sizeof(real_matrix4x3)) == 0;
+
+	int32 state = hierarchy->state.peek();
+	if (state == _animation_node_hierarchy_verified)
+	{
+		globals->sampled_compositions.increment();
+	}
+
+	if (!matched)
+	{
+		if (state == _animation_node_hierarchy_unverified || state == _animation_node_hierarchy_verified)
+		{
+			if (hierarchy->state.set_if_equal(_animation_node_hierarchy_mismatched, state) == state)
+			{
+				globals->mismatched_graphs.increment();
+			}
+		}
+		return;
+	}
+
+	if (state == _animation_node_hierarchy_unverified && hierarchy->matched_poses.increment() >= k_animation_node_hierarchy_verification_poses)
+	{
+		hierarchy->state.set_if_equal(_animation_node_hierarchy_verified, _animation_node_hierarchy_unverified);
+	}
+}
+
+// the local matrix of an orientation applied to its parent, the batched version runs exactly these operations
+static void animation_node_apply_orientation(const real_matrix4x3* parent, const real_orientation* orientation, real_matrix4x3* result)
+{
+	real32 x = orientation->rotation.v.i;
+	real32 y = orientation->rotation.v.j;
+	real32 z = orientation->rotation.v.k;
+	real32 w = orientation->rotation.w;
+
+	real32 norm = ((x * x) + (y * y)) + (z * z) + (w * w);
+	real32 s = norm > 0.0f ? 2.0f / norm : 0.0f;
+
+	real32 xs = x * s;
+	real32 ys = y * s;
+	real32 zs = z * s;
+	real32 wx = w * xs;
+	real32 wy = w * ys;
+	real32 wz = w * zs;
+	real32 xx = x * xs;
+	real32 xy = x * ys;
+	real32 xz = x * zs;
+	real32 yy = y * ys;
+	real32 yz = y * zs;
+	real32 zz = z * zs;
+
+	real32 local[3][3]
+	{
+		{ 1.0f - (yy + zz), xy + wz, xz - wy },
+		{ xy - wz, 1.0f - (xx + zz), yz + wx },
+		{ xz + wy, yz - wx, 1.0f - (xx + yy) },
+	};
+
+	for (int32 basis_index = 0; basis_index < 3; basis_index++)
+	{
+		for (int32 row = 0; row < 3; row++)
+		{
+			result->basis[basis_index].n[row] = ((parent->forward.n[row] * local[basis_index][0]) + (parent->left.n[row] * local[basis_index][1])) + (parent->up.n[row] * local[basis_index][2]);
+		}
+	}
+
+	const real_point3d* translation = &orientation->translation;
+	for (int32 row = 0; row < 3; row++)
+	{
+		result->position.n[row] = parent->position.n[row] + (parent->scale * (((parent->forward.n[row] * translation->x) + (parent->left.n[row] * translation->y)) + (parent->up.n[row] * translation->z)));
+	}
+
+	result->scale = parent->scale * orientation->scale;
+}
+
+void animation_node_matrices_compose_scalar(const s_animation_node_hierarchy* hierarchy, real_matrix4x3* node_matrices, const real_orientation* orientations, const real_matrix4x3* root_matrix)
+{
+	ASSERT(hierarchy);
+	ASSERT(node_matrices);
+	ASSERT(orientations);
+
+	const real_matrix4x3* root = root_matrix ? root_matrix : global_identity4x3;
+	for (int32 position = 0; position < hierarchy->node_count; position++)
+	{
+		int32 node_index = hierarchy->node_indices[position];
+		int32 parent_node_index = hierarchy->parent_node_indices[position];
+		const real_matrix4x3* parent = parent_node_index != NONE ? &node_matrices[parent_node_index] : root;
+		animation_node_apply_orientation(parent, &orientations[node_index], &node_matrices[node_index]);
+	}
+}
+
+// four matrices, one register per float
+struct s_animation_node_matrix_batch
+{
+	__m128 scale;
+	__m128 basis[3][3];
+	__m128 position[3];
+};
+
+static void animation_node_matrix_batch_load(const real_matrix4x3* const matrices[4], s_animation_node_matrix_batch* batch)
+{
+	__m128 rows[3][4];
+	for (int32 lane = 0; lane < 4; lane++)
+	{
+		const real32* floats = (const real32*)matrices[lane];
+		rows[0][lane] = _mm_loadu_ps(floats + 0);
+		rows[1][lane] = _mm_loadu_ps(floats + 4);
+		rows[2][lane] = _mm_loadu_ps(floats + 8);
+	}
+
+	for (int32 group = 0; group < 3; group++)
+	{
+		_MM_TRANSPOSE4_PS(rows[group][0], rows[group][1], rows[group][2], rows[group][3]);
+	}
+
+	// scale, forward, left, up then the position, in the order they are laid out
+	batch->scale = rows[0][0];
+	batch->basis[0][0] = rows[0][1];
+	batch->basis[0][1] = rows[0][2];
+	batch->basis[0][2] = rows[0][3];
+	batch->basis[1][0] = rows[1][0];
+	batch->basis[1][1] = rows[1][1];
+	batch->basis[1][2] = rows[1][2];
+	batch->basis[2][0] = rows[1][3];
+	batch->basis[2][1] = rows[2][0];
+	batch->basis[2][2] = rows[2][1];
+	batch->position[0] = rows[2][2];
+	batch->position[1] = rows[2][3];
+	batch->position[2] = _mm_setr_ps(matrices[0]->position.z, matrices[1]->position.z, matrices[2]->position.z, matrices[3]->position.z);
+}
+
+static void animation_node_matrix_batch_store(const s_animation_node_matrix_batch* batch, real_matrix4x3* const matrices[4], int32 lane_count)
+{
+	__m128 rows[3][4]
+	{
+		{ batch->scale, batch->basis[0][0], batch->basis[0][1], batch->basis[0][2] },
+		{ batch->basis[1][0], batch->basis[1][1], batch->basis[1][2], batch->basis[2][0] },
+		{ batch->basis[2][1], batch->basis[2][2], batch->position[0], batch->position[1] },
+	};
+
+	for (int32 group = 0; group < 3; group++)
+	{
+		_MM_TRANSPOSE4_PS(rows[group][0], rows[group][1], rows[group][2], rows[group][3]);
+	}
+
+	real32 last_positions[4];
+	_mm_storeu_ps(last_positions, batch->position[2]);
+
+	for (int32 lane = 0; lane < lane_count; lane++)
+	{
+		real32* floats = (real32*)matrices[lane];
+		_mm_storeu_ps(floats + 0, rows[0][lane]);
+		_mm_storeu_ps(floats + 4, rows[1][lane]);
+		_mm_storeu_ps(floats + 8, rows[2][lane]);
+		floats[12] = last_positions[lane];
+	}
+}
+
+static void animation_node_apply_orientation_batch(const s_animation_node_matrix_batch* parent, const real_orientation* const orientations[4], s_animation_node_matrix_batch* result)
+{
+	__m128 rotation[4];
+	__m128 translation[4];
+	for (int32 lane = 0; lane < 4; lane++)
+	{
+		const real32* floats = (const real32*)orientations[lane];
+		rotation[lane] = _mm_loadu_ps(floats + 0);
+		translation[lane] = _mm_loadu_ps(floats + 4);
+	}
+	_MM_TRANSPOSE4_PS(rotation[0], rotation[1], rotation[2], rotation[3]);
+	_MM_TRANSPOSE4_PS(translation[0], translation[1], translation[2], translation[3]);
+
+	__m128 x = rotation[0];
+	__m128 y = rotation[1];
+	__m128 z = rotation[2];
+	__m128 w = rotation[3];
+
+	__m128 norm = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)), _mm_mul_ps(w, w));
+	__m128 s = _mm_and_ps(_mm_cmpgt_ps(norm, _mm_setzero_ps()), _mm_div_ps(_mm_set1_ps(2.0f), norm));
+
+	__m128 xs = _mm_mul_ps(x, s);
+	__m128 ys = _mm_mul_ps(y, s);
+	__m128 zs = _mm_mul_ps(z, s);
+	__m128 wx = _mm_mul_ps(w, xs);
+	__m128 wy = _mm_mul_ps(w, ys);
+	__m128 wz = _mm_mul_ps(w, zs);
+	__m128 xx = _mm_mul_ps(x, xs);
+	__m128 xy = _mm_mul_ps(x, ys);
+	__m128 xz = _mm_mul_ps(x, zs);
+	__m128 yy = _mm_mul_ps(y, ys);
+	__m128 yz = _mm_mul_ps(y, zs);
+	__m128 zz = _mm_mul_ps(z, zs);
+
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 local[3][3]
+	{
+		{ _mm_sub_ps(one, _mm_add_ps(yy, zz)), _mm_add_ps(xy, wz), _mm_sub_ps(xz, wy) },
+		{ _mm_sub_ps(xy, wz), _mm_sub_ps(one, _mm_add_ps(xx, zz)), _mm_add_ps(yz, wx) },
+		{ _mm_add_ps(xz, wy), _mm_sub_ps(yz, wx), _mm_sub_ps(one, _mm_add_ps(xx, yy)) },
+	};
+
+	for (int32 basis_index = 0; basis_index < 3; basis_index++)
+	{
+		for (int32 row = 0; row < 3; row++)
+		{
+			result->basis[basis_index][row] = _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(parent->basis[0][row], local[basis_index][0]),
+				_mm_mul_ps(parent->basis[1][row], local[basis_index][1])),
+				_mm_mul_ps(parent->basis[2][row], local[basis_index][2]));
+		}
+	}
+
+	for (int32 row = 0; row < 3; row++)
+	{
+		__m128 rotated = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(parent->basis[0][row], translation[0]),
+			_mm_mul_ps(parent->basis[1][row], translation[1])),
+			_mm_mul_ps(parent->basis[2][row], translation[2]));
+		result->position[row] = _mm_add_ps(parent->position[row], _mm_mul_ps(parent->scale, rotated));
+	}
+
+	result->scale = _mm_mul_ps(parent->scale, translation[3]);
+}
+
+void animation_node_matrices_compose_batched(const s_animation_node_hierarchy* hierarchy, real_matrix4x3* node_matrices, const real_orientation* orientations, const real_matrix4x3* root_matrix)
+{
+	ASSERT(hierarchy);
+	ASSERT(node_matrices);
+	ASSERT(orientations);
+
+	const real_matrix4x3* root = root_matrix ? root_matrix : global_identity4x3;
+	for (int32 level_index = 0; level_index < hierarchy->level_count; level_index++)
+	{
+		int32 level_end = hierarchy->level_first_position[level_index + 1];
+		for (int32 position = hierarchy->level_first_position[level_index]; position < level_end; position += 4)
+		{
+			// a short batch repeats its last node in the spare lanes and only stores the lanes it owns
+			int32 lane_count = MIN(level_end - position, 4);
+
+			const real_matrix4x3* parents[4];
+			const real_orientation* lane_orientations[4];
+			real_matrix4x3* results[4];
+			for (int32 lane = 0; lane < 4; lane++)
+			{
+				int32 lane_position = position + MIN(lane, lane_count - 1);
+				int32 node_index = hierarchy->node_indices[lane_position];
+				int32 parent_node_index = hierarchy->parent_node_indices[lane_position];
+
+				parents[lane] = parent_node_index != NONE ? &node_matrices[parent_node_index] : root;
+				lane_orientations[lane] = &orientations[node_index];
+				results[lane] = &node_matrices[node_index];
+			}
+
+			s_animation_node_matrix_batch parent_batch;
+			s_animation_node_matrix_batch result_batch;
+			animation_node_matrix_batch_load(parents, &parent_batch);
+			animation_node_apply_orientation_batch(&parent_batch, lane_orientations, &result_batch);
+			animation_node_matrix_batch_store(&result_batch, results, lane_count);
+		}
+	}
+}
+
+struct s_animation_node_matrices_benchmark_object
+{
+	const c_model_animation_graph* graph;
+	s_animation_node_hierarchy* hierarchy;
+	const real_orientation* orientations;
+	real_matrix4x3 root_matrix;
+};
+
+// composes the skeletons of the bipeds in the world, repeated until there are 64 of them, through the original,
+// the scalar and the batched version
+bool animation_node_matrices_benchmark(int32 iteration_count, s_animation_node_matrices_benchmark_result* result)
+{
+	s_animation_node_matrices_globals* globals = &g_animation_node_matrices_globals;
+	ASSERT(result);
+
+	csmemset(result, 0, sizeof(s_animation_node_matrices_benchmark_result));
+
+	s_animation_node_matrices_benchmark_object objects[k_animation_node_matrices_benchmark_objects];
+	int32 biped_count = 0;
+
+	bool enabled = globals->enabled;
+	globals->enabled = true;
+
+	c_object_iterator<biped_datum> iterator;
+	iterator.begin(_object_mask_biped, 0);
+	while (iterator.next() && biped_count < k_animation_node_matrices_benchmark_objects)
+	{
+		int32 object_index = iterator.get_index();
+		const biped_datum* biped = iterator.get_datum();
+
+		const c_model_animation_graph* graph = c_model_animation_graph::get_from_object_definition(biped->definition_index);
+		s_animation_node_hierarchy* hierarchy = animation_node_hierarchy_get(graph);
+		if (!hierarchy || hierarchy->state.peek() == _animation_node_hierarchy_mismatched)
+		{
+			continue;
+		}
+
+		const object_header_block_reference* node_orientations = &biped->object.node_orientations;
+		if (node_orientations->size != int16(hierarchy->node_count * sizeof(real_orientation)))
+		{
+			continue;
+		}
+
+		s_animation_node_matrices_benchmark_object* object = &objects[biped_count++];
+		object->graph = graph;
+		object->hierarchy = hierarchy;
+		object->orientations = (const real_orientation*)object_header_block_get(object_index, node_orientations);
+		object->root_matrix = *object_get_node_matrix(object_index, 0);
+	}
+
+	if (biped_count <= 0)
+	{
+		globals->enabled = enabled;
+		return false;
+	}
+
+	for (int32 object_index = biped_count; object_index < k_animation_node_matrices_benchmark_objects; object_index++)
+	{
+		objects[object_index] = objects[object_index % biped_count];
+	}
+
+	int32 node_matrices_size = k_animation_node_matrices_benchmark_objects * k_maximum_animation_node_hierarchy_nodes * sizeof(real_matrix4x3);
+	real_matrix4x3* node_matrices[3]{};
+	for (int32 version = 0; version < NUMBEROF(node_matrices); version++)
+	{
+		node_matrices[version] = (real_matrix4x3*)system_malloc(node_matrices_size);
+	}
+
+	if (!node_matrices[0] || !node_matrices[1] || !node_matrices[2])
+	{
+		for (int32 version = 0; version < NUMBEROF(node_matrices); version++)
+		{
+			if (node_matrices[version])
+			{
+				system_free(node_matrices[version]);
+			}
+		}
+
+		globals->enabled = enabled;
+		return false;
+	}
+
+	result->object_count = k_animation_node_matrices_benchmark_objects;
+	result->iteration_count = MAX(iteration_count, 1);
+	for (int32 object_index = 0; object_index < k_animation_node_matrices_benchmark_objects; object_index++)
+	{
+		result->node_count += objects[object_index].hierarchy->node_count;
+	}
+
+	c_stop_watch* stop_watch = animation_node_matrices_stop_watch();
+	int64 cycles[3]{};
+	for (int32 version = 0; version < 3; version++)
+	{
+		// with batching off the hooked graph goes straight to the original
+		globals->enabled = false;
+
+		stop_watch->reset();
+		stop_watch->start();
+		for (int32 iteration = 0; iteration < result->iteration_count; iteration++)
+		{
+			for (int32 object_index = 0; object_index < k_animation_node_matrices_benchmark_objects; object_index++)
+			{
+				const s_animation_node_matrices_benchmark_object* object = &objects[object_index];
+				real_matrix4x3* object_node_matrices = &node_matrices[version][object_index * k_maximum_animation_node_hierarchy_nodes];
+				switch (version)
+				{
+				case 0:
+					const_cast<c_model_animation_graph*>(object->graph)->node_matrices_from_orientations(object_node_matrices, object->orientations, &object->root_matrix);
+					break;
+				case 1:
+					animation_node_matrices_compose_scalar(object->hierarchy, object_node_matrices, object->orientations, &object->root_matrix);
+					break;
+				case 2:
+					animation_node_matrices_compose_batched(object->hierarchy, object_node_matrices, object->orientations, &object->root_matrix);
+					break;
+				}
+			}
+		}
+		cycles[version] = stop_watch->stop();
+	}
+
+	globals->enabled = enabled;
+
+	result->original_milliseconds = 1000.0f * c_stop_watch::cycles_to_seconds(cycles[0]) / result->iteration_count;
+	result->scalar_milliseconds = 1000.0f * c_stop_watch::cycles_to_seconds(cycles[1]) / result->iteration_count;
+	result->batched_milliseconds = 1000.0f * c_stop_watch::cycles_to_seconds(cycles[2]) / result->iteration_count;
+
+	for (int32 object_index = 0; object_index < k_animation_node_matrices_benchmark_objects; object_index++)
+	{
+		int32 first_matrix = object_index * k_maximum_animation_node_hierarchy_nodes;
+		int32 float_count = objects[object_index].hierarchy->node_count * k_animation_node_matrix_floats;
+
+		const real32* original = (const real32*)&node_matrices[0][first_matrix];
+		const real32* scalar = (const real32*)&node_matrices[1][first_matrix];
+		const real32* batched = (const real32*)&node_matrices[2][first_matrix];
+		if (csmemcmp(scalar, batched, float_count * sizeof(real32)) != 0)
+		{
+			for (int32 float_index = 0; float_index < float_count; float_index++)
+			{
+				result->batched_scalar_mismatches += csmemcmp(&scalar[float_index], &batched[float_index], sizeof(real32)) != 0;
+			}
+		}
+
+		if (csmemcmp(original, batched, float_count * sizeof(real32)) != 0)
+		{
+			for (int32 float_index = 0; float_index < float_count; float_index++)
+			{
+				result->batched_original_mismatches += csmemcmp(&original[float_index], &batched[float_index], sizeof(real32)) != 0;
+				result->maximum_original_error = MAX(result->maximum_original_error, fabsf(batched[float_index] - original[float_index]));
+			}
+		}
+	}
+
+	for (int32 version = 0; version < NUMBEROF(node_matrices); version++)
+	{
+		system_free(node_matrices[version]);
+	}
+
+	return true;
+}
+
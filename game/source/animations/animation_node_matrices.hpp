@@ -0,0 +1,97 @@
+#pragma once
+
+#include "cseries/cseries.hpp"
+#include "multithreading/synchronized_value.hpp"
+
+// the skeleton of a graph flattened breadth first, the nodes of a depth level only read the matrices of the level
+// above them, so a level is composed four nodes at a time, each batch gathers its parents and orientations into one
+// register per matrix component, runs the same operations in the same order as the scalar version and scatters the
+// results back to the node matrices in graph order, which is the layout everything reading node matrices expects
+
+// a graph is composed by the original executable and compared against it until that many poses in a row came out
+// bit for bit the same, once batched every so often a composition still goes through the original to be compared,
+// the first pose that differs sends the graph back to the original for good, batching is off until it is turned on
+
+enum
+{
+	k_maximum_animation_node_hierarchy_nodes = 256,
+	k_maximum_animation_node_hierarchies = 128,
+	k_animation_node_matrices_benchmark_objects = 64,
+
+	k_animation_node_hierarchy_verification_poses = 64,
+	k_animation_node_hierarchy_sample_interval = 128,
+};
+
+enum e_animation_node_hierarchy_state
+{
+	_animation_node_hierarchy_empty = 0,
+	_animation_node_hierarchy_building,
+	_animation_node_hierarchy_unverified,
+	_animation_node_hierarchy_verified,
+	_animation_node_hierarchy_mismatched,
+
+	k_animation_node_hierarchy_state_count
+};
+
+class c_model_animation_graph;
+struct s_animation_node_hierarchy
+{
+	c_interlocked_long state;
+	const c_model_animation_graph* graph;
+
+	// poses the batched version matched while unverified, and compositions since it was verified
+	c_interlocked_long matched_poses;
+	c_interlocked_long batched_compositions;
+
+	int32 node_count;
+	int32 level_count;
+
+	// the breadth first positions each level starts at, `level_count + 1` of them
+	int16 level_first_position[k_maximum_animation_node_hierarchy_nodes + 1];
+
+	// by breadth first position, the node there and the node its parent is, `NONE` for roots
+	int16 node_indices[k_maximum_animation_node_hierarchy_nodes];
+	int16 parent_node_indices[k_maximum_animation_node_hierarchy_nodes];
+};
+
+struct s_animation_node_matrices_globals
+{
+	bool enabled;
+
+	s_animation_node_hierarchy hierarchies[k_maximum_animation_node_hierarchies];
+
+	c_interlocked_long batched_compositions;
+	c_interlocked_long original_compositions;
+	c_interlocked_long mismatched_graphs;
+	c_interlocked_long sampled_compositions;
+};
+
+struct s_animation_node_matrices_benchmark_result
+{
+	int32 object_count;
+	int32 node_count;
+	int32 iteration_count;
+	real32 original_milliseconds;
+	real32 scalar_milliseconds;
+	real32 batched_milliseconds;
+
+	// floats of the batched matrices that are not bit for bit the scalar and the original ones, and how far off the
+	// original ones are
+	int32 batched_scalar_mismatches;
+	int32 batched_original_mismatches;
+	real32 maximum_original_error;
+};
+
+struct real_matrix4x3;
+struct real_orientation;
+
+extern s_animation_node_matrices_globals g_animation_node_matrices_globals;
+
+extern void animation_node_matrices_dispose_from_old_map();
+extern s_animation_node_hierarchy* animation_node_hierarchy_get(const c_model_animation_graph* graph);
+extern bool animation_node_hierarchy_should_sample(s_animation_node_hierarchy* hierarchy);
+extern void animation_node_hierarchy_verify(s_animation_node_hierarchy* hierarchy, const real_matrix4x3* original_node_matrices, const real_orientation* orientations, const real_matrix4x3* root_matrix);
+extern void animation_node_matrices_compose_scalar(const s_animation_node_hierarchy* hierarchy, real_matrix4x3* node_matrices, const real_orientation* orientations, const real_matrix4x3* root_matrix);
+extern void animation_node_matrices_compose_batched(const s_animation_node_hierarchy* hierarchy, real_matrix4x3* node_matrices, const real_orientation* orientations, const real_matrix4x3* root_matrix);
+extern bool animation_node_matrices_benchmark(int32 iteration_count, s_animation_node_matrices_benchmark_result* result);
+
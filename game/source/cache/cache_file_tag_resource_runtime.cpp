@@ -1,11 +1,16 @@
 #include "cache/cache_file_tag_resource_runtime.hpp"
 
+#include "cache/cache_file_io_failure.hpp"
+#include "cache/cache_file_tag_resource_trace.hpp"
 #include "cache/cache_files.hpp"
 #include "cache/cache_files_windows.hpp"
+#include "cseries/cseries_events.hpp"
 #include "cseries/runtime_state.hpp"
+#include "game/game.hpp"
 #include "game/game_globals.hpp"
 #include "main/main_game.hpp"
 #include "memory/module.hpp"
+#include "profiler/profiler_stopwatch.hpp"
 #include "scenario/scenario_zone_resources.hpp"
 
 #include <DDS.h>
@@ -15,6 +20,7 @@ REFERENCE_DECLARE_ARRAY(0x018EB7A8, const s_cache_file_tag_resource_vtable*, g_c
 
 REFERENCE_DECLARE(0x023916C0, c_cache_file_tag_resource_runtime_manager_allocation, g_resource_runtime_manager);
 
+HOOK_DECLARE_CLASS_MEMBER(0x0055FDC0, c_cache_file_tag_resource_runtime_manager, commit_zone_state);
 HOOK_DECLARE_CLASS_MEMBER(0x00561C00, c_cache_file_tag_resource_runtime_manager, initialize_files);
 HOOK_DECLARE(0x00563E10, tag_resource_get);
 HOOK_DECLARE(0x00563F80, tag_resources_lock_game);
@@ -25,6 +31,14 @@ HOOK_DECLARE(0x005640B0, tag_resources_unlock_game);
 
 c_static_sized_dynamic_array<const s_resource_file_header*, 1024> g_resource_file_headers;
 
+s_tag_resource_zone_switch_globals g_tag_resource_zone_switch_globals
+{
+	.staged_switching_enabled = false,
+	.staged_idle_count = k_tag_resource_zone_switch_default_staged_idle_count,
+	.switch_count = 0,
+	.staged_switch_index = NONE,
+};
+
 // DO NOT ENABLE
 //#define USE_SHARED_CACHE_FILES
 // $TODO `c_cache_file_tag_resource_runtime_manager::get_shared_file_block`
@@ -49,9 +63,45 @@ struct s_cache_file_resource_shared_file
 static_assert(sizeof(s_cache_file_resource_shared_file) == 0x108);
 #endif
 
-void c_cache_file_tag_resource_runtime_manager::commit_zone_state()
+void __thiscall c_cache_file_tag_resource_runtime_manager::commit_zone_state()
 {
-	INVOKE_CLASS_MEMBER(0x0055FDC0, c_cache_file_tag_resource_runtime_manager, commit_zone_state);
+	//INVOKE_CLASS_MEMBER(0x0055FDC0, c_cache_file_tag_resource_runtime_manager, commit_zone_state);
+
+	bool zone_state_changed = m_dirty_active_resource_mask || m_dirty_pending_resource_mask;
+
+	// the original replaces the resource masks, the switch is measured against what was resident before it
+	static c_static_flags<32767> previous_resources_mask;
+	if (zone_state_changed)
+	{
+		csmemcpy(&previous_resources_mask, &m_active_resources_mask, sizeof(previous_resources_mask));
+	}
+
+	HOOK_INVOKE_CLASS_MEMBER(, c_cache_file_tag_resource_runtime_manager, commit_zone_state);
+
+	if (!zone_state_changed)
+	{
+		return;
+	}
+
+	tag_resource_prefetch_zone_state_committed();
+
+	// the new pending set supersedes whatever a staged switch was still streaming
+	if (g_tag_resource_zone_switch_globals.staged_switch_index != NONE)
+	{
+		g_tag_resource_zone_switch_globals.history[g_tag_resource_zone_switch_globals.staged_switch_index].complete = true;
+		g_tag_resource_zone_switch_globals.staged_switch_index = NONE;
+	}
+
+	int32 history_index = g_tag_resource_zone_switch_globals.switch_count++ % k_tag_resource_zone_switch_history_count;
+	s_tag_resource_zone_switch& zone_switch = g_tag_resource_zone_switch_globals.history[history_index];
+	csmemset(&zone_switch, 0, sizeof(zone_switch));
+	zone_switch.zone_state = m_active_zone_state.zone_state;
+
+	c_static_flags<32767> delta_mask;
+	delta_mask.and_not_range(&m_pending_resources_mask, &previous_resources_mask, 32767);
+	zone_switch.resources_added = delta_mask.count_bits_set();
+	delta_mask.and_not_range(&previous_resources_mask, &m_pending_resources_mask, 32767);
+	zone_switch.resources_removed = delta_mask.count_bits_set();
 }
 
 void __thiscall c_cache_file_tag_resource_runtime_manager_allocation::construct()
@@ -104,20 +154,68 @@ void __cdecl cache_file_tag_resources_initialize_for_new_map(e_game_mode game_mo
 		&runtime_decompressor_registry);
 }
 
+s_tag_resource_zone_switch* tag_resources_zone_switch_get_latest()
+{
+	if (g_tag_resource_zone_switch_globals.switch_count <= 0)
+	{
+		return NULL;
+	}
+
+	int32 history_index = (g_tag_resource_zone_switch_globals.switch_count - 1) % k_tag_resource_zone_switch_history_count;
+	return &g_tag_resource_zone_switch_globals.history[history_index];
+}
+
 void __cdecl cache_file_tag_resources_load_pending_resources_blocking(c_io_result* io_result)
 {
 	//INVOKE(0x0055F760, cache_file_tag_resources_load_pending_resources_blocking, io_result);
 
+	tag_resources_zone_switch_finish_staged();
+
+	// a commit that didn't change the zone state isn't a switch, the time spent loading isn't charged to the last one
+	int32 switch_count = g_tag_resource_zone_switch_globals.switch_count;
 	g_resource_runtime_manager.get()->commit_zone_state();
+	s_tag_resource_zone_switch* zone_switch = g_tag_resource_zone_switch_globals.switch_count != switch_count ? tag_resources_zone_switch_get_latest() : NULL;
+
+	c_stop_watch stop_watch(true);
+	stop_watch.start();
+
+	// while a game is running only the required set has to be resident for the next tick,
+	// the rest of the pending set is streamed by `pump_io` and finished from the main loop
+	if (zone_switch && g_tag_resource_zone_switch_globals.staged_switching_enabled && game_in_progress())
+	{
+		g_resource_runtime_manager.get()->load_required_resources_blocking(io_result);
+		zone_switch->required_stall_cycles += stop_watch.stop();
+		zone_switch->staged = true;
+		g_tag_resource_zone_switch_globals.staged_switch_index = (g_tag_resource_zone_switch_globals.switch_count - 1) % k_tag_resource_zone_switch_history_count;
+		return;
+	}
+
 	g_resource_runtime_manager.get()->load_pending_resources_blocking(io_result);
+	if (zone_switch)
+	{
+		zone_switch->pending_stall_cycles += stop_watch.stop();
+		zone_switch->complete = true;
+	}
 }
 
 void __cdecl cache_file_tag_resources_load_required_resources_blocking(c_io_result* io_result)
 {
 	//INVOKE(0x0055F7C0, cache_file_tag_resources_load_pending_resources_blocking, io_result);
 
+	tag_resources_zone_switch_finish_staged();
+
+	int32 switch_count = g_tag_resource_zone_switch_globals.switch_count;
 	g_resource_runtime_manager.get()->commit_zone_state();
+	s_tag_resource_zone_switch* zone_switch = g_tag_resource_zone_switch_globals.switch_count != switch_count ? tag_resources_zone_switch_get_latest() : NULL;
+
+	c_stop_watch stop_watch(true);
+	stop_watch.start();
+
 	g_resource_runtime_manager.get()->load_required_resources_blocking(io_result);
+	if (zone_switch)
+	{
+		zone_switch->required_stall_cycles += stop_watch.stop();
+	}
 }
 
 //.text:0055F820 ; real32 __cdecl cache_file_tag_resources_map_prefetch_progress(int16, const char*)
@@ -135,6 +233,7 @@ void __cdecl cache_file_tag_resources_prepare_for_next_map()
 {
 	//INVOKE(0x0055F890, cache_file_tag_resources_prepare_for_next_map);
 
+	tag_resources_zone_switch_reset();
 	g_resource_runtime_manager.get()->prepare_for_next_map();
 }
 
@@ -256,6 +355,7 @@ void* __cdecl tag_resource_get(const s_tag_resource* resource)
 
 	ASSERT(resource);
 
+	tag_resource_trace_touch(resource->resource_handle);
 	return g_resource_runtime_manager.get()->get_cached_resource_data(resource->resource_handle);
 }
 
@@ -302,6 +402,9 @@ void __cdecl tag_resources_main_loop_idle()
 	//INVOKE(0x00563FF0, tag_resources_main_loop_idle);
 
 	g_resource_runtime_manager.get()->idle();
+	tag_resources_zone_switch_update();
+	tag_resource_trace_update();
+	tag_resource_prefetch_update();
 }
 
 void __cdecl tag_resources_prepare_for_new_map() // nullsub
@@ -473,3 +576,75 @@ void c_cache_file_tag_resource_runtime_manager::initialize_for_new_map(
 		runtime_decompressor_registry);
 }
 
+void tag_resources_zone_switch_finish_staged()
+{
+	if (g_tag_resource_zone_switch_globals.staged_switch_index == NONE)
+	{
+		return;
+	}
+
+	s_tag_resource_zone_switch& zone_switch = g_tag_resource_zone_switch_globals.history[g_tag_resource_zone_switch_globals.staged_switch_index];
+
+	// by now `pump_io` should have streamed most of the pending set in, this only waits on what's left
+	c_stop_watch stop_watch(true);
+	stop_watch.start();
+
+	c_simple_io_result io_result;
+	g_resource_runtime_manager.get()->load_pending_resources_blocking(&io_result);
+	zone_switch.pending_stall_cycles += stop_watch.stop();
+
+	if (!io_result.check_success())
+	{
+		event(_event_warning, "tags:resources: failed to finish loading the pending resources of zone switch %d, retrying",
+			g_tag_resource_zone_switch_globals.switch_count - 1);
+		return;
+	}
+
+	zone_switch.complete = true;
+	g_tag_resource_zone_switch_globals.staged_switch_index = NONE;
+}
+
+const s_tag_resource_zone_switch* tag_resources_zone_switch_get(int32 history_index)
+{
+	// 0 is the latest switch
+	if (!VALID_INDEX(history_index, MIN(g_tag_resource_zone_switch_globals.switch_count, k_tag_resource_zone_switch_history_count)))
+	{
+		return NULL;
+	}
+
+	int32 switch_index = g_tag_resource_zone_switch_globals.switch_count - 1 - history_index;
+	return &g_tag_resource_zone_switch_globals.history[switch_index % k_tag_resource_zone_switch_history_count];
+}
+
+// the runtime doesn't expose per resource residency, so progress is the share of the streaming window that has elapsed
+real32 tag_resources_zone_switch_progress()
+{
+	if (g_tag_resource_zone_switch_globals.staged_switch_index == NONE)
+	{
+		return 1.0f;
+	}
+
+	const s_tag_resource_zone_switch& zone_switch = g_tag_resource_zone_switch_globals.history[g_tag_resource_zone_switch_globals.staged_switch_index];
+	return MIN(1.0f, (real32)zone_switch.idle_count / MAX(1, g_tag_resource_zone_switch_globals.staged_idle_count));
+}
+
+void tag_resources_zone_switch_reset()
+{
+	g_tag_resource_zone_switch_globals.switch_count = 0;
+	g_tag_resource_zone_switch_globals.staged_switch_index = NONE;
+	csmemset(g_tag_resource_zone_switch_globals.history.begin(), 0, sizeof(g_tag_resource_zone_switch_globals.history));
+}
+
+void tag_resources_zone_switch_update()
+{
+	if (g_tag_resource_zone_switch_globals.staged_switch_index == NONE)
+	{
+		return;
+	}
+
+	s_tag_resource_zone_switch& zone_switch = g_tag_resource_zone_switch_globals.history[g_tag_resource_zone_switch_globals.staged_switch_index];
+	if (++zone_switch.idle_count >= g_tag_resource_zone_switch_globals.staged_idle_count || !game_in_progress())
+	{
+		tag_resources_zone_switch_finish_staged();
+	}
+}
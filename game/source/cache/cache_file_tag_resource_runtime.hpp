@@ -315,7 +315,7 @@ class c_cache_file_tag_resource_runtime_manager :
 	private c_cache_file_resource_stoler
 {
 public:
-	void commit_zone_state();
+	void __thiscall commit_zone_state();
 	void load_pending_resources_blocking(c_io_result* io_result);
 	void load_required_resources_blocking(c_io_result* io_result);
 	void lock_for_game();
@@ -456,6 +456,47 @@ public:
 };
 extern c_cache_file_tag_resource_runtime_manager_allocation& g_resource_runtime_manager;
 
+enum
+{
+	k_tag_resource_zone_switch_history_count = 16,
+
+	// main loop idles a staged switch streams its pending resources for before it finishes them blocking
+	k_tag_resource_zone_switch_default_staged_idle_count = 30,
+};
+
+struct s_tag_resource_zone_switch
+{
+	s_scenario_zone_state zone_state;
+
+	// bits set in the committed pending resource mask but not in the active one before the commit, and the reverse
+	int32 resources_added;
+	int32 resources_removed;
+
+	// time the game thread spent blocked on the required set and on the pending set
+	int64 required_stall_cycles;
+	int64 pending_stall_cycles;
+
+	// a staged switch only blocks on the required set, the pending set is left to `pump_io` until it's finished
+	bool staged;
+	bool complete;
+	int32 idle_count;
+};
+
+struct s_tag_resource_zone_switch_globals
+{
+	bool staged_switching_enabled;
+	int32 staged_idle_count;
+
+	int32 switch_count;
+
+	// index into `history` of the staged switch whose pending set hasn't been finished yet, or `NONE`
+	int32 staged_switch_index;
+
+	c_static_array<s_tag_resource_zone_switch, k_tag_resource_zone_switch_history_count> history;
+};
+
+extern s_tag_resource_zone_switch_globals g_tag_resource_zone_switch_globals;
+
 class c_scenario_resource_registry;
 struct s_scenario_game_state;
 
@@ -485,6 +526,12 @@ extern void __cdecl tag_resources_pump_io();
 extern void __cdecl tag_resources_stagnate_deferred_resources();
 extern void __cdecl tag_resources_unlock_game(int32& lock);
 
+extern void tag_resources_zone_switch_finish_staged();
+extern const s_tag_resource_zone_switch* tag_resources_zone_switch_get(int32 history_index);
+extern real32 tag_resources_zone_switch_progress();
+extern void tag_resources_zone_switch_reset();
+extern void tag_resources_zone_switch_update();
+
 struct s_resource_file_header
 {
 	// tag info
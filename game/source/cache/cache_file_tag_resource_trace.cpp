@@ -0,0 +1,966 @@
+#include "cache/cache_file_tag_resource_trace.hpp"
+
+#include "cache/cache_file_tag_resource_runtime.hpp"
+#include "cseries/cseries_events.hpp"
+#include "game/game.hpp"
+#include "game/game_options.hpp"
+#include "game/game_time.hpp"
+#include "game/player_mapping.hpp"
+#include "memory/data.hpp"
+#include "objects/objects.hpp"
+#include "scenario/scenario.hpp"
+#include "tag_files/files.hpp"
+
+s_tag_resource_trace_globals g_tag_resource_trace_globals{};
+s_tag_resource_prefetch_globals g_tag_resource_prefetch_globals{};
+
+int32 tag_resource_trace_cluster_index_get(s_cluster_reference cluster_reference)
+{
+	if (!VALID_INDEX(cluster_reference.bsp_index, k_tag_resource_trace_structure_bsp_count))
+	{
+		return NONE;
+	}
+
+	return cluster_reference.bsp_index * k_tag_resource_trace_clusters_per_structure_bsp + cluster_reference.cluster_index;
+}
+
+s_cluster_reference tag_resource_trace_cluster_reference_get(int32 cluster_index)
+{
+	s_cluster_reference cluster_reference{};
+	cluster_reference.bsp_index = static_cast<int8>(cluster_index / k_tag_resource_trace_clusters_per_structure_bsp);
+	cluster_reference.cluster_index = static_cast<uns8>(cluster_index % k_tag_resource_trace_clusters_per_structure_bsp);
+	return cluster_reference;
+}
+
+bool tag_resource_trace_get_player_cluster(s_cluster_reference* cluster_reference)
+{
+	ASSERT(cluster_reference);
+
+	int32 user_index = player_mapping_first_active_output_user();
+	if (user_index == NONE)
+	{
+		return false;
+	}
+
+	int32 unit_index = player_mapping_get_unit_by_output_user(user_index);
+	if (unit_index == NONE)
+	{
+		return false;
+	}
+
+	const object_header_datum* object_header = object_header_get(unit_index);
+	if (!object_header)
+	{
+		return false;
+	}
+
+	*cluster_reference = object_header->cluster_reference;
+	return tag_resource_trace_cluster_index_get(*cluster_reference) != NONE;
+}
+
+s_tag_resource_trace_record* tag_resource_trace_new_record()
+{
+	int32 record_index = g_tag_resource_trace_globals.record_count.increment() - 1;
+	if (!VALID_INDEX(record_index, k_maximum_tag_resource_trace_records))
+	{
+		return NULL;
+	}
+
+	s_tag_resource_trace_record* record = &g_tag_resource_trace_globals.records[record_index];
+	csmemset(record, 0, sizeof(s_tag_resource_trace_record));
+	return record;
+}
+
+void tag_resource_trace_reset()
+{
+	g_tag_resource_trace_globals.scenario_index = global_scenario_index;
+	g_tag_resource_trace_globals.tick = NONE;
+	g_tag_resource_trace_globals.cluster_reference.bsp_index = NONE;
+	g_tag_resource_trace_globals.cluster_reference.cluster_index = 0;
+	g_tag_resource_trace_globals.record_count.set(0);
+	for (c_synchronized_long& touched_resources : g_tag_resource_trace_globals.touched_resources)
+	{
+		touched_resources.set(0);
+	}
+	g_tag_resource_trace_globals.scenario_path.clear();
+}
+
+void tag_resource_trace_start()
+{
+	if (!g_tag_resource_trace_globals.records)
+	{
+		g_tag_resource_trace_globals.records = static_cast<s_tag_resource_trace_record*>(system_malloc(k_maximum_tag_resource_trace_records * sizeof(s_tag_resource_trace_record)));
+		if (!g_tag_resource_trace_globals.records)
+		{
+			event(_event_warning, "tags:resources:trace: failed to allocate %d trace records",
+				k_maximum_tag_resource_trace_records);
+			return;
+		}
+	}
+
+	tag_resource_trace_reset();
+	g_tag_resource_trace_globals.recording = true;
+}
+
+bool tag_resource_trace_stop(const char* filename)
+{
+	ASSERT(filename);
+
+	g_tag_resource_trace_globals.recording = false;
+	if (!g_tag_resource_trace_globals.records)
+	{
+		return false;
+	}
+
+	int32 record_count = g_tag_resource_trace_globals.record_count.peek();
+	if (record_count > k_maximum_tag_resource_trace_records)
+	{
+		event(_event_warning, "tags:resources:trace: dropped %d records past the end of the trace",
+			record_count - k_maximum_tag_resource_trace_records);
+		record_count = k_maximum_tag_resource_trace_records;
+	}
+
+	s_tag_resource_trace_header header{};
+	header.signature = k_tag_resource_trace_signature;
+	header.version = k_tag_resource_trace_version;
+	header.record_count = record_count;
+	header.scenario_path = g_tag_resource_trace_globals.scenario_path;
+	for (int32 record_index = 0; record_index < record_count; record_index++)
+	{
+		if (g_tag_resource_trace_globals.records[record_index].resource_handle != NONE)
+		{
+			header.first_touch_count++;
+		}
+	}
+
+	s_file_reference file_reference{};
+	file_reference_create_from_path(&file_reference, filename, false);
+	uns32 error = 0;
+	if (!file_create(&file_reference) || !file_open(&file_reference, FLAG(_file_open_flag_desired_access_write), &error))
+	{
+		event(_event_warning, "tags:resources:trace: failed to create trace '%s' (error %d)",
+			filename,
+			error);
+		return false;
+	}
+
+	bool success = file_write(&file_reference, sizeof(header), &header)
+		&& file_write(&file_reference, record_count * sizeof(s_tag_resource_trace_record), g_tag_resource_trace_globals.records);
+	file_close(&file_reference);
+
+	if (!success)
+	{
+		event(_event_warning, "tags:resources:trace: failed to write trace '%s'",
+			filename);
+	}
+
+	return success;
+}
+
+// called from whichever thread asks for the resource, the first caller to set the resource's touched bit records it
+void tag_resource_trace_touch(int32 resource_handle)
+{
+	if (!g_tag_resource_trace_globals.recording || resource_handle == NONE || g_tag_resource_trace_globals.tick == NONE)
+	{
+		return;
+	}
+
+	int32 resource_index = DATUM_INDEX_TO_ABSOLUTE_INDEX(resource_handle);
+	if (!VALID_INDEX(resource_index, k_maximum_tag_resource_trace_resources))
+	{
+		return;
+	}
+
+	c_synchronized_long& touched_resources = g_tag_resource_trace_globals.touched_resources[resource_index / LONG_BITS];
+	int32 touched_flag = static_cast<int32>(FLAG(resource_index % LONG_BITS));
+	int32 touched_bits = 0;
+	do
+	{
+		touched_bits = touched_resources.peek();
+		if (TEST_MASK(touched_bits, touched_flag))
+		{
+			return;
+		}
+	} while (touched_resources.set_if_equal(touched_bits | touched_flag, touched_bits) != touched_bits);
+
+	s_tag_resource_trace_record* record = tag_resource_trace_new_record();
+	if (!record)
+	{
+		return;
+	}
+
+	record->resource_handle = resource_handle;
+	record->tick = g_tag_resource_trace_globals.tick;
+	record->cluster_reference = g_tag_resource_trace_globals.cluster_reference;
+	record->flags.set(_tag_resource_trace_record_resident_bit, g_resource_runtime_manager.get()->m_active_resources_mask.test(resource_index));
+}
+
+void tag_resource_trace_update()
+{
+	if (!g_tag_resource_trace_globals.recording)
+	{
+		return;
+	}
+
+	if (!game_in_progress())
+	{
+		g_tag_resource_trace_globals.tick = NONE;
+		return;
+	}
+
+	// a trace only ever covers one map
+	if (g_tag_resource_trace_globals.scenario_index != global_scenario_index)
+	{
+		if (g_tag_resource_trace_globals.record_count.peek() > 0)
+		{
+			event(_event_warning, "tags:resources:trace: the map changed, discarding %d records for '%s'",
+				g_tag_resource_trace_globals.record_count.peek(),
+				g_tag_resource_trace_globals.scenario_path.get_string());
+		}
+
+		tag_resource_trace_reset();
+	}
+
+	if (g_tag_resource_trace_globals.scenario_path.is_empty())
+	{
+		g_tag_resource_trace_globals.scenario_path.set(game_options_get()->scenario_path.get_string());
+	}
+
+	g_tag_resource_trace_globals.tick = game_time_get();
+
+	s_cluster_reference cluster_reference{};
+	if (!tag_resource_trace_get_player_cluster(&cluster_reference))
+	{
+		return;
+	}
+
+	if (cluster_reference.bsp_index == g_tag_resource_trace_globals.cluster_reference.bsp_index
+		&& cluster_reference.cluster_index == g_tag_resource_trace_globals.cluster_reference.cluster_index)
+	{
+		return;
+	}
+
+	g_tag_resource_trace_globals.cluster_reference = cluster_reference;
+
+	s_tag_resource_trace_record* record = tag_resource_trace_new_record();
+	if (!record)
+	{
+		return;
+	}
+
+	record->resource_handle = NONE;
+	record->tick = g_tag_resource_trace_globals.tick;
+	record->cluster_reference = cluster_reference;
+}
+
+bool tag_resource_trace_read(const char* filename, s_tag_resource_trace_header* header, s_tag_resource_trace_record* records)
+{
+	ASSERT(filename);
+	ASSERT(header);
+
+	s_file_reference file_reference{};
+	file_reference_create_from_path(&file_reference, filename, false);
+	uns32 error = 0;
+	if (!file_open(&file_reference, FLAG(_file_open_flag_desired_access_read), &error))
+	{
+		event(_event_warning, "tags:resources:trace: failed to open trace '%s' (error %d)",
+			filename,
+			error);
+		return false;
+	}
+
+	bool success = file_read_from_position(&file_reference, 0, sizeof(s_tag_resource_trace_header), false, header);
+	if (success && (header->signature != k_tag_resource_trace_signature
+		|| header->version != k_tag_resource_trace_version
+		|| !IN_RANGE_INCLUSIVE(header->record_count, 0, k_maximum_tag_resource_trace_records)))
+	{
+		event(_event_warning, "tags:resources:trace: '%s' is not a version %d trace",
+			filename,
+			k_tag_resource_trace_version);
+		success = false;
+	}
+
+	if (success && records)
+	{
+		success = file_read_from_position(&file_reference, sizeof(s_tag_resource_trace_header), header->record_count * sizeof(s_tag_resource_trace_record), false, records);
+	}
+
+	file_close(&file_reference);
+	return success;
+}
+
+int __cdecl tag_resource_prefetch_key_sort_proc(const void* a, const void* b)
+{
+	uns32 key_a = *static_cast<const uns32*>(a);
+	uns32 key_b = *static_cast<const uns32*>(b);
+
+	return key_a < key_b ? -1 : key_a > key_b ? 1 : 0;
+}
+
+int __cdecl tag_resource_prefetch_resource_entry_sort_proc(const void* a, const void* b)
+{
+	const s_tag_resource_prefetch_resource_entry* entry_a = static_cast<const s_tag_resource_prefetch_resource_entry*>(a);
+	const s_tag_resource_prefetch_resource_entry* entry_b = static_cast<const s_tag_resource_prefetch_resource_entry*>(b);
+
+	if (entry_a->trace_count != entry_b->trace_count)
+	{
+		return entry_b->trace_count - entry_a->trace_count;
+	}
+
+	return entry_a->resource_index - entry_b->resource_index;
+}
+
+int __cdecl tag_resource_prefetch_transition_sort_proc(const void* a, const void* b)
+{
+	const s_tag_resource_prefetch_transition* transition_a = static_cast<const s_tag_resource_prefetch_transition*>(a);
+	const s_tag_resource_prefetch_transition* transition_b = static_cast<const s_tag_resource_prefetch_transition*>(b);
+
+	if (transition_a->probability != transition_b->probability)
+	{
+		return transition_a->probability > transition_b->probability ? -1 : 1;
+	}
+
+	return transition_a->cluster_index - transition_b->cluster_index;
+}
+
+// keys are `(cluster_index << 16) | value`, sorted so every cluster's values are contiguous
+int32 tag_resource_prefetch_count_keys(uns32* keys, int32 key_count, uns32* unique_keys, int32* unique_key_counts)
+{
+	qsort(keys, key_count, sizeof(uns32), tag_resource_prefetch_key_sort_proc);
+
+	int32 unique_key_count = 0;
+	for (int32 key_index = 0; key_index < key_count; key_index++)
+	{
+		if (unique_key_count > 0 && unique_keys[unique_key_count - 1] == keys[key_index])
+		{
+			unique_key_counts[unique_key_count - 1]++;
+			continue;
+		}
+
+		unique_keys[unique_key_count] = keys[key_index];
+		unique_key_counts[unique_key_count] = 1;
+		unique_key_count++;
+	}
+
+	return unique_key_count;
+}
+
+bool tag_resource_prefetch_statistics_build(const char* statistics_filename, const char* const* trace_filenames, int32 trace_count)
+{
+	ASSERT(statistics_filename);
+	ASSERT(trace_filenames);
+
+	if (!IN_RANGE_INCLUSIVE(trace_count, 1, k_maximum_tag_resource_prefetch_traces))
+	{
+		event(_event_warning, "tags:resources:prefetch: can only build statistics from 1 to %d traces, not %d",
+			k_maximum_tag_resource_prefetch_traces,
+			trace_count);
+		return false;
+	}
+
+	int32 maximum_key_count = trace_count * k_maximum_tag_resource_trace_records;
+	s_tag_resource_trace_record* records = static_cast<s_tag_resource_trace_record*>(system_malloc(k_maximum_tag_resource_trace_records * sizeof(s_tag_resource_trace_record)));
+	uns32* resource_keys = static_cast<uns32*>(system_malloc(maximum_key_count * sizeof(uns32)));
+	uns32* transition_keys = static_cast<uns32*>(system_malloc(maximum_key_count * sizeof(uns32)));
+	uns32* unique_keys = static_cast<uns32*>(system_malloc(maximum_key_count * sizeof(uns32)));
+	int32* unique_key_counts = static_cast<int32*>(system_malloc(maximum_key_count * sizeof(int32)));
+	s_tag_resource_prefetch_cluster* clusters = static_cast<s_tag_resource_prefetch_cluster*>(system_malloc(k_tag_resource_trace_cluster_count * sizeof(s_tag_resource_prefetch_cluster)));
+	s_tag_resource_prefetch_resource_entry* resource_entries = static_cast<s_tag_resource_prefetch_resource_entry*>(system_malloc(maximum_key_count * sizeof(s_tag_resource_prefetch_resource_entry)));
+	s_tag_resource_prefetch_transition* transitions = static_cast<s_tag_resource_prefetch_transition*>(system_malloc(maximum_key_count * sizeof(s_tag_resource_prefetch_transition)));
+	int32* cluster_exit_counts = static_cast<int32*>(system_malloc(k_tag_resource_trace_cluster_count * sizeof(int32)));
+
+	bool success = records && resource_keys && transition_keys && unique_keys && unique_key_counts && clusters && resource_entries && transitions && cluster_exit_counts;
+	if (!success)
+	{
+		event(_event_warning, "tags:resources:prefetch: failed to allocate statistics for %d traces",
+			trace_count);
+	}
+
+	s_tag_resource_prefetch_statistics_header header{};
+	header.signature = k_tag_resource_prefetch_statistics_signature;
+	header.version = k_tag_resource_prefetch_statistics_version;
+	header.cluster_count = k_tag_resource_trace_cluster_count;
+
+	int32 resource_key_count = 0;
+	int32 transition_key_count = 0;
+	for (int32 trace_index = 0; success && trace_index < trace_count; trace_index++)
+	{
+		s_tag_resource_trace_header trace_header{};
+		if (!tag_resource_trace_read(trace_filenames[trace_index], &trace_header, records))
+		{
+			continue;
+		}
+
+		if (header.trace_count == 0)
+		{
+			header.scenario_path = trace_header.scenario_path;
+		}
+		else if (!header.scenario_path.is_equal(trace_header.scenario_path.get_string()))
+		{
+			event(_event_warning, "tags:resources:prefetch: skipping '%s', it was recorded on '%s' not '%s'",
+				trace_filenames[trace_index],
+				trace_header.scenario_path.get_string(),
+				header.scenario_path.get_string());
+			continue;
+		}
+		header.trace_count++;
+
+		int32 cluster_index = NONE;
+		for (int32 record_index = 0; record_index < trace_header.record_count; record_index++)
+		{
+			const s_tag_resource_trace_record* record = &records[record_index];
+			int32 record_cluster_index = tag_resource_trace_cluster_index_get(record->cluster_reference);
+
+			if (record->resource_handle == NONE)
+			{
+				if (cluster_index != NONE && record_cluster_index != NONE && record_cluster_index != cluster_index)
+				{
+					transition_keys[transition_key_count++] = (cluster_index << 16) | record_cluster_index;
+				}
+
+				cluster_index = record_cluster_index;
+				continue;
+			}
+
+			int32 resource_index = DATUM_INDEX_TO_ABSOLUTE_INDEX(record->resource_handle);
+			if (record_cluster_index != NONE && VALID_INDEX(resource_index, k_maximum_tag_resource_trace_resources))
+			{
+				resource_keys[resource_key_count++] = (record_cluster_index << 16) | resource_index;
+			}
+		}
+	}
+
+	if (success && header.trace_count == 0)
+	{
+		event(_event_warning, "tags:resources:prefetch: none of the %d traces could be used",
+			trace_count);
+		success = false;
+	}
+
+	if (success)
+	{
+		csmemset(clusters, 0, k_tag_resource_trace_cluster_count * sizeof(s_tag_resource_prefetch_cluster));
+		csmemset(cluster_exit_counts, 0, k_tag_resource_trace_cluster_count * sizeof(int32));
+
+		// a resource's first touch is only recorded once per trace, so the number of keys is the number of traces
+		int32 unique_key_count = tag_resource_prefetch_count_keys(resource_keys, resource_key_count, unique_keys, unique_key_counts);
+		for (int32 key_index = 0; key_index < unique_key_count; key_index++)
+		{
+			int32 cluster_index = unique_keys[key_index] >> 16;
+			s_tag_resource_prefetch_cluster* cluster = &clusters[cluster_index];
+			if (cluster->resource_entry_count == 0)
+			{
+				cluster->first_resource_entry_index = header.resource_entry_count;
+			}
+			cluster->resource_entry_count++;
+
+			s_tag_resource_prefetch_resource_entry* resource_entry = &resource_entries[header.resource_entry_count++];
+			resource_entry->resource_index = static_cast<int16>(unique_keys[key_index] & 0xFFFF);
+			resource_entry->trace_count = static_cast<int16>(unique_key_counts[key_index]);
+		}
+
+		unique_key_count = tag_resource_prefetch_count_keys(transition_keys, transition_key_count, unique_keys, unique_key_counts);
+		for (int32 key_index = 0; key_index < unique_key_count; key_index++)
+		{
+			cluster_exit_counts[unique_keys[key_index] >> 16] += unique_key_counts[key_index];
+		}
+
+		for (int32 key_index = 0; key_index < unique_key_count; key_index++)
+		{
+			int32 cluster_index = unique_keys[key_index] >> 16;
+			s_tag_resource_prefetch_cluster* cluster = &clusters[cluster_index];
+			if (cluster->transition_count == 0)
+			{
+				cluster->first_transition_index = header.transition_count;
+			}
+			cluster->transition_count++;
+
+			s_tag_resource_prefetch_transition* transition = &transitions[header.transition_count++];
+			transition->cluster_index = static_cast<int16>(unique_keys[key_index] & 0xFFFF);
+			transition->pad = 0;
+			transition->probability = static_cast<real32>(unique_key_counts[key_index]) / cluster_exit_counts[cluster_index];
+		}
+
+		for (int32 cluster_index = 0; cluster_index < k_tag_resource_trace_cluster_count; cluster_index++)
+		{
+			s_tag_resource_prefetch_cluster* cluster = &clusters[cluster_index];
+			qsort(&resource_entries[cluster->first_resource_entry_index], cluster->resource_entry_count, sizeof(s_tag_resource_prefetch_resource_entry), tag_resource_prefetch_resource_entry_sort_proc);
+			qsort(&transitions[cluster->first_transition_index], cluster->transition_count, sizeof(s_tag_resource_prefetch_transition), tag_resource_prefetch_transition_sort_proc);
+		}
+
+		s_file_reference file_reference{};
+		file_reference_create_from_path(&file_reference, statistics_filename, false);
+		uns32 error = 0;
+		if (!file_create(&file_reference) || !file_open(&file_reference, FLAG(_file_open_flag_desired_access_write), &error))
+		{
+			event(_event_warning, "tags:resources:prefetch: failed to create statistics '%s' (error %d)",
+				statistics_filename,
+				error);
+			success = false;
+		}
+		else
+		{
+			success = file_write(&file_reference, sizeof(header), &header)
+				&& file_write(&file_reference, header.cluster_count * sizeof(s_tag_resource_prefetch_cluster), clusters)
+				&& file_write(&file_reference, header.resource_entry_count * sizeof(s_tag_resource_prefetch_resource_entry), resource_entries)
+				&& file_write(&file_reference, header.transition_count * sizeof(s_tag_resource_prefetch_transition), transitions);
+			file_close(&file_reference);
+
+			if (!success)
+			{
+				event(_event_warning, "tags:resources:prefetch: failed to write statistics '%s'",
+					statistics_filename);
+			}
+		}
+	}
+
+	if (cluster_exit_counts)
+	{
+		system_free(cluster_exit_counts);
+	}
+
+	if (transitions)
+	{
+		system_free(transitions);
+	}
+
+	if (resource_entries)
+	{
+		system_free(resource_entries);
+	}
+
+	if (clusters)
+	{
+		system_free(clusters);
+	}
+
+	if (unique_key_counts)
+	{
+		system_free(unique_key_counts);
+	}
+
+	if (unique_keys)
+	{
+		system_free(unique_keys);
+	}
+
+	if (transition_keys)
+	{
+		system_free(transition_keys);
+	}
+
+	if (resource_keys)
+	{
+		system_free(resource_keys);
+	}
+
+	if (records)
+	{
+		system_free(records);
+	}
+
+	return success;
+}
+
+bool tag_resource_prefetch_statistics_load(const char* filename, s_tag_resource_prefetch_statistics* statistics)
+{
+	ASSERT(filename);
+	ASSERT(statistics);
+
+	csmemset(statistics, 0, sizeof(s_tag_resource_prefetch_statistics));
+
+	s_file_reference file_reference{};
+	file_reference_create_from_path(&file_reference, filename, false);
+	uns32 error = 0;
+	if (!file_open(&file_reference, FLAG(_file_open_flag_desired_access_read), &error))
+	{
+		event(_event_warning, "tags:resources:prefetch: failed to open statistics '%s' (error %d)",
+			filename,
+			error);
+		return false;
+	}
+
+	s_tag_resource_prefetch_statistics_header* header = &statistics->header;
+	bool success = file_read(&file_reference, sizeof(s_tag_resource_prefetch_statistics_header), false, header);
+	if (success && (header->signature != k_tag_resource_prefetch_statistics_signature
+		|| header->version != k_tag_resource_prefetch_statistics_version
+		|| header->cluster_count != k_tag_resource_trace_cluster_count
+		|| header->resource_entry_count < 0
+		|| header->transition_count < 0))
+	{
+		event(_event_warning, "tags:resources:prefetch: '%s' is not a version %d statistics file",
+			filename,
+			k_tag_resource_prefetch_statistics_version);
+		success = false;
+	}
+
+	if (success)
+	{
+		statistics->clusters = static_cast<s_tag_resource_prefetch_cluster*>(system_malloc(header->cluster_count * sizeof(s_tag_resource_prefetch_cluster)));
+		statistics->resource_entries = static_cast<s_tag_resource_prefetch_resource_entry*>(system_malloc(MAX(1, header->resource_entry_count) * sizeof(s_tag_resource_prefetch_resource_entry)));
+		statistics->transitions = static_cast<s_tag_resource_prefetch_transition*>(system_malloc(MAX(1, header->transition_count) * sizeof(s_tag_resource_prefetch_transition)));
+
+		success = statistics->clusters && statistics->resource_entries && statistics->transitions
+			&& file_read(&file_reference, header->cluster_count * sizeof(s_tag_resource_prefetch_cluster), false, statistics->clusters)
+			&& file_read(&file_reference, header->resource_entry_count * sizeof(s_tag_resource_prefetch_resource_entry), false, statistics->resource_entries)
+			&& file_read(&file_reference, header->transition_count * sizeof(s_tag_resource_prefetch_transition), false, statistics->transitions);
+	}
+
+	file_close(&file_reference);
+
+	// don't trust ranges that point outside of the file
+	for (int32 cluster_index = 0; success && cluster_index < header->cluster_count; cluster_index++)
+	{
+		const s_tag_resource_prefetch_cluster* cluster = &statistics->clusters[cluster_index];
+		success = cluster->resource_entry_count >= 0 && cluster->transition_count >= 0
+			&& IN_RANGE_INCLUSIVE(cluster->first_resource_entry_index, 0, header->resource_entry_count - cluster->resource_entry_count)
+			&& IN_RANGE_INCLUSIVE(cluster->first_transition_index, 0, header->transition_count - cluster->transition_count);
+	}
+
+	if (!success)
+	{
+		event(_event_warning, "tags:resources:prefetch: failed to read statistics '%s'",
+			filename);
+		tag_resource_prefetch_statistics_dispose(statistics);
+	}
+
+	return success;
+}
+
+void tag_resource_prefetch_statistics_dispose(s_tag_resource_prefetch_statistics* statistics)
+{
+	ASSERT(statistics);
+
+	if (statistics->transitions)
+	{
+		system_free(statistics->transitions);
+	}
+
+	if (statistics->resource_entries)
+	{
+		system_free(statistics->resource_entries);
+	}
+
+	if (statistics->clusters)
+	{
+		system_free(statistics->clusters);
+	}
+
+	csmemset(statistics, 0, sizeof(s_tag_resource_prefetch_statistics));
+}
+
+void tag_resource_prefetch_predictor_initialize(s_tag_resource_prefetch_predictor* predictor, const s_tag_resource_prefetch_statistics* statistics)
+{
+	ASSERT(predictor);
+	ASSERT(statistics);
+
+	predictor->statistics = statistics;
+	predictor->cluster_index = NONE;
+	predictor->minimum_transition_probability = 0.2f;
+	csmemset(predictor->predicted_ticks, 0xFF, sizeof(predictor->predicted_ticks));
+}
+
+int32 tag_resource_prefetch_predict_cluster(s_tag_resource_prefetch_predictor* predictor, int32 cluster_index, int32 tick)
+{
+	const s_tag_resource_prefetch_statistics* statistics = predictor->statistics;
+	const s_tag_resource_prefetch_cluster* cluster = &statistics->clusters[cluster_index];
+
+	int32 predicted_count = 0;
+	for (int32 entry_index = 0; entry_index < cluster->resource_entry_count; entry_index++)
+	{
+		int32 resource_index = statistics->resource_entries[cluster->first_resource_entry_index + entry_index].resource_index;
+		if (VALID_INDEX(resource_index, k_maximum_tag_resource_trace_resources) && predictor->predicted_ticks[resource_index] == NONE)
+		{
+			predictor->predicted_ticks[resource_index] = tick;
+			predicted_count++;
+		}
+	}
+
+	return predicted_count;
+}
+
+// entering a cluster predicts everything first touched in it and in the clusters players are likely to go to next,
+// predictions are never withdrawn because the resources stay resident until the zone set changes anyway
+int32 tag_resource_prefetch_predictor_update(s_tag_resource_prefetch_predictor* predictor, s_cluster_reference cluster_reference, int32 tick)
+{
+	ASSERT(predictor);
+	ASSERT(predictor->statistics);
+
+	int32 cluster_index = tag_resource_trace_cluster_index_get(cluster_reference);
+	if (cluster_index == NONE || cluster_index == predictor->cluster_index)
+	{
+		return 0;
+	}
+
+	predictor->cluster_index = cluster_index;
+
+	int32 predicted_count = tag_resource_prefetch_predict_cluster(predictor, cluster_index, tick);
+
+	const s_tag_resource_prefetch_statistics* statistics = predictor->statistics;
+	const s_tag_resource_prefetch_cluster* cluster = &statistics->clusters[cluster_index];
+	for (int32 transition_index = 0; transition_index < cluster->transition_count; transition_index++)
+	{
+		const s_tag_resource_prefetch_transition* transition = &statistics->transitions[cluster->first_transition_index + transition_index];
+		if (transition->probability < predictor->minimum_transition_probability)
+		{
+			break;
+		}
+
+		if (VALID_INDEX(transition->cluster_index, k_tag_resource_trace_cluster_count))
+		{
+			predicted_count += tag_resource_prefetch_predict_cluster(predictor, transition->cluster_index, tick);
+		}
+	}
+
+	return predicted_count;
+}
+
+bool tag_resource_prefetch_predictor_should_prefetch(const s_tag_resource_prefetch_predictor* predictor, int32 resource_handle)
+{
+	ASSERT(predictor);
+
+	if (resource_handle == NONE)
+	{
+		return false;
+	}
+
+	int32 resource_index = DATUM_INDEX_TO_ABSOLUTE_INDEX(resource_handle);
+	return VALID_INDEX(resource_index, k_maximum_tag_resource_trace_resources) && predictor->predicted_ticks[resource_index] != NONE;
+}
+
+bool tag_resource_prefetch_start(const char* statistics_filename)
+{
+	s_tag_resource_prefetch_globals* globals = &g_tag_resource_prefetch_globals;
+
+	tag_resource_prefetch_stop();
+
+	if (!globals->predictor)
+	{
+		globals->predictor = static_cast<s_tag_resource_prefetch_predictor*>(system_malloc(sizeof(s_tag_resource_prefetch_predictor)));
+		if (!globals->predictor)
+		{
+			event(_event_warning, "tags:resources:prefetch: failed to allocate the predictor");
+			return false;
+		}
+	}
+
+	if (!tag_resource_prefetch_statistics_load(statistics_filename, &globals->statistics))
+	{
+		return false;
+	}
+
+	tag_resource_prefetch_predictor_initialize(globals->predictor, &globals->statistics);
+	globals->scenario_index = NONE;
+	globals->missing_count = 0;
+	globals->resident_count = 0;
+	globals->later_active_count = 0;
+	globals->missing_resources.clear();
+	globals->enabled = true;
+	return true;
+}
+
+void tag_resource_prefetch_stop()
+{
+	s_tag_resource_prefetch_globals* globals = &g_tag_resource_prefetch_globals;
+
+	globals->enabled = false;
+	tag_resource_prefetch_statistics_dispose(&globals->statistics);
+
+	if (globals->predictor)
+	{
+		system_free(globals->predictor);
+		globals->predictor = NULL;
+	}
+}
+
+void tag_resource_prefetch_update()
+{
+	s_tag_resource_prefetch_globals* globals = &g_tag_resource_prefetch_globals;
+
+	if (!globals->enabled || !game_in_progress())
+	{
+		return;
+	}
+
+	// statistics only describe the map their traces were recorded on
+	if (globals->scenario_index != global_scenario_index)
+	{
+		if (!globals->statistics.header.scenario_path.is_equal(game_options_get()->scenario_path.get_string()))
+		{
+			event(_event_warning, "tags:resources:prefetch: the statistics are for '%s', stopping prefetching on '%s'",
+				globals->statistics.header.scenario_path.get_string(),
+				game_options_get()->scenario_path.get_string());
+			tag_resource_prefetch_stop();
+			return;
+		}
+
+		globals->scenario_index = global_scenario_index;
+		tag_resource_prefetch_predictor_initialize(globals->predictor, &globals->statistics);
+	}
+
+	s_cluster_reference cluster_reference{};
+	if (!tag_resource_trace_get_player_cluster(&cluster_reference))
+	{
+		return;
+	}
+
+	c_cache_file_tag_resource_runtime_manager* manager = g_resource_runtime_manager.get();
+
+	// the predictor only reports, writing the manager's pending mask would bypass its dirty tracking and zone set budget
+	int32 tick = game_time_get();
+	bool predicted = tag_resource_prefetch_predictor_update(globals->predictor, cluster_reference, tick) > 0;
+	if (!predicted && globals->missing_count == globals->later_active_count)
+	{
+		return;
+	}
+
+	for (int32 resource_index = 0; resource_index < k_maximum_tag_resource_trace_resources; resource_index++)
+	{
+		bool active = manager->m_active_resources_mask.test(resource_index);
+		if (globals->missing_resources.test(resource_index) && active)
+		{
+			globals->missing_resources.set(resource_index, false);
+			globals->later_active_count++;
+		}
+
+		if (!predicted || globals->predictor->predicted_ticks[resource_index] != tick)
+		{
+			continue;
+		}
+
+		if (active || manager->m_pending_resources_mask.test(resource_index))
+		{
+			globals->resident_count++;
+			continue;
+		}
+
+		if (!globals->missing_resources.test(resource_index))
+		{
+			globals->missing_resources.set(resource_index, true);
+			globals->missing_count++;
+		}
+	}
+}
+
+// committing a zone state rebuilds the pending set from the zone set, so the predictor starts over from the new one
+void tag_resource_prefetch_zone_state_committed()
+{
+	s_tag_resource_prefetch_globals* globals = &g_tag_resource_prefetch_globals;
+
+	if (!globals->enabled)
+	{
+		return;
+	}
+
+	tag_resource_prefetch_predictor_initialize(globals->predictor, &globals->statistics);
+}
+
+// plays a trace back against the predictor, the baseline is the static zone set prefetching the trace was recorded with,
+// replaying a trace that went into the statistics flatters the predictor so hold one back to get honest numbers
+bool tag_resource_prefetch_replay(const char* statistics_filename, const char* trace_filename, s_tag_resource_prefetch_replay_results* results)
+{
+	ASSERT(statistics_filename);
+	ASSERT(trace_filename);
+	ASSERT(results);
+
+	csmemset(results, 0, sizeof(s_tag_resource_prefetch_replay_results));
+
+	s_tag_resource_prefetch_statistics statistics{};
+	if (!tag_resource_prefetch_statistics_load(statistics_filename, &statistics))
+	{
+		return false;
+	}
+
+	s_tag_resource_trace_record* records = static_cast<s_tag_resource_trace_record*>(system_malloc(k_maximum_tag_resource_trace_records * sizeof(s_tag_resource_trace_record)));
+	s_tag_resource_prefetch_predictor* predictor = static_cast<s_tag_resource_prefetch_predictor*>(system_malloc(sizeof(s_tag_resource_prefetch_predictor)));
+	c_static_flags<k_maximum_tag_resource_trace_resources>* touched_resources = static_cast<c_static_flags<k_maximum_tag_resource_trace_resources>*>(system_malloc(sizeof(c_static_flags<k_maximum_tag_resource_trace_resources>)));
+
+	s_tag_resource_trace_header header{};
+	bool success = records && predictor && touched_resources && tag_resource_trace_read(trace_filename, &header, records);
+	if (success && !header.scenario_path.is_equal(statistics.header.scenario_path.get_string()))
+	{
+		event(_event_warning, "tags:resources:prefetch: '%s' was recorded on '%s' but the statistics are for '%s'",
+			trace_filename,
+			header.scenario_path.get_string(),
+			statistics.header.scenario_path.get_string());
+		success = false;
+	}
+
+	if (success)
+	{
+		tag_resource_prefetch_predictor_initialize(predictor, &statistics);
+		touched_resources->clear();
+
+		for (int32 record_index = 0; record_index < header.record_count; record_index++)
+		{
+			const s_tag_resource_trace_record* record = &records[record_index];
+			if (record->resource_handle == NONE)
+			{
+				tag_resource_prefetch_predictor_update(predictor, record->cluster_reference, record->tick);
+				results->cluster_change_count++;
+				continue;
+			}
+
+			int32 resource_index = DATUM_INDEX_TO_ABSOLUTE_INDEX(record->resource_handle);
+			if (!VALID_INDEX(resource_index, k_maximum_tag_resource_trace_resources))
+			{
+				continue;
+			}
+
+			results->first_touch_count++;
+			touched_resources->set(resource_index, true);
+
+			if (record->flags.test(_tag_resource_trace_record_resident_bit))
+			{
+				continue;
+			}
+
+			results->baseline_miss_count++;
+
+			int32 predicted_tick = predictor->predicted_ticks[resource_index];
+			if (predicted_tick == NONE)
+			{
+				results->predicted_miss_count++;
+			}
+			else if (record->tick - predicted_tick < k_tag_resource_prefetch_lead_ticks)
+			{
+				results->late_prefetch_count++;
+				results->predicted_miss_count++;
+			}
+		}
+
+		for (int32 resource_index = 0; resource_index < k_maximum_tag_resource_trace_resources; resource_index++)
+		{
+			if (predictor->predicted_ticks[resource_index] == NONE)
+			{
+				continue;
+			}
+
+			results->prefetch_count++;
+			if (!touched_resources->test(resource_index))
+			{
+				results->unused_prefetch_count++;
+			}
+		}
+	}
+
+	if (touched_resources)
+	{
+		system_free(touched_resources);
+	}
+
+	if (predictor)
+	{
+		system_free(predictor);
+	}
+
+	if (records)
+	{
+		system_free(records);
+	}
+
+	tag_resource_prefetch_statistics_dispose(&statistics);
+
+	return success;
+}
+
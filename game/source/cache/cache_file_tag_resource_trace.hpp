@@ -0,0 +1,190 @@
+#pragma once
+
+#include "cseries/cseries.hpp"
+#include "multithreading/synchronized_value.hpp"
+
+// first touch traces of tag resources recorded during play, built offline into per map statistics
+// of which resources get touched in which cluster and which clusters players move to next,
+// a predictor uses those to decide what to prefetch before it's demanded
+
+enum
+{
+	k_tag_resource_trace_signature = 'rtrc',
+	k_tag_resource_trace_version = 1,
+
+	k_tag_resource_prefetch_statistics_signature = 'rpst',
+	k_tag_resource_prefetch_statistics_version = 1,
+
+	// matches the runtime manager's resource masks
+	k_maximum_tag_resource_trace_resources = 32767,
+	k_maximum_tag_resource_trace_records = 65536,
+
+	k_tag_resource_trace_structure_bsp_count = 16,
+	k_tag_resource_trace_clusters_per_structure_bsp = 256,
+	k_tag_resource_trace_cluster_count = k_tag_resource_trace_structure_bsp_count * k_tag_resource_trace_clusters_per_structure_bsp,
+
+	// a prefetch has to be issued this many ticks ahead of the first touch to count as a hit
+	k_tag_resource_prefetch_lead_ticks = 30,
+
+	k_maximum_tag_resource_prefetch_traces = 32,
+};
+
+enum e_tag_resource_trace_record_flags
+{
+	// the resource was already in the active resource mask, so static zone set prefetching had it covered
+	_tag_resource_trace_record_resident_bit = 0,
+
+	k_tag_resource_trace_record_flags_count
+};
+
+struct s_tag_resource_trace_header
+{
+	tag signature;
+	int32 version;
+	int32 record_count;
+	int32 first_touch_count;
+	c_static_string<k_tag_long_string_length> scenario_path;
+};
+static_assert(sizeof(s_tag_resource_trace_header) == 0x110);
+
+// `resource_handle` is `NONE` when the record marks the traced player entering `cluster_reference`
+struct s_tag_resource_trace_record
+{
+	int32 resource_handle;
+	int32 tick;
+	s_cluster_reference cluster_reference;
+	c_flags<e_tag_resource_trace_record_flags, uns8, k_tag_resource_trace_record_flags_count> flags;
+	byte pad;
+};
+static_assert(sizeof(s_tag_resource_trace_record) == 0xC);
+
+struct s_tag_resource_trace_globals
+{
+	bool recording;
+	int32 scenario_index;
+
+	// latched by the main loop so first touches from other threads don't have to look them up
+	int32 tick;
+	s_cluster_reference cluster_reference;
+
+	c_synchronized_long record_count;
+	s_tag_resource_trace_record* records;
+	c_synchronized_long touched_resources[BIT_VECTOR_SIZE_IN_LONGS(k_maximum_tag_resource_trace_resources)];
+	c_static_string<k_tag_long_string_length> scenario_path;
+};
+
+struct s_tag_resource_prefetch_statistics_header
+{
+	tag signature;
+	int32 version;
+	int32 trace_count;
+	int32 cluster_count;
+	int32 resource_entry_count;
+	int32 transition_count;
+	c_static_string<k_tag_long_string_length> scenario_path;
+};
+static_assert(sizeof(s_tag_resource_prefetch_statistics_header) == 0x118);
+
+// the resources first touched while players were in a cluster and the clusters they went to next,
+// both ranges are sorted by how many traces they showed up in
+struct s_tag_resource_prefetch_cluster
+{
+	int32 first_resource_entry_index;
+	int32 resource_entry_count;
+	int32 first_transition_index;
+	int32 transition_count;
+};
+static_assert(sizeof(s_tag_resource_prefetch_cluster) == 0x10);
+
+struct s_tag_resource_prefetch_resource_entry
+{
+	int16 resource_index;
+	int16 trace_count;
+};
+static_assert(sizeof(s_tag_resource_prefetch_resource_entry) == 0x4);
+
+struct s_tag_resource_prefetch_transition
+{
+	int16 cluster_index;
+	int16 pad;
+	real32 probability;
+};
+static_assert(sizeof(s_tag_resource_prefetch_transition) == 0x8);
+
+struct s_tag_resource_prefetch_statistics
+{
+	s_tag_resource_prefetch_statistics_header header;
+	s_tag_resource_prefetch_cluster* clusters;
+	s_tag_resource_prefetch_resource_entry* resource_entries;
+	s_tag_resource_prefetch_transition* transitions;
+};
+
+struct s_tag_resource_prefetch_predictor
+{
+	const s_tag_resource_prefetch_statistics* statistics;
+	int32 cluster_index;
+	real32 minimum_transition_probability;
+
+	// `NONE` for resources that haven't been predicted
+	int32 predicted_ticks[k_maximum_tag_resource_trace_resources];
+};
+
+// while prefetching is running the predictor follows the player between clusters and reports what it would have asked for,
+// the runtime manager only builds its pending set from the zone state so nothing is requested on the predictor's behalf,
+// `tag_resource_prefetch_replay` is where its effect on misses is measured
+struct s_tag_resource_prefetch_globals
+{
+	bool enabled;
+	int32 scenario_index;
+
+	s_tag_resource_prefetch_statistics statistics;
+	s_tag_resource_prefetch_predictor* predictor;
+
+	// predicted resources that were neither active nor pending, and the ones that were already active or pending
+	int32 missing_count;
+	int32 resident_count;
+
+	// predicted missing resources the zone state later made active, those a request would have brought in early
+	int32 later_active_count;
+	c_static_flags<k_maximum_tag_resource_trace_resources> missing_resources;
+};
+
+struct s_tag_resource_prefetch_replay_results
+{
+	int32 first_touch_count;
+	int32 cluster_change_count;
+
+	// first touches of resources that weren't resident without and with the predictor
+	int32 baseline_miss_count;
+	int32 predicted_miss_count;
+
+	// predicted, but not far enough ahead of the first touch to hide the read
+	int32 late_prefetch_count;
+
+	int32 prefetch_count;
+	int32 unused_prefetch_count;
+};
+
+extern s_tag_resource_trace_globals g_tag_resource_trace_globals;
+extern s_tag_resource_prefetch_globals g_tag_resource_prefetch_globals;
+
+extern void tag_resource_trace_start();
+extern bool tag_resource_trace_stop(const char* filename);
+extern void tag_resource_trace_touch(int32 resource_handle);
+extern void tag_resource_trace_update();
+
+extern bool tag_resource_prefetch_statistics_build(const char* statistics_filename, const char* const* trace_filenames, int32 trace_count);
+extern bool tag_resource_prefetch_statistics_load(const char* filename, s_tag_resource_prefetch_statistics* statistics);
+extern void tag_resource_prefetch_statistics_dispose(s_tag_resource_prefetch_statistics* statistics);
+
+extern void tag_resource_prefetch_predictor_initialize(s_tag_resource_prefetch_predictor* predictor, const s_tag_resource_prefetch_statistics* statistics);
+extern int32 tag_resource_prefetch_predictor_update(s_tag_resource_prefetch_predictor* predictor, s_cluster_reference cluster_reference, int32 tick);
+extern bool tag_resource_prefetch_predictor_should_prefetch(const s_tag_resource_prefetch_predictor* predictor, int32 resource_handle);
+
+extern bool tag_resource_prefetch_start(const char* statistics_filename);
+extern void tag_resource_prefetch_stop();
+extern void tag_resource_prefetch_update();
+extern void tag_resource_prefetch_zone_state_committed();
+
+extern bool tag_resource_prefetch_replay(const char* statistics_filename, const char* trace_filename, s_tag_resource_prefetch_replay_results* results);
+
@@ -1,15 +1,33 @@
 #include "cache/optional_cache.hpp"
 
+#include "memory/allocation_audit.hpp"
+#include "memory/module.hpp"
+
+#include <intrin.h>
+
 REFERENCE_DECLARE(0x024464D0, s_optional_cache_globals, g_optional_cache_globals);
 
+HOOK_DECLARE(0x00603DF0, _optional_cache_free);
+HOOK_DECLARE(0x00603E30, _optional_cache_try_to_allocate);
+
 void __cdecl _optional_cache_free(e_optional_cache_user user, void* pointer)
 {
-	INVOKE(0x00603DF0, _optional_cache_free, user, pointer);
+	//INVOKE(0x00603DF0, _optional_cache_free, user, pointer);
+
+	c_allocation_audit_scope audit_scope(_allocation_audit_source_optional_cache, _allocation_audit_event_free, NULL, NULL, NONE, _ReturnAddress(), 0);
+
+	HOOK_INVOKE(, _optional_cache_free, user, pointer);
 }
 
 void* __cdecl _optional_cache_try_to_allocate(e_optional_cache_user user, e_optional_cache_user_priority priority, int32 size, c_optional_cache_user_callback* callback)
 {
-	return INVOKE(0x00603E30, _optional_cache_try_to_allocate, user, priority, size, callback);
+	//return INVOKE(0x00603E30, _optional_cache_try_to_allocate, user, priority, size, callback);
+
+	c_allocation_audit_scope audit_scope(_allocation_audit_source_optional_cache, _allocation_audit_event_allocate, NULL, NULL, NONE, _ReturnAddress(), size);
+
+	void* result = NULL;
+	HOOK_INVOKE(result =, _optional_cache_try_to_allocate, user, priority, size, callback);
+	return result;
 }
 
 //.text:00603E90 ; c_static_array<s_optional_cache_user,6>::get_count
@@ -2,15 +2,18 @@
 
 #include "config/version.hpp"
 #include "cseries/cseries_events.hpp"
+#include "cseries/cseries_windows_debug_pc.hpp"
 #include "multithreading/synchronization.hpp"
 #include "multithreading/threads.hpp"
 #include "networking/network_time.hpp"
 #include "profiler/profiler.hpp"
+#include "profiler/profiler_stopwatch.hpp"
 
 #include <stdlib.h>
 
 s_event_log_globals event_log_globals;
 s_event_log_cache g_event_log_cache;
+s_event_log_record_queue g_event_log_record_queue;
 
 c_file_output_buffer::c_file_output_buffer() :
 	m_file(NULL),
@@ -79,6 +82,179 @@ void c_file_output_buffer::write(int32 buffer_size, const void* buffer)
 	}
 }
 
+void event_log_record_queue_initialize()
+{
+	synchronized_list_initialize(&g_event_log_record_queue.free_list);
+	synchronized_list_initialize(&g_event_log_record_queue.pending_list);
+	g_event_log_record_queue.pending_count.set(0);
+	g_event_log_record_queue.submitted_count.set(0);
+	g_event_log_record_queue.written_count.set(0);
+	g_event_log_record_queue.overflow_count.set(0);
+	g_event_log_record_queue.reported_overflow_count = 0;
+	g_event_log_record_queue.writer_running.set(false);
+
+	for (int32 record_index = 0; record_index < k_maximum_event_log_records; record_index++)
+	{
+		s_event_log_record* record = &g_event_log_record_queue.records[record_index];
+		synchronized_list_entry_clear(&record->list_entry);
+		synchronized_list_push(&g_event_log_record_queue.free_list, &record->list_entry);
+	}
+
+	g_event_log_record_queue.writer_enabled = true;
+}
+
+bool event_log_record_queue_submit(const int32* event_log_indices, int32 event_log_count, const char* string)
+{
+	ASSERT(event_log_indices);
+	ASSERT(event_log_count > 0);
+	ASSERT(string);
+
+	s_event_log_record* record = (s_event_log_record*)synchronized_list_pop(&g_event_log_record_queue.free_list);
+	if (!record)
+	{
+		// the writer has fallen behind, the caller writes the record synchronously instead
+		g_event_log_record_queue.overflow_count.increment();
+		return false;
+	}
+
+	record->event_log_indices.clear();
+	for (int32 event_log_num = 0; event_log_num < event_log_count; event_log_num++)
+	{
+		int32 event_log_index = event_log_indices[event_log_num];
+		if (event_log_index != NONE)
+		{
+			record->event_log_indices.set(event_log_index, true);
+		}
+	}
+	csstrnzcpy(record->string, string, sizeof(record->string));
+	record->string_length = csstrnlen(record->string, sizeof(record->string));
+
+	synchronized_list_push(&g_event_log_record_queue.pending_list, &record->list_entry);
+	g_event_log_record_queue.submitted_count.increment();
+
+	// the first record after the writer drained the queue wakes it, so a quiet log is written promptly, and so does
+	// a backlog building up before the writer got to it
+	int32 pending_count = g_event_log_record_queue.pending_count.increment();
+	if (pending_count == 1 || pending_count == k_event_log_record_wake_threshold)
+	{
+		internal_event_set(k_event_cseries_event_log);
+	}
+
+	return true;
+}
+
+s_event_log_record* event_log_record_queue_take_pending()
+{
+	// the pending list is a lifo, reverse it so records are written in submission order
+	s_synchronized_list_entry* entry = synchronized_list_flush(&g_event_log_record_queue.pending_list);
+	s_synchronized_list_entry* ordered_entries = NULL;
+	int32 record_count = 0;
+	while (entry)
+	{
+		s_synchronized_list_entry* next_entry = synchronized_list_entry_next(entry);
+		entry->next = ordered_entries;
+		ordered_entries = entry;
+		entry = next_entry;
+		record_count++;
+	}
+
+	// the queue is idle again as soon as it is taken, the next record submitted signals the writer
+	g_event_log_record_queue.pending_count.add(-record_count);
+
+	return (s_event_log_record*)ordered_entries;
+}
+
+void event_log_record_queue_release(s_event_log_record* records)
+{
+	int32 record_count = 0;
+	for (s_synchronized_list_entry* entry = &records->list_entry; entry; record_count++)
+	{
+		s_synchronized_list_entry* next_entry = synchronized_list_entry_next(entry);
+		synchronized_list_entry_clear(entry);
+		synchronized_list_push(&g_event_log_record_queue.free_list, entry);
+		entry = next_entry;
+	}
+
+	g_event_log_record_queue.written_count.add(record_count);
+}
+
+bool event_log_record_queue_writer_active()
+{
+	// once an exception has been cached we write synchronously on the crashing thread,
+	// and nothing is queued unless the writer thread is actually there to drain it
+	return event_log_globals.initialized
+		&& g_event_log_record_queue.writer_enabled
+		&& g_event_log_record_queue.writer_running.peek()
+		&& !has_cached_exception();
+}
+
+void event_log_record_queue_set_writer_enabled(bool enabled)
+{
+	if (!enabled)
+	{
+		event_logs_flush();
+	}
+	g_event_log_record_queue.writer_enabled = enabled;
+}
+
+void event_logs_benchmark(int32 iterations, real32* out_calls_per_second_synchronous, real32* out_calls_per_second_writer, int32* out_overflow_count)
+{
+	ASSERT(iterations > 0);
+	ASSERT(out_calls_per_second_synchronous);
+	ASSERT(out_calls_per_second_writer);
+	ASSERT(out_overflow_count);
+
+	static int32 benchmark_event_log_index = NONE;
+	if (benchmark_event_log_index == NONE)
+	{
+		benchmark_event_log_index = event_log_new("event_logs_benchmark.txt", c_event_log_flags());
+	}
+
+	*out_calls_per_second_synchronous = 0.0f;
+	*out_calls_per_second_writer = 0.0f;
+	*out_overflow_count = 0;
+
+	if (benchmark_event_log_index == NONE)
+	{
+		return;
+	}
+
+	bool writer_enabled = g_event_log_record_queue.writer_enabled;
+	for (int32 pass_index = 0; pass_index < 2; pass_index++)
+	{
+		bool use_writer = pass_index != 0;
+		event_log_record_queue_set_writer_enabled(use_writer);
+
+		int32 overflow_count = g_event_log_record_queue.overflow_count.peek();
+
+		c_stop_watch stop_watch{};
+		stop_watch.reset();
+		stop_watch.stop();
+		stop_watch.start();
+		for (int32 iteration = 0; iteration < iterations; iteration++)
+		{
+			char string[256]{};
+			csnzprintf(string, sizeof(string), "event_logs_benchmark: %s call %d of %d\r\n", use_writer ? "writer" : "synchronous", iteration + 1, iterations);
+			write_to_event_log(&benchmark_event_log_index, 1, string);
+		}
+		real32 elapsed_seconds = c_stop_watch::cycles_to_seconds(stop_watch.stop());
+
+		real32 calls_per_second = elapsed_seconds > 0.0f ? iterations / elapsed_seconds : 0.0f;
+		if (use_writer)
+		{
+			*out_calls_per_second_writer = calls_per_second;
+			*out_overflow_count = g_event_log_record_queue.overflow_count.peek() - overflow_count;
+		}
+		else
+		{
+			*out_calls_per_second_synchronous = calls_per_second;
+		}
+
+		event_logs_flush();
+	}
+	event_log_record_queue_set_writer_enabled(writer_enabled);
+}
+
 s_event_log* event_log_get(int32 event_log_index)
 {
 	ASSERT(event_log_index != NONE);
@@ -115,6 +291,7 @@ void event_logs_close()
 
 void event_logs_dispose()
 {
+	stop_thread(k_thread_event_logs);
 	flush_event_log_cache();
 	stop_thread(k_thread_network_block_detection);
 	event_log_globals.event_log_count = 0;
@@ -147,9 +324,19 @@ void event_logs_initialize()
 {
 	event_log_globals.cache_event_log_output = false;
 	g_event_log_cache.last_flush_time = system_milliseconds();
+	event_log_record_queue_initialize();
 	atexit(event_logs_dispose_atexit);
 	start_thread(k_thread_network_block_detection);
 	event_log_globals.initialized = true;
+
+	// the executable leaves the event log thread without a start routine, give it the writer
+	s_thread_definition* definition = &k_registered_thread_definitions[k_thread_event_logs];
+	if (!definition->start_routine)
+	{
+		definition->start_routine = event_logs_thread_function;
+		definition->user_parameter = NULL;
+	}
+	start_thread(k_thread_event_logs);
 }
 
 void event_logs_obtain_report_directory_lock()
@@ -240,6 +427,19 @@ bool event_logs_using_subfolder()
 	return event_log_globals.subfolder[0] != 0;
 }
 
+uns32 event_logs_thread_function(void* thread_parameter)
+{
+	g_event_log_record_queue.writer_running.set(true);
+	event_logs_work_function();
+	g_event_log_record_queue.writer_running.set(false);
+
+	// records submitted while the writer was shutting down
+	c_critical_section_scope section_scope(k_crit_section_event_logs);
+	flush_event_log_cache();
+
+	return 0;
+}
+
 void event_logs_work_function()
 {
 	suppress_file_errors(true);
@@ -248,7 +448,9 @@ void event_logs_work_function()
 		PROFILER(event_logs_work_function)
 		{
 			current_thread_update_test_functions();
-			if (internal_event_wait_timeout(k_event_cseries_event_log, 1000))
+			// records left pending when the wait times out are drained as well, a missed wakeup only delays them
+			if (internal_event_wait_timeout(k_event_cseries_event_log, 1000)
+				|| g_event_log_record_queue.pending_count.peek() > 0)
 			{
 				c_critical_section_scope section_scope(k_crit_section_event_logs);
 				flush_event_log_cache();
@@ -316,15 +518,27 @@ void flush_event_log_cache()
 		if (synchronization_objects_initialized())
 		{
 			internal_critical_section_enter(k_crit_section_event_logs);
+
+			// reset before draining, anything submitted from here on sets it again and is picked up by the next flush
+			internal_event_reset(k_event_cseries_event_log);
+		}
+
+		// records submitted to the writer are batched along with the cache
+		s_event_log_record* pending_records = event_log_record_queue_take_pending();
+
+		c_flags<int32, uns32, 32> pending_categories = g_event_log_cache.cached_categories;
+		for (s_event_log_record* record = pending_records; record; record = (s_event_log_record*)synchronized_list_entry_next(&record->list_entry))
+		{
+			pending_categories |= record->event_log_indices;
 		}
 
 		uns32 event_log_mask = 0;
 		for (int32 event_log_index = 0; event_log_index < event_log_globals.event_log_count; event_log_index++)
 		{
-			if (g_event_log_cache.cached_categories.test(event_log_index))
+			if (pending_categories.test(event_log_index))
 			{
 				s_event_log* event_log = event_log_get(event_log_index);
-				if (event_log->event_log_flags.test(_event_log_only_for_custom_subfolder) || event_logs_using_subfolder())
+				if (!event_log->event_log_flags.test(_event_log_only_for_custom_subfolder) || event_logs_using_subfolder())
 				{
 					event_log->output_buffer.initialize_from_reference(acquire_report_file_reference(event_log_index));
 					event_log_mask |= FLAG(event_log_index);
@@ -348,6 +562,34 @@ void flush_event_log_cache()
 			}
 		}
 
+		for (s_event_log_record* record = pending_records; record; record = (s_event_log_record*)synchronized_list_entry_next(&record->list_entry))
+		{
+			for (int32 event_log_index = 0; event_log_index < 32; event_log_index++)
+			{
+				if (record->event_log_indices.test(event_log_index))
+				{
+					write_event_log_cache_entry(true, event_log_index, record->string, false);
+				}
+			}
+		}
+
+		int32 overflow_count = g_event_log_record_queue.overflow_count.peek();
+		if (event_log_mask && overflow_count != g_event_log_record_queue.reported_overflow_count)
+		{
+			char overflow_string[128]{};
+			csnzprintf(overflow_string, sizeof(overflow_string), "events: %d event log records were written synchronously, the writer thread fell behind\r\n",
+				overflow_count - g_event_log_record_queue.reported_overflow_count);
+
+			for (int32 event_log_index = 0; event_log_index < event_log_globals.event_log_count; event_log_index++)
+			{
+				if (TEST_BIT(event_log_mask, event_log_index))
+				{
+					write_event_log_cache_entry(true, event_log_index, overflow_string, false);
+				}
+			}
+			g_event_log_record_queue.reported_overflow_count = overflow_count;
+		}
+
 		for (int32 event_log_index = 0; event_log_index < event_log_globals.event_log_count; event_log_index++)
 		{
 			if (TEST_BIT(event_log_mask, event_log_index))
@@ -363,9 +605,13 @@ void flush_event_log_cache()
 		g_event_log_cache.entry_string_cache_size = 0;
 		g_event_log_cache.cached_categories.clear();
 
+		if (pending_records)
+		{
+			event_log_record_queue_release(pending_records);
+		}
+
 		if (synchronization_objects_initialized())
 		{
-			internal_event_reset(k_event_cseries_event_log);
 			internal_critical_section_leave(k_crit_section_event_logs);
 		}
 
@@ -431,6 +677,20 @@ void write_to_event_log(const int32* event_log_indices, int32 event_log_count, c
 	{
 		ASSERT(event_log_indices);
 		ASSERT(event_log_count > 0);
+
+		// a full queue falls through to a synchronous write rather than losing the record
+		if (event_log_record_queue_writer_active()
+			&& event_log_record_queue_submit(event_log_indices, event_log_count, string))
+		{
+			return;
+		}
+
+		// anything still queued for the writer must land before this
+		if (g_event_log_record_queue.pending_count.peek() > 0)
+		{
+			flush_event_log_cache();
+		}
+
 		write_to_event_log_cache(event_log_indices, event_log_count, string);
 	}
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "multithreading/primitives/synchronized_list_windows.hpp"
+#include "multithreading/synchronized_value.hpp"
 #include "tag_files/files.hpp"
 
 class c_file_output_buffer
@@ -69,11 +71,52 @@ struct s_event_log_cache
 };
 static_assert(sizeof(s_event_log_cache) == 0xA010);
 
+enum
+{
+	k_event_log_record_string_size = 2048,
+	k_maximum_event_log_records = 256,
+
+	// the writer is woken by the first record submitted to an idle queue and
+	// again once this many records are waiting, it also drains on its timeout
+	k_event_log_record_wake_threshold = k_maximum_event_log_records / 4,
+};
+
+// records are handed from logging threads to the writer thread through
+// `s_event_log_record_queue`, `list_entry` must remain the first member
+struct __declspec(align(16)) s_event_log_record
+{
+	s_synchronized_list_entry list_entry;
+	c_flags<int32, uns32, 32> event_log_indices;
+	int32 string_length;
+	char string[k_event_log_record_string_size];
+};
+static_assert(sizeof(s_event_log_record) == 0x810);
+
+struct s_event_log_record_queue
+{
+	s_synchronized_list_header free_list;
+	s_synchronized_list_header pending_list;
+	c_synchronized_long pending_count;
+	c_synchronized_long submitted_count;
+	c_synchronized_long written_count;
+	c_synchronized_long overflow_count;
+	int32 reported_overflow_count;
+	bool writer_enabled;
+	c_synchronized_long writer_running;
+	s_event_log_record records[k_maximum_event_log_records];
+};
+
 extern s_event_log_globals event_log_globals;
 extern s_event_log_cache g_event_log_cache;
+extern s_event_log_record_queue g_event_log_record_queue;
 
 extern s_event_log* event_log_get(int32 event_log_index);
 extern int32 event_log_new(const char* event_log_name, c_event_log_flags event_log_flags);
+extern void event_log_record_queue_initialize();
+extern bool event_log_record_queue_submit(const int32* event_log_indices, int32 event_log_count, const char* string);
+extern bool event_log_record_queue_writer_active();
+extern void event_log_record_queue_set_writer_enabled(bool enabled);
+extern void event_logs_benchmark(int32 iterations, real32* out_calls_per_second_synchronous, real32* out_calls_per_second_writer, int32* out_overflow_count);
 extern void event_logs_close();
 extern void event_logs_dispose();
 extern void event_logs_dispose_atexit();
@@ -86,6 +129,7 @@ extern void event_logs_snapshot();
 extern void event_logs_specify_subfolder(const char* subfolder);
 extern bool event_logs_usable();
 extern bool event_logs_using_subfolder();
+extern uns32 event_logs_thread_function(void* thread_parameter);
 extern void event_logs_work_function();
 extern void flush_event_log_cache();
 extern void write_event_log_cache_entry(bool use_report_buffers, int32 event_log_index, const char* string, bool flush);
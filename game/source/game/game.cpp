@@ -1,6 +1,7 @@
 #include "game/game.hpp"
 
 #include "ai/ai.hpp"
+#include "animations/animation_node_matrices.hpp"
 #include "cache/cache_files_windows.hpp"
 #include "config/version.hpp"
 #include "cseries/async_xoverlapped.hpp"
@@ -36,8 +37,10 @@
 #include "main/levels.hpp"
 #include "main/main.hpp"
 #include "main/main_game.hpp"
+#include "main/main_headless.hpp"
 #include "main/main_render.hpp"
 #include "math/random_math.hpp"
+#include "memory/allocation_audit.hpp"
 #include "memory/module.hpp"
 #include "memory/thread_local.hpp"
 #include "networking/network_globals.hpp"
@@ -76,6 +79,7 @@
 #include "render_methods/render_method_submit.hpp"
 #include "saved_games/autosave_queue.hpp"
 #include "saved_games/determinism_debug_manager.hpp"
+#include "saved_games/game_state_telemetry.hpp"
 #include "saved_games/saved_film_manager.hpp"
 #include "saved_games/saved_game_files.hpp"
 #include "scenario/scenario.hpp"
@@ -87,6 +91,7 @@
 #include "screenshots/screenshots_uploader.hpp"
 #include "shell/shell.hpp"
 #include "simulation/simulation.hpp"
+#include "simulation/simulation_replay_benchmark.hpp"
 #include "sky_atm/atmosphere.hpp"
 #include "sound/game_sound.hpp"
 #include "sound/game_sound_deterministic.hpp"
@@ -441,6 +446,7 @@ void __cdecl game_dispose_from_old_map()
 	game_globals->game_in_progress = false;
 
 	fmod_dispose_from_old_map();
+	animation_node_matrices_dispose_from_old_map();
 
 	for (int32 system_index = g_game_system_count - 1; system_index >= 0; system_index--)
 	{
@@ -451,6 +457,7 @@ void __cdecl game_dispose_from_old_map()
 	}
 
 	random_seed_debug_log_end();
+	game_state_telemetry_match_end();
 	game_globals_dispose_from_old_map();
 	game_globals->map_active = false;
 }
@@ -528,6 +535,7 @@ void __cdecl game_finish()
 	{
 		game_globals->game_finished = true;
 		game_globals->game_finished_timer = game_seconds_to_ticks_round(game_is_campaign_or_survival() ? 1.0f : k_game_finished_time);
+		game_state_telemetry_match_end();
 	}
 }
 
@@ -799,6 +807,7 @@ void __cdecl game_initialize_for_new_map(const game_options* options)
 	game_globals->prepare_for_game_progression = false;
 
 	random_seed_disallow_use();
+	game_state_telemetry_match_begin();
 }
 
 void __cdecl game_initialize_for_new_non_bsp_zone_set(const s_game_non_bsp_zone_set* new_non_bsp_zone_set)
@@ -1768,6 +1777,9 @@ void __cdecl game_tick()
 
 	PROFILER(game_tick)
 	{
+		main_headless_game_tick_begin();
+		simulation_replay_game_tick_begin();
+
 		struct simulation_update update = { .flags = 0 };
 		s_simulation_update_metadata metadata = { .flags = 0 };
 
@@ -1784,23 +1796,44 @@ void __cdecl game_tick()
 			game_state_preserve();
 		}
 
-		render_debug_notify_game_tick_begin();
-		c_rasterizer::notify_game_tick_begin();
-		c_water_renderer::game_update();
+		HEADLESS_SERVER(false)
+		{
+			render_debug_notify_game_tick_begin();
+			c_rasterizer::notify_game_tick_begin();
+			c_water_renderer::game_update();
+		}
+
 		damage_acceleration_queue_begin();
 		simulation_apply_before_game(&update);
 		levels_update();
 
 		if (update.flags.test(_simulation_update_simulation_in_progress_bit))
 		{
-			chud_game_tick();
+			HEADLESS_SERVER(false)
+			{
+				chud_game_tick();
+			}
+
 			players_update_before_game(&update);
+
+			// a headless server keeps this, it updates the deterministic game sound state
 			sound_update();
+
 			game_tick_pulse_random_seed_deterministic(&update);
-			ai_update();
+
+			SIMULATION_REPLAY_PHASE(_simulation_replay_phase_ai)
+			{
+				ai_update();
+			}
+
 			recorded_animations_update();
 			game_sound_deterministic_update_timers();
-			game_engine_update();
+
+			SIMULATION_REPLAY_PHASE(_simulation_replay_phase_game_engine)
+			{
+				game_engine_update();
+			}
+
 			game_results_update();
 			editor_update();
 			cinematics_game_tick();
@@ -1810,7 +1843,10 @@ void __cdecl game_tick()
 				c_hue_saturation_control::copy_from_gamestate();
 			}
 
-			hs_update();
+			SIMULATION_REPLAY_PHASE(_simulation_replay_phase_hs)
+			{
+				hs_update();
+			}
 
 			RENDER_ENABLED(true)
 			{
@@ -1824,10 +1860,23 @@ void __cdecl game_tick()
 
 			object_scheduler_update();
 			object_activation_regions_update();
-			objects_update();
+			SIMULATION_REPLAY_PHASE(_simulation_replay_phase_objects)
+			{
+				allocation_audit_phase_begin(_allocation_audit_phase_objects_update);
+				objects_update();
+				allocation_audit_phase_end(_allocation_audit_phase_objects_update);
+			}
+
 			damage_acceleration_queue_end();
 			havok_proxies_update();
-			havok_update();
+
+			SIMULATION_REPLAY_PHASE(_simulation_replay_phase_havok)
+			{
+				allocation_audit_phase_begin(_allocation_audit_phase_havok_update);
+				havok_update();
+				allocation_audit_phase_end(_allocation_audit_phase_havok_update);
+			}
+
 			havok_proxies_move();
 			objects_move();
 			objects_post_update();
@@ -1864,9 +1913,16 @@ void __cdecl game_tick()
 
 			PROFILER(interface_system_update)
 			{
+				// a headless server keeps this too, nothing shows the simulation ignores the state it updates
 				first_person_weapons_update();
-				player_effect_update();
-				overhead_map_update();
+
+				HEADLESS_SERVER(false)
+				{
+					player_effect_update();
+					overhead_map_update();
+				}
+
+				// the observer and director also drive pvs and object activation, a headless server keeps them
 				observer_game_tick();
 				director_game_tick();
 			}
@@ -1884,7 +1940,17 @@ void __cdecl game_tick()
 
 		simulation_destroy_update(&update);
 		main_status(__FUNCTION__, NULL);
-		render_debug_notify_game_tick_end();
+
+		HEADLESS_SERVER(false)
+		{
+			render_debug_notify_game_tick_end();
+		}
+
+		main_headless_game_tick_end();
+		simulation_replay_game_tick_end();
+		determinism_debug_manager_game_tick_end();
+		game_state_telemetry_game_tick_end();
+		allocation_audit_game_tick_end();
 	}
 }
 
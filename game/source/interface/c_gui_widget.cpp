@@ -7,6 +7,7 @@
 #include "interface/c_gui_model_widget.hpp"
 #include "interface/c_gui_screen_widget.hpp"
 #include "interface/c_gui_text_widget.hpp"
+#include "interface/gui_widget_cache.hpp"
 #include "interface/interface_constants.hpp"
 #include "interface/user_interface_data.hpp"
 #include "interface/user_interface_memory.hpp"
@@ -23,6 +24,7 @@ HOOK_DECLARE_CLASS_MEMBER(0x00AB81A0, c_gui_widget, create_bitmap_widget_);
 //HOOK_DECLARE_CLASS_MEMBER(0x00AB8260, c_gui_widget, create_group_widget_);
 HOOK_DECLARE_CLASS_MEMBER(0x00AB82C0, c_gui_widget, create_list_item_widget_);
 HOOK_DECLARE_CLASS_MEMBER(0x00AB8320, c_gui_widget, create_list_widget_);
+HOOK_DECLARE_CLASS_MEMBER(0x00AB8620, c_gui_widget, dispose_);
 //HOOK_DECLARE_CLASS_MEMBER(0x00AB8380, c_gui_widget, create_model_widget_);
 //HOOK_DECLARE_CLASS_MEMBER(0x00AB83E0, c_gui_widget, create_text_widget_);
 HOOK_DECLARE_CLASS_MEMBER(0x00AB97C0, c_gui_widget, get_unprojected_bounds_);
@@ -30,6 +32,8 @@ HOOK_DECLARE_CLASS_MEMBER(0x00AB9980, c_gui_widget, handle_alt_stick_);
 HOOK_DECLARE_CLASS_MEMBER(0x00AB99E0, c_gui_widget, handle_alt_tab_);
 HOOK_DECLARE_CLASS_MEMBER(0x00AB9A40, c_gui_widget, handle_controller_input_message_);
 HOOK_DECLARE_CLASS_MEMBER(0x00AB9B40, c_gui_widget, handle_tab_);
+HOOK_DECLARE_CLASS_MEMBER(0x00ABB0E0, c_gui_widget, update_animation_);
+HOOK_DECLARE_CLASS_MEMBER(0x00ABB1A0, c_gui_widget, update_render_state_);
 
 bool gui_debug_text_bounds_global = false;
 bool gui_debug_bitmap_bounds_global = false;
@@ -74,6 +78,14 @@ c_gui_text_widget* __thiscall c_gui_widget::create_text_widget_(const s_runtime_
 	return c_gui_widget::create_text_widget(definition);
 }
 
+void __thiscall c_gui_widget::dispose_()
+{
+	// the widget cache must not match whatever is allocated here next against this widget
+	gui_widget_cache_widget_disposed(this);
+
+	HOOK_INVOKE_CLASS_MEMBER(, c_gui_widget, dispose_);
+}
+
 gui_real_rectangle2d* __thiscall c_gui_widget::get_unprojected_bounds_(gui_real_rectangle2d* unprojected_bounds, bool apply_translation, bool apply_scale, bool apply_rotation)
 {
 	return c_gui_widget::get_unprojected_bounds(unprojected_bounds, apply_translation, apply_scale, apply_rotation);
@@ -99,6 +111,16 @@ bool __thiscall c_gui_widget::handle_tab_(const c_controller_input_message* mess
 	return c_gui_widget::handle_tab(message);
 }
 
+void __thiscall c_gui_widget::update_animation_(uns32 current_milliseconds)
+{
+	c_gui_widget::update_animation(current_milliseconds);
+}
+
+void __thiscall c_gui_widget::update_render_state_(uns32 current_milliseconds)
+{
+	c_gui_widget::update_render_state(current_milliseconds);
+}
+
 template<>
 void ui_track_delete<c_gui_widget>(const c_gui_widget* object)
 {
@@ -920,6 +942,26 @@ gui_real_rectangle2d* c_gui_widget::get_unprojected_bounds(gui_real_rectangle2d*
 
 	real_rectangle2d authored_bounds{};
 	get_current_bounds(&authored_bounds);
+
+	rectangle2d render_window_bounds;
+	interface_get_current_display_settings(NULL, NULL, &render_window_bounds, NULL);
+
+	s_gui_widget_cache_bounds_key bounds_key{};
+	bounds_key.authored_bounds = authored_bounds;
+	bounds_key.local_scale_origin = m_animated_state.local_scale_origin;
+	bounds_key.scale = m_animated_state.scale;
+	bounds_key.local_rotation_origin = m_animated_state.local_rotation_origin;
+	bounds_key.sine_rotation_angle = m_animated_state.sine_rotation_angle;
+	bounds_key.cosine_rotation_angle = m_animated_state.cosine_rotation_angle;
+	bounds_key.position.x = m_animated_state.position.x;
+	bounds_key.position.y = m_animated_state.position.y;
+	bounds_key.render_window_bounds = render_window_bounds;
+	bounds_key.transform_flags = (apply_translation ? FLAG(0) : 0) | (apply_scale ? FLAG(1) : 0) | (apply_rotation ? FLAG(2) : 0);
+	if (gui_widget_cache_get_unprojected_bounds(this, &bounds_key, unprojected_bounds))
+	{
+		return unprojected_bounds;
+	}
+
 	unprojected_bounds->set(&authored_bounds);
 
 	if (apply_scale)
@@ -939,14 +981,13 @@ gui_real_rectangle2d* c_gui_widget::get_unprojected_bounds(gui_real_rectangle2d*
 
 	// this is more or less what Halo 3 MCC is doing
 
-	rectangle2d render_window_bounds;
-	interface_get_current_display_settings(NULL, NULL, &render_window_bounds, NULL);
-
 	real_vector2d scale{};
 	scale.i = rectangle2d_width(&render_window_bounds) / 1152.0f;
 	scale.j = rectangle2d_height(&render_window_bounds) / 640.0f;
 	unprojected_bounds->scale_direct(&scale);
 
+	gui_widget_cache_set_unprojected_bounds(this, &bounds_key, unprojected_bounds);
+
 	return unprojected_bounds;
 }
 
@@ -1643,6 +1684,19 @@ void c_gui_widget::update_animation(uns32 current_milliseconds)
 
 	c_gui_widget::animate(current_milliseconds);
 
+	if (g_gui_widget_cache_globals.enabled)
+	{
+		// the render state overrides of time driven widgets read the clock, they are never clean
+		if (gui_widget_cache_state_changed(this))
+		{
+			gui_widget_cache_mark_dirty(this, true);
+		}
+		else if (gui_widget_cache_widget_volatile(this) || gui_widget_cache_widget_time_driven(this))
+		{
+			gui_widget_cache_mark_dirty(this, false);
+		}
+	}
+
 	if (!c_gui_widget::can_be_disposed() || !c_gui_widget::can_all_children_be_disposed())
 	{
 		return;
@@ -1680,8 +1734,16 @@ void c_gui_widget::update_render_state(uns32 current_milliseconds)
 			continue;
 		}
 
+		// nothing in or below a clean widget changed since its render state was last updated
+		if (!gui_widget_cache_render_state_needed(child_widget))
+		{
+			continue;
+		}
+
 		child_widget->update_render_state(current_milliseconds);
 	}
+
+	gui_widget_cache_render_state_updated(this);
 }
 
 //.text:00ABB210 ; 
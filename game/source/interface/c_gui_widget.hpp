@@ -156,6 +156,7 @@ public:
 	c_gui_list_widget* __thiscall create_list_widget_(const s_list_widget_block* definition);
 	c_gui_model_widget* __thiscall create_model_widget_(const s_model_widget_block* definition);
 	c_gui_text_widget* __thiscall create_text_widget_(const s_runtime_text_widget_definition* definition);
+	void __thiscall dispose_();
 
 	gui_real_rectangle2d* __thiscall get_unprojected_bounds_(gui_real_rectangle2d* unprojected_bounds, bool apply_translation, bool apply_scale, bool apply_rotation);
 
@@ -163,6 +164,8 @@ public:
 	bool __thiscall handle_alt_tab_(const c_controller_input_message* message);
 	bool __thiscall handle_controller_input_message_(const c_controller_input_message* message);
 	bool __thiscall handle_tab_(const c_controller_input_message* message);
+	void __thiscall update_animation_(uns32 current_milliseconds);
+	void __thiscall update_render_state_(uns32 current_milliseconds);
 
 protected:
 	virtual e_animation_state get_ambient_state();
@@ -0,0 +1,371 @@
+#include "interface/gui_widget_cache.hpp"
+
+#include "interface/c_gui_bitmap_widget.hpp"
+#include "interface/c_gui_screen_widget.hpp"
+#include "interface/c_gui_widget.hpp"
+#include "memory/crc.hpp"
+#include "profiler/profiler_stopwatch.hpp"
+
+s_gui_widget_cache_globals g_gui_widget_cache_globals
+{
+	.enabled = false,
+};
+
+static c_stop_watch* gui_widget_cache_stop_watch()
+{
+	static c_stop_watch stop_watch(true);
+	return &stop_watch;
+}
+
+static int32 gui_widget_cache_home_index(const void* widget)
+{
+	// widgets are allocated on at least 16 byte boundaries, the low bits carry nothing
+	uns32 hash = uns32(uintptr_t(widget) >> 4) * 0x9E3779B1;
+	return int32(hash % k_maximum_gui_widget_cache_entries);
+}
+
+static bool gui_widget_cache_entry_matches(const s_gui_widget_cache_entry* entry, const c_gui_widget* widget)
+{
+	return entry->widget == widget
+		&& entry->widget_type == widget->m_type
+		&& entry->widget_name == widget->m_name;
+}
+
+// returns the entry of `widget`, or when `create` is set the slot it should take over
+static s_gui_widget_cache_entry* gui_widget_cache_entry_get(const c_gui_widget* widget, bool create)
+{
+	s_gui_widget_cache_globals* globals = &g_gui_widget_cache_globals;
+
+	int32 home_index = gui_widget_cache_home_index(widget);
+	s_gui_widget_cache_entry* free_entry = NULL;
+	for (int32 probe_index = 0; probe_index < k_gui_widget_cache_probe_count; probe_index++)
+	{
+		s_gui_widget_cache_entry* entry = &globals->entries[(home_index + probe_index) % k_maximum_gui_widget_cache_entries];
+		if (entry->widget == widget)
+		{
+			if (gui_widget_cache_entry_matches(entry, widget))
+			{
+				return entry;
+			}
+
+			// another widget lives where this one was, whatever the entry says is about a widget that's gone
+			csmemset(entry, 0, sizeof(s_gui_widget_cache_entry));
+		}
+
+		if (!free_entry && !entry->widget)
+		{
+			free_entry = entry;
+		}
+	}
+
+	if (!create)
+	{
+		return NULL;
+	}
+
+	// when every probe is taken the home entry is reused, the widget it held is treated as changed from then on
+	s_gui_widget_cache_entry* entry = free_entry ? free_entry : &globals->entries[home_index];
+	csmemset(entry, 0, sizeof(s_gui_widget_cache_entry));
+	entry->widget = widget;
+	entry->widget_type = widget->m_type;
+	entry->widget_name = widget->m_name;
+	return entry;
+}
+
+static uns32 gui_widget_cache_state_signature(c_gui_widget* widget)
+{
+	uns32 signature = crc_new();
+	signature = crc32(signature, (const byte*)&widget->m_animated_state, sizeof(widget->m_animated_state));
+
+	bool states[3]{ widget->m_visible, widget->m_enabled, widget->m_use_alternate_ambient_state };
+	signature = crc32(signature, (const byte*)states, sizeof(states));
+
+	if (widget->m_type == _gui_bitmap)
+	{
+		c_gui_bitmap_widget* bitmap_widget = (c_gui_bitmap_widget*)widget;
+		int32 sprite_overrides[3]
+		{
+			bitmap_widget->m_override_sprite_bitmap_index,
+			bitmap_widget->m_override_sprite_frame,
+			bitmap_widget->m_override_sprite_sequence
+		};
+		signature = crc32(signature, (const byte*)sprite_overrides, sizeof(sprite_overrides));
+	}
+
+	return signature;
+}
+
+void gui_widget_cache_set_enabled(bool enabled)
+{
+	s_gui_widget_cache_globals* globals = &g_gui_widget_cache_globals;
+
+	// whatever changed while the cache was off was never recorded, every widget starts over as changed
+	csmemset(globals->entries, 0, sizeof(globals->entries));
+	globals->enabled = enabled;
+}
+
+void gui_widget_cache_frame_begin()
+{
+	c_stop_watch* stop_watch = gui_widget_cache_stop_watch();
+	stop_watch->reset();
+	stop_watch->start();
+}
+
+void gui_widget_cache_frame_end()
+{
+	s_gui_widget_cache_globals* globals = &g_gui_widget_cache_globals;
+
+	globals->current.update_cycles = gui_widget_cache_stop_watch()->stop();
+	globals->last_frame = globals->current;
+
+	globals->frame_count++;
+	globals->totals.widgets_animated += globals->current.widgets_animated;
+	globals->totals.widgets_changed += globals->current.widgets_changed;
+	globals->totals.widgets_volatile += globals->current.widgets_volatile;
+	globals->totals.widgets_time_driven += globals->current.widgets_time_driven;
+	globals->totals.render_state_updates += globals->current.render_state_updates;
+	globals->totals.render_state_skips += globals->current.render_state_skips;
+	globals->totals.bounds_hits += globals->current.bounds_hits;
+	globals->totals.bounds_misses += globals->current.bounds_misses;
+	globals->totals.update_cycles += globals->current.update_cycles;
+
+	csmemset(&globals->current, 0, sizeof(globals->current));
+}
+
+bool gui_widget_cache_state_changed(c_gui_widget* widget)
+{
+	s_gui_widget_cache_globals* globals = &g_gui_widget_cache_globals;
+	ASSERT(widget != NULL);
+
+	globals->current.widgets_animated++;
+
+	uns32 signature = gui_widget_cache_state_signature(widget);
+	const void* focused_widget = NULL;
+	if (widget->m_type == _gui_screen)
+	{
+		focused_widget = ((c_gui_screen_widget*)widget)->get_focused_widget();
+	}
+
+	// a widget that was never seen before has nothing to compare against
+	s_gui_widget_cache_entry* entry = gui_widget_cache_entry_get(widget, true);
+	bool changed = !entry->state_valid
+		|| entry->state_signature != signature
+		|| entry->focused_widget != focused_widget;
+
+	if (changed)
+	{
+		entry->state_valid = true;
+		entry->state_signature = signature;
+		entry->focused_widget = focused_widget;
+		globals->current.widgets_changed++;
+	}
+
+	return changed;
+}
+
+// widgets showing text, models, lists or bound values pull their data while updating their render state,
+// nothing in their animated state tells when it changes
+bool gui_widget_cache_widget_volatile(const c_gui_widget* widget)
+{
+	s_gui_widget_cache_globals* globals = &g_gui_widget_cache_globals;
+	ASSERT(widget != NULL);
+
+	bool result = false;
+	switch (widget->m_type)
+	{
+	case _gui_text:
+	case _gui_model:
+	case _gui_list_item:
+	case _gui_slider:
+	case _gui_list:
+	{
+		result = true;
+	}
+	break;
+	case _gui_bitmap:
+	{
+		const c_gui_bitmap_widget* bitmap_widget = (const c_gui_bitmap_widget*)widget;
+		result = bitmap_widget->m_definition.value_identifier != _string_id_invalid
+			|| bitmap_widget->m_definition.value_override_list != _string_id_invalid
+			|| bitmap_widget->renders_as_player_emblem();
+	}
+	break;
+	}
+
+	if (result)
+	{
+		globals->current.widgets_volatile++;
+	}
+
+	return result;
+}
+
+// widgets whose render state moves with the clock, the render state overrides of their classes read the time
+// whether or not anything in their animated state changed
+static bool gui_widget_cache_time_driven(const c_gui_widget* widget)
+{
+	if (widget->m_animated_state.state_flags != 0)
+	{
+		return true;
+	}
+
+	if (widget->m_type == _gui_bitmap)
+	{
+		const c_gui_bitmap_widget* bitmap_widget = (const c_gui_bitmap_widget*)widget;
+		return bitmap_widget->m_override_sprite_sequence != NONE
+			|| widget->m_animated_state.bitmap_sprite_sequence != NONE;
+	}
+
+	return false;
+}
+
+bool gui_widget_cache_widget_time_driven(const c_gui_widget* widget)
+{
+	s_gui_widget_cache_globals* globals = &g_gui_widget_cache_globals;
+	ASSERT(widget != NULL);
+
+	bool result = gui_widget_cache_time_driven(widget);
+	if (result)
+	{
+		globals->current.widgets_time_driven++;
+	}
+
+	return result;
+}
+
+// a widget marked recursively takes everything below it along, its ancestors only learn they have something dirty below
+void gui_widget_cache_mark_dirty(c_gui_widget* widget, bool recursive)
+{
+	ASSERT(widget != NULL);
+
+	if (s_gui_widget_cache_entry* entry = gui_widget_cache_entry_get(widget, true))
+	{
+		entry->dirty = true;
+	}
+
+	if (recursive)
+	{
+		for (c_gui_widget* child_widget = widget->get_children(); child_widget; child_widget = child_widget->get_next())
+		{
+			if (child_widget->m_type == _gui_screen)
+			{
+				continue;
+			}
+
+			gui_widget_cache_mark_dirty(child_widget, true);
+		}
+	}
+
+	for (c_gui_widget* parent_widget = widget->get_parent(); parent_widget; parent_widget = parent_widget->get_parent())
+	{
+		s_gui_widget_cache_entry* parent_entry = gui_widget_cache_entry_get(parent_widget, true);
+		if (parent_entry->descendant_dirty)
+		{
+			break;
+		}
+		parent_entry->descendant_dirty = true;
+	}
+}
+
+bool gui_widget_cache_render_state_needed(const c_gui_widget* widget)
+{
+	s_gui_widget_cache_globals* globals = &g_gui_widget_cache_globals;
+	ASSERT(widget != NULL);
+
+	bool needed = true;
+	if (globals->enabled)
+	{
+		const s_gui_widget_cache_entry* entry = gui_widget_cache_entry_get(widget, false);
+		needed = !entry
+			|| !entry->state_valid
+			|| entry->dirty
+			|| entry->descendant_dirty
+			|| gui_widget_cache_time_driven(widget);
+	}
+
+	if (needed)
+	{
+		globals->current.render_state_updates++;
+	}
+	else
+	{
+		globals->current.render_state_skips++;
+	}
+
+	return needed;
+}
+
+void gui_widget_cache_render_state_updated(const c_gui_widget* widget)
+{
+	ASSERT(widget != NULL);
+
+	if (!g_gui_widget_cache_globals.enabled)
+	{
+		return;
+	}
+
+	if (s_gui_widget_cache_entry* entry = gui_widget_cache_entry_get(widget, false))
+	{
+		entry->dirty = false;
+		entry->descendant_dirty = false;
+	}
+}
+
+void gui_widget_cache_widget_disposed(const c_gui_widget* widget)
+{
+	ASSERT(widget != NULL);
+
+	if (s_gui_widget_cache_entry* entry = gui_widget_cache_entry_get(widget, false))
+	{
+		csmemset(entry, 0, sizeof(s_gui_widget_cache_entry));
+	}
+}
+
+bool gui_widget_cache_get_unprojected_bounds(const c_gui_widget* widget, const s_gui_widget_cache_bounds_key* key, gui_real_rectangle2d* unprojected_bounds)
+{
+	s_gui_widget_cache_globals* globals = &g_gui_widget_cache_globals;
+	ASSERT(widget != NULL);
+	ASSERT(key != NULL);
+	ASSERT(unprojected_bounds != NULL);
+
+	if (!globals->enabled)
+	{
+		return false;
+	}
+
+	const s_gui_widget_cache_entry* entry = gui_widget_cache_entry_get(widget, false);
+	if (!entry || !entry->bounds_valid || csmemcmp(&entry->bounds_key, key, sizeof(s_gui_widget_cache_bounds_key)) != 0)
+	{
+		globals->current.bounds_misses++;
+		return false;
+	}
+
+	globals->current.bounds_hits++;
+	*unprojected_bounds = entry->unprojected_bounds;
+	return true;
+}
+
+void gui_widget_cache_set_unprojected_bounds(const c_gui_widget* widget, const s_gui_widget_cache_bounds_key* key, const gui_real_rectangle2d* unprojected_bounds)
+{
+	s_gui_widget_cache_globals* globals = &g_gui_widget_cache_globals;
+	ASSERT(widget != NULL);
+	ASSERT(key != NULL);
+	ASSERT(unprojected_bounds != NULL);
+
+	if (!globals->enabled)
+	{
+		return;
+	}
+
+	// a widget that was never animated has no entry to hold its bounds yet
+	s_gui_widget_cache_entry* entry = gui_widget_cache_entry_get(widget, false);
+	if (!entry)
+	{
+		return;
+	}
+
+	entry->bounds_valid = true;
+	entry->bounds_key = *key;
+	entry->unprojected_bounds = *unprojected_bounds;
+}
+
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "cseries/cseries.hpp"
+#include "interface/gui_animation.hpp"
+
+// the animation pass marks a widget dirty when its animated state, visibility or focus changed since the last frame,
+// along with everything below it, and marks widgets showing data that can change behind their back or driven by the
+// clock, anything with an animation running or a sprite sequence, dirty every frame, everything above a dirty widget is
+// marked as having a dirty descendant, the render state pass then only walks down to dirty widgets and clears their
+// marks as it leaves them, a clean widget is skipped along with the render state overrides of its class
+
+// the state every widget was last seen in, its dirty marks and its last unprojected bounds are kept in a table keyed
+// by widget, nothing is stored in the widgets themselves, the table is only a cache, a widget missing from it is treated
+// as changed and has its render state updated, entries are dropped when their widget is disposed
+
+enum
+{
+	k_maximum_gui_widget_cache_entries = 2048,
+	k_gui_widget_cache_probe_count = 8,
+};
+
+// everything the unprojected bounds of a widget are computed from
+struct s_gui_widget_cache_bounds_key
+{
+	real_rectangle2d authored_bounds;
+	real_point2d local_scale_origin;
+	real_vector2d scale;
+	real_point2d local_rotation_origin;
+	real32 sine_rotation_angle;
+	real32 cosine_rotation_angle;
+	real_point2d position;
+	rectangle2d render_window_bounds;
+	uns32 transform_flags;
+};
+static_assert(sizeof(s_gui_widget_cache_bounds_key) == 0x44);
+
+struct s_gui_widget_cache_entry
+{
+	const void* widget;
+
+	// a widget allocated where a disposed one was without the disposal being seen still doesn't match its entry
+	int32 widget_type;
+	string_id widget_name;
+
+	bool state_valid;
+	uns32 state_signature;
+
+	// set by the animation pass, cleared once the render state of the widget was updated
+	bool dirty;
+	bool descendant_dirty;
+
+	// screens only, a focus change marks the whole screen dirty
+	const void* focused_widget;
+
+	bool bounds_valid;
+	s_gui_widget_cache_bounds_key bounds_key;
+	gui_real_rectangle2d unprojected_bounds;
+};
+
+struct s_gui_widget_cache_counters
+{
+	int32 widgets_animated;
+	int32 widgets_changed;
+	int32 widgets_volatile;
+	int32 widgets_time_driven;
+	int32 render_state_updates;
+	int32 render_state_skips;
+	int32 bounds_hits;
+	int32 bounds_misses;
+	int64 update_cycles;
+};
+
+struct s_gui_widget_cache_globals
+{
+	bool enabled;
+
+	s_gui_widget_cache_entry entries[k_maximum_gui_widget_cache_entries];
+
+	// the counters of the window manager update running and of the render since the last one
+	s_gui_widget_cache_counters current;
+	s_gui_widget_cache_counters last_frame;
+
+	int32 frame_count;
+	s_gui_widget_cache_counters totals;
+};
+
+class c_gui_widget;
+
+extern s_gui_widget_cache_globals g_gui_widget_cache_globals;
+
+extern void gui_widget_cache_set_enabled(bool enabled);
+extern void gui_widget_cache_frame_begin();
+extern void gui_widget_cache_frame_end();
+extern bool gui_widget_cache_state_changed(c_gui_widget* widget);
+extern bool gui_widget_cache_widget_volatile(const c_gui_widget* widget);
+extern bool gui_widget_cache_widget_time_driven(const c_gui_widget* widget);
+extern void gui_widget_cache_mark_dirty(c_gui_widget* widget, bool recursive);
+extern bool gui_widget_cache_render_state_needed(const c_gui_widget* widget);
+extern void gui_widget_cache_render_state_updated(const c_gui_widget* widget);
+extern void gui_widget_cache_widget_disposed(const c_gui_widget* widget);
+extern bool gui_widget_cache_get_unprojected_bounds(const c_gui_widget* widget, const s_gui_widget_cache_bounds_key* key, gui_real_rectangle2d* unprojected_bounds);
+extern void gui_widget_cache_set_unprojected_bounds(const c_gui_widget* widget, const s_gui_widget_cache_bounds_key* key, const gui_real_rectangle2d* unprojected_bounds);
+
@@ -11,6 +11,7 @@
 #include "interface/damaged_media.hpp"
 #include "interface/gui_pregame_setup_manager.hpp"
 #include "interface/gui_screens/scoreboard/gui_screen_scoreboard.hpp"
+#include "interface/gui_widget_cache.hpp"
 #include "interface/interface_constants.hpp"
 #include "interface/user_interface_memory.hpp"
 #include "interface/user_interface_mouse.hpp"
@@ -422,7 +423,9 @@ void __cdecl user_interface_update(real32 shell_seconds_elapsed)
 			user_interface_mouse_update();
 			user_interface_update_console_scoreboard();
 			user_interface_scoreboard_update();
+			gui_widget_cache_frame_begin();
 			window_manager_get()->update(current_ui_milliseconds);
+			gui_widget_cache_frame_end();
 			user_interface_error_manager_get()->update(current_ui_milliseconds);
 			c_gui_pregame_setup_manager::get()->update();
 			user_interface_networking_update();
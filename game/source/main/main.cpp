@@ -31,11 +31,14 @@
 #include "main/loading.hpp"
 #include "main/main_game.hpp"
 #include "main/main_game_launch.hpp"
+#include "main/main_headless.hpp"
 #include "main/main_predict.hpp"
 #include "main/main_render.hpp"
 #include "main/main_screenshot.hpp"
+#include "memory/allocation_audit.hpp"
 #include "memory/module.hpp"
 #include "memory/thread_local.hpp"
+#include "multithreading/job_system.hpp"
 #include "multithreading/synchronization.hpp"
 #include "networking/network_globals.hpp"
 #include "networking/online/online.hpp"
@@ -53,6 +56,7 @@
 #include "shell/shell.hpp"
 #include "shell/shell_windows.hpp"
 #include "simulation/simulation.hpp"
+#include "simulation/simulation_replay_benchmark.hpp"
 #include "sound/sound_manager.hpp"
 #include "spartan_program/spartan_program_handler.hpp"
 #include "tag_files/tag_files_sync.hpp"
@@ -852,7 +856,8 @@ void __cdecl main_loop()
 {
 	//INVOKE(0x005059E0, main_loop);
 
-	if (game_is_multithreaded())
+	// a headless server never enables the render thread and always runs the single threaded loop
+	if (game_is_multithreaded() && !main_headless_server())
 	{
 		g_render_thread_user_setting = true;
 		g_render_thread_enabled.set(_render_thread_mode_enabled);
@@ -871,13 +876,16 @@ void __cdecl main_loop()
 			continue;
 		}
 
+		// a headless server paces itself to game ticks in `main_headless_frame_end`
 		uns32 time_delta = system_milliseconds() - time;
-		if (!disable_main_loop_throttle && time_delta < 7)
+		if (!disable_main_loop_throttle && !main_headless_server() && time_delta < 7)
 		{
 			sleep(7 - time_delta);
 		}
 		time = system_milliseconds();
 
+		main_headless_frame_begin();
+
 		bool single_threaded = false;
 		main_globals.main_loop_pregame_last_time = system_milliseconds();
 
@@ -894,6 +902,8 @@ void __cdecl main_loop()
 			main_loop_body_single_threaded();
 		}
 
+		main_headless_frame_end();
+
 		g_single_thread_request_flags.set_bit(3, screenshot_globals.take_screenshot2 && screenshot_globals.take_screenshot);
 
 		if (game_is_multithreaded() && (g_single_thread_request_flags.peek() == _single_thread_for_user_request) != single_threaded)
@@ -1091,11 +1101,17 @@ void __cdecl main_loop_body()
 						PROFILER(update_ui) // main_loop, ui
 						{
 							user_interface_update(shell_seconds_elapsed);
-							closed_caption_update();
-							bink_playback_update();
-							screenshots_uploader_update();
+
+							HEADLESS_SERVER(false)
+							{
+								closed_caption_update();
+								bink_playback_update();
+								screenshots_uploader_update();
+							}
+
 							spartan_program_handler_update();
 							saved_film_manager_update();
+							simulation_replay_benchmark_update();
 						}
 
 						PROFILER(network_io) // main_loop, netio
@@ -1142,18 +1158,27 @@ void __cdecl main_loop_body()
 									director_update(world_seconds_elapsed);
 									observer_update(world_seconds_elapsed);
 									game_engine_interface_update(world_seconds_elapsed);
-									chud_update(world_seconds_elapsed);
-									rumble_update(world_seconds_elapsed);
-									achievements_update(world_seconds_elapsed);
-									first_person_weapons_update_camera_estimates();
 
-									if (main_time_halted())
+									HEADLESS_SERVER(false)
 									{
-										sound_idle();
+										chud_update(world_seconds_elapsed);
+										rumble_update(world_seconds_elapsed);
 									}
-									else
+
+									achievements_update(world_seconds_elapsed);
+
+									HEADLESS_SERVER(false)
 									{
-										sound_render();
+										first_person_weapons_update_camera_estimates();
+
+										if (main_time_halted())
+										{
+											sound_idle();
+										}
+										else
+										{
+											sound_render();
+										}
 									}
 								}
 
@@ -1170,13 +1195,16 @@ void __cdecl main_loop_body()
 
 								g_main_gamestate_timing_data->flags.set(_game_published_pregame, true);
 
-								if (main_time_halted())
+								HEADLESS_SERVER(false)
 								{
-									sound_idle();
-								}
-								else
-								{
-									sound_render();
+									if (main_time_halted())
+									{
+										sound_idle();
+									}
+									else
+									{
+										sound_render();
+									}
 								}
 
 								//static uns32 main_loop_network_time_since_abort = 0;
@@ -1259,14 +1287,18 @@ void __cdecl main_loop_body()
 				g_main_gamestate_timing_data->flags.set(_game_published_framerate_infinite, !main_time_is_throttled());
 			}
 
-			PROFILER(predict_tag_resources)
+			HEADLESS_SERVER(false)
 			{
-				main_render_predict_tag_resources();
+				PROFILER(predict_tag_resources)
+				{
+					main_render_predict_tag_resources();
+				}
 			}
 		}
 
 		exceptions_update();
 		collision_log_end_frame();
+		allocation_audit_frame_end();
 
 		// we no longer hook calls from `main_loop_body` for this
 		test_main_loop_body_end();
@@ -1291,7 +1323,13 @@ void __cdecl main_loop_body_single_threaded()
 		main_loop_body();
 	}
 
-	if (!game_is_multithreaded() || !g_main_gamestate_timing_data->flags.is_empty())
+	// nothing consumes published game state on a headless server, skip the mirror publish and render entirely
+	if (main_headless_server())
+	{
+		g_main_gamestate_timing_data->reset();
+		main_render_purge_pending_messages();
+	}
+	else if (!game_is_multithreaded() || !g_main_gamestate_timing_data->flags.is_empty())
 	{
 		font_idle();
 
@@ -1345,6 +1383,7 @@ void __cdecl main_loop_enter()
 	main_loading_initialize();
 	main_game_initialize();
 	main_time_initialize();
+	main_headless_initialize();
 	console_initialize();
 	game_initialize();
 
@@ -1391,6 +1430,8 @@ void __cdecl main_loop_exit()
 	physical_memory_resize_region_dispose();
 	game_dispose();
 	console_dispose();
+	main_headless_dispose();
+	job_system_dispose();
 	main_loading_dispose();
 }
 
@@ -0,0 +1,305 @@
+#include "main/main_headless.hpp"
+
+#include "cache/restricted_memory.hpp"
+#include "cseries/cseries_events.hpp"
+#include "game/game.hpp"
+#include "game/game_time.hpp"
+#include "memory/crc.hpp"
+#include "saved_games/game_state.hpp"
+
+#include <windows.h>
+
+#if !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+enum
+{
+	k_main_headless_pregame_frame_rate = 60,
+};
+
+s_main_headless_globals g_main_headless_globals
+{
+	.enabled = false,
+	.pace_to_game_ticks = true,
+	.checksum_interval = 0,
+};
+
+// the deterministic game state making up the simulation, by the exact allocation name it is registered with, anything
+// else a headless server may leave untouched and is not part of the simulation checksum on any host
+static const char* const k_main_headless_simulation_allocation_names[]
+{
+	"sim. gamestate entities",
+	"random math",
+	"game globals",
+	"players",
+	"players globals",
+	"game engine globals",
+	"game time globals",
+	"breakable surface breakable_surface_globals",
+	"breakable surface set broken events",
+	"player mapping globals",
+	"det hs thread",
+	"hs runtime globals",
+	"hs globals",
+	"hs dist. globals",
+	"havok gamestate",
+	"player control globals deterministic",
+	"campaign meta-game globals",
+	"game allegiance globals",
+	"havok proxies",
+	"physics constants",
+	"recorded animations",
+	"scenario interpolator globals",
+	"survival mode globals",
+	"kill trigger volume state",
+	"object list header",
+	"list object",
+	"object",
+	"object globals",
+	"objects",
+	"object name list",
+	"damage globals",
+	"object placement globals",
+	"device groups",
+	"object scripting",
+	"object activation regions",
+	"recycling_volumes",
+	"recycling_group",
+	"actor",
+	"ai globals",
+	"ai player state globals",
+	"command scripts",
+	"objectives",
+	"task records",
+	"squad",
+	"squad group",
+	"swarm",
+	"swarm_spawner",
+	"spawner_globals",
+	"dynamic firing points",
+	"prop_ref",
+	"prop",
+	"tracking",
+	"joint state",
+	"clump",
+	"squad_patrol",
+	"flocks",
+	"formations",
+};
+
+static int64 main_headless_counter()
+{
+	LARGE_INTEGER counter{};
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+}
+
+static int64 main_headless_counter_frequency()
+{
+	static int64 frequency = 0;
+	if (frequency == 0)
+	{
+		LARGE_INTEGER counter_frequency{};
+		QueryPerformanceFrequency(&counter_frequency);
+		frequency = counter_frequency.QuadPart;
+	}
+	return frequency;
+}
+
+static real32 main_headless_counter_to_milliseconds(int64 counter_delta)
+{
+	return real32(1000.0 * counter_delta / main_headless_counter_frequency());
+}
+
+static void main_headless_histogram_add_sample(s_main_headless_histogram* histogram, real32 milliseconds)
+{
+	int32 bucket_index = 0;
+	while (bucket_index < k_main_headless_histogram_bucket_count - 1 && milliseconds >= main_headless_histogram_bucket_milliseconds(bucket_index))
+	{
+		bucket_index++;
+	}
+
+	histogram->sample_count++;
+	histogram->total_milliseconds += milliseconds;
+	histogram->maximum_milliseconds = MAX(histogram->maximum_milliseconds, milliseconds);
+	histogram->bucket_counts[bucket_index]++;
+}
+
+// the upper limit of a bucket, the last bucket has no limit
+real32 __cdecl main_headless_histogram_bucket_milliseconds(int32 bucket_index)
+{
+	ASSERT(VALID_INDEX(bucket_index, k_main_headless_histogram_bucket_count));
+
+	return 0.125f * real32(FLAG(bucket_index));
+}
+
+bool __cdecl main_headless_server()
+{
+	return g_main_headless_globals.enabled;
+}
+
+void __cdecl main_headless_set_enabled(bool enabled)
+{
+	g_main_headless_globals.enabled = enabled;
+}
+
+void __cdecl main_headless_initialize()
+{
+	main_headless_histograms_reset();
+
+	g_main_headless_globals.next_frame_counter = 0;
+	g_main_headless_globals.last_checksum = 0;
+	g_main_headless_globals.last_checksum_time = NONE;
+	g_main_headless_globals.last_simulation_allocation_count = NONE;
+
+	if (!main_headless_server())
+	{
+		return;
+	}
+
+	// high resolution timers are only available from windows 10 1803, older systems get the default timer resolution
+	g_main_headless_globals.wait_timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (!g_main_headless_globals.wait_timer)
+	{
+		g_main_headless_globals.wait_timer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+	}
+
+	event(_event_message, "main:headless: running headless, presentation systems and game state publishing are disabled");
+}
+
+void __cdecl main_headless_dispose()
+{
+	if (g_main_headless_globals.wait_timer)
+	{
+		CloseHandle(g_main_headless_globals.wait_timer);
+		g_main_headless_globals.wait_timer = NULL;
+	}
+}
+
+void __cdecl main_headless_frame_begin()
+{
+	g_main_headless_globals.frame_start_counter = main_headless_counter();
+}
+
+void __cdecl main_headless_frame_end()
+{
+	int64 counter = main_headless_counter();
+	main_headless_histogram_add_sample(&g_main_headless_globals.frame_histogram, main_headless_counter_to_milliseconds(counter - g_main_headless_globals.frame_start_counter));
+
+	if (!main_headless_server() || !g_main_headless_globals.pace_to_game_ticks)
+	{
+		return;
+	}
+
+	int32 frame_rate = game_in_progress() ? game_tick_rate_get() : k_main_headless_pregame_frame_rate;
+	int64 frame_period = main_headless_counter_frequency() / MAX(frame_rate, 1);
+
+	// a frame that ran over its period doesn't get paid back by shorter waits later, the schedule restarts from now
+	if (g_main_headless_globals.next_frame_counter == 0 || counter - g_main_headless_globals.next_frame_counter > frame_period)
+	{
+		g_main_headless_globals.next_frame_counter = counter;
+	}
+	g_main_headless_globals.next_frame_counter += frame_period;
+
+	int64 wait_counter = g_main_headless_globals.next_frame_counter - counter;
+	if (wait_counter <= 0)
+	{
+		return;
+	}
+
+	if (g_main_headless_globals.wait_timer)
+	{
+		// negative due times are relative, in 100 nanosecond units
+		LARGE_INTEGER due_time{};
+		due_time.QuadPart = -(10000000 * wait_counter / main_headless_counter_frequency());
+		if (SetWaitableTimer(g_main_headless_globals.wait_timer, &due_time, 0, NULL, NULL, FALSE))
+		{
+			WaitForSingleObject(g_main_headless_globals.wait_timer, INFINITE);
+		}
+	}
+	else
+	{
+		Sleep(uns32(1000 * wait_counter / main_headless_counter_frequency()));
+	}
+
+	main_headless_histogram_add_sample(&g_main_headless_globals.wait_histogram, main_headless_counter_to_milliseconds(main_headless_counter() - counter));
+}
+
+void __cdecl main_headless_game_tick_begin()
+{
+	g_main_headless_globals.tick_start_counter = main_headless_counter();
+}
+
+void __cdecl main_headless_game_tick_end()
+{
+	main_headless_histogram_add_sample(&g_main_headless_globals.game_tick_histogram, main_headless_counter_to_milliseconds(main_headless_counter() - g_main_headless_globals.tick_start_counter));
+
+	if (g_main_headless_globals.checksum_interval <= 0)
+	{
+		return;
+	}
+
+	int32 time = game_time_get();
+	if (time % g_main_headless_globals.checksum_interval == 0)
+	{
+		g_main_headless_globals.last_checksum = main_headless_simulation_checksum();
+		g_main_headless_globals.last_checksum_time = time;
+
+		event(_event_message, "main:headless: checksum %08X at game time %d", g_main_headless_globals.last_checksum, time);
+	}
+}
+
+bool __cdecl main_headless_allocation_is_simulation(const char* name)
+{
+	for (int32 name_index = 0; name_index < NUMBEROF(k_main_headless_simulation_allocation_names); name_index++)
+	{
+		if (csstrcmp(name, k_main_headless_simulation_allocation_names[name_index]) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// crc of every deterministic update and shared region allocation making up the simulation
+uns32 __cdecl main_headless_simulation_checksum()
+{
+	uns32 checksum = crc_new();
+	int32 simulation_allocation_count = 0;
+
+	for (int32 allocation_index = 0; allocation_index < g_game_state_deterministic_allocations.count; allocation_index++)
+	{
+		const s_game_state_deterministic_allocation* allocation = &g_game_state_deterministic_allocations.allocations[allocation_index];
+		if (allocation->region_index != k_game_state_update_region && allocation->region_index != k_game_state_shared_region)
+		{
+			continue;
+		}
+
+		if (main_headless_allocation_is_simulation(allocation->name))
+		{
+			checksum = crc32(checksum, (const byte*)allocation->primary_address, allocation->size);
+			simulation_allocation_count++;
+		}
+	}
+
+	// a renamed allocation drops out of the checksum rather than failing it, say so instead of comparing less
+	if (simulation_allocation_count != g_main_headless_globals.last_simulation_allocation_count)
+	{
+		event(_event_message, "main:headless: %d of %d simulation allocations checksummed",
+			simulation_allocation_count,
+			NUMBEROF(k_main_headless_simulation_allocation_names));
+		g_main_headless_globals.last_simulation_allocation_count = simulation_allocation_count;
+	}
+
+	return checksum;
+}
+
+void __cdecl main_headless_histograms_reset()
+{
+	csmemset(&g_main_headless_globals.frame_histogram, 0, sizeof(g_main_headless_globals.frame_histogram));
+	csmemset(&g_main_headless_globals.game_tick_histogram, 0, sizeof(g_main_headless_globals.game_tick_histogram));
+	csmemset(&g_main_headless_globals.wait_histogram, 0, sizeof(g_main_headless_globals.wait_histogram));
+}
+
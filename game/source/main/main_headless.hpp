@@ -0,0 +1,61 @@
+#pragma once
+
+#include "cseries/cseries.hpp"
+
+#define HEADLESS_SERVER(true_false) if (main_headless_server() == true_false)
+
+enum
+{
+	// bucket 0 holds samples under 0.125ms, every following bucket doubles the limit of the one before it
+	k_main_headless_histogram_bucket_count = 12,
+};
+
+struct s_main_headless_histogram
+{
+	int32 sample_count;
+	real32 total_milliseconds;
+	real32 maximum_milliseconds;
+	int32 bucket_counts[k_main_headless_histogram_bucket_count];
+};
+
+struct s_main_headless_globals
+{
+	// set from `-headless` on the command line, a headless server runs the simulation, networking and scripts
+	// but never creates a window or device, renders, plays sound, ticks the hud or publishes game state to the render mirror
+	bool enabled;
+
+	// replaces the main loop's millisecond throttle with a high resolution wait for the next game tick
+	bool pace_to_game_ticks;
+
+	// when non-zero, the simulation checksum is logged every that many game ticks, on headless and normal hosts alike
+	int32 checksum_interval;
+
+	int64 frame_start_counter;
+	int64 next_frame_counter;
+	int64 tick_start_counter;
+	void* wait_timer;
+
+	uns32 last_checksum;
+	int32 last_checksum_time;
+	int32 last_simulation_allocation_count;
+
+	s_main_headless_histogram frame_histogram;
+	s_main_headless_histogram game_tick_histogram;
+	s_main_headless_histogram wait_histogram;
+};
+
+extern s_main_headless_globals g_main_headless_globals;
+
+extern bool __cdecl main_headless_server();
+extern void __cdecl main_headless_set_enabled(bool enabled);
+extern void __cdecl main_headless_initialize();
+extern void __cdecl main_headless_dispose();
+extern void __cdecl main_headless_frame_begin();
+extern void __cdecl main_headless_frame_end();
+extern void __cdecl main_headless_game_tick_begin();
+extern void __cdecl main_headless_game_tick_end();
+extern bool __cdecl main_headless_allocation_is_simulation(const char* name);
+extern uns32 __cdecl main_headless_simulation_checksum();
+extern void __cdecl main_headless_histograms_reset();
+extern real32 __cdecl main_headless_histogram_bucket_milliseconds(int32 bucket_index);
+
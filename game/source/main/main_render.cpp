@@ -35,6 +35,7 @@
 #include "rasterizer/rasterizer_synchronization.hpp"
 #include "render/old_render_debug.hpp"
 #include "render/render.hpp"
+#include "render/render_software_occlusion.hpp"
 #include "render/screen_postprocess.hpp"
 #include "render/views/render_view.hpp"
 #include "shell/shell.hpp"
@@ -369,6 +370,14 @@ void __cdecl main_render_game()
 				c_static_wchar_string<32> pix_name;
 				bool is_widescreen = c_rasterizer::get_is_widescreen();
 
+				// the occlusion views of every window are built together so split-screen spreads them over the workers
+				const render_camera* window_cameras[MAXIMUM_PLAYER_WINDOWS]{};
+				for (int32 window_index = 0; window_index < window_count; window_index++)
+				{
+					window_cameras[window_index] = c_player_view::get_current(window_index)->get_rasterizer_camera();
+				}
+				render_software_occlusion_prepare_views(window_cameras, window_count);
+
 				for (int32 window_index = 0; window_index < window_count; window_index++)
 				{
 					c_rasterizer_profile_scope _player_view(_rasterizer_profile_element_total, pix_name.print(L"player_view %d", window_index));
@@ -0,0 +1,383 @@
+#include "memory/allocation_audit.hpp"
+
+#include "config/version.hpp"
+#include "cseries/cseries_events.hpp"
+#include "game/game.hpp"
+#include "game/game_time.hpp"
+#include "memory/data.hpp"
+#include "memory/memory_pool.hpp"
+#include "multithreading/threads.hpp"
+#include "tag_files/files.hpp"
+
+#include <stdlib.h>
+
+s_allocation_audit_globals g_allocation_audit_globals
+{
+	.enabled = false,
+	.allocation_free_phase_flags = FLAG(_allocation_audit_phase_objects_update) | FLAG(_allocation_audit_phase_havok_update),
+	.current_phase = NONE,
+};
+
+const char* const k_allocation_audit_phase_names[k_allocation_audit_phase_count]
+{
+	"objects update",
+	"havok update",
+};
+
+const char* const k_allocation_audit_source_names[k_allocation_audit_source_count]
+{
+	"memory pool",
+	"data array",
+	"datum",
+	"optional cache",
+};
+
+static uns32 allocation_audit_callsite_hash(e_allocation_audit_source source, const char* file, int32 line, const void* return_address)
+{
+	uns32 hash = file ? uns32(uintptr_t(file)) ^ (uns32(line) * 0x9E3779B1) : uns32(uintptr_t(return_address));
+	hash ^= uns32(source) << 28;
+	hash ^= hash >> 15;
+	hash *= 0x2C1B3C6D;
+	hash ^= hash >> 12;
+	return hash;
+}
+
+static bool allocation_audit_callsite_match(const s_allocation_audit_callsite* callsite, e_allocation_audit_source source, const char* file, int32 line, const void* return_address)
+{
+	if (callsite->source != source || callsite->file != file)
+	{
+		return false;
+	}
+
+	// a file and line names the callsite by itself, whatever function was between it and the allocation
+	return file ? callsite->line == line : callsite->return_address == return_address;
+}
+
+static s_allocation_audit_callsite* allocation_audit_callsite_get(e_allocation_audit_source source, const char* name, const char* file, int32 line, const void* return_address)
+{
+	s_allocation_audit_globals* globals = &g_allocation_audit_globals;
+
+	uns32 slot_mask = NUMBEROF(globals->callsite_hash_table) - 1;
+	uns32 slot = allocation_audit_callsite_hash(source, file, line, return_address) & slot_mask;
+	for (; globals->callsite_hash_table[slot] != NONE; slot = (slot + 1) & slot_mask)
+	{
+		s_allocation_audit_callsite* callsite = &globals->callsites[globals->callsite_hash_table[slot]];
+		if (allocation_audit_callsite_match(callsite, source, file, line, return_address))
+		{
+			return callsite;
+		}
+	}
+
+	if (!VALID_INDEX(globals->callsite_count, k_maximum_allocation_audit_callsites))
+	{
+		return NULL;
+	}
+
+	int32 callsite_index = globals->callsite_count++;
+	globals->callsite_hash_table[slot] = int16(callsite_index);
+
+	s_allocation_audit_callsite* callsite = &globals->callsites[callsite_index];
+	csmemset(callsite, 0, sizeof(s_allocation_audit_callsite));
+	callsite->source = source;
+	callsite->file = file;
+	callsite->line = file ? line : NONE;
+	callsite->return_address = file ? NULL : return_address;
+	callsite->name.set(name ? name : "");
+	callsite->hot_path_phase = NONE;
+	return callsite;
+}
+
+static void allocation_audit_record(e_allocation_audit_source source, e_allocation_audit_event event_type, const char* name, const char* file, int32 line, const void* return_address, int32 size)
+{
+	s_allocation_audit_globals* globals = &g_allocation_audit_globals;
+
+	s_allocation_audit_callsite* callsite = allocation_audit_callsite_get(source, name, file, line, return_address);
+	if (!callsite)
+	{
+		globals->dropped_event_count++;
+		return;
+	}
+
+	callsite->event_counts[event_type]++;
+	callsite->tick_event_count++;
+	callsite->frame_event_count++;
+
+	if (event_type == _allocation_audit_event_free)
+	{
+		return;
+	}
+
+	callsite->allocated_bytes += MAX(size, 0);
+
+	if (globals->current_phase != NONE && TEST_BIT(globals->allocation_free_phase_flags, globals->current_phase))
+	{
+		globals->hot_path_count++;
+		callsite->hot_path_phase = globals->current_phase;
+		if (callsite->hot_path_count++ == 0)
+		{
+			c_static_string<256> location;
+			allocation_audit_callsite_get_location(callsite, &location);
+			event(_event_warning, "memory:audit: %s '%s' allocated %d bytes from %s during allocation free %s",
+				allocation_audit_source_get_name(source),
+				callsite->name.get_string(),
+				size,
+				location.get_string(),
+				allocation_audit_phase_get_name(e_allocation_audit_phase(globals->current_phase)));
+		}
+	}
+}
+
+void c_allocation_audit_scope::begin(e_allocation_audit_source source, e_allocation_audit_event event_type, const char* name, const char* file, int32 line, const void* return_address, int32 size)
+{
+	s_allocation_audit_globals* globals = &g_allocation_audit_globals;
+
+	if (!is_main_thread())
+	{
+		return;
+	}
+
+	m_counted = true;
+	if (globals->depth++ == 0)
+	{
+		allocation_audit_record(source, event_type, name, file, line, return_address, size);
+	}
+}
+
+void c_allocation_audit_scope::begin(e_allocation_audit_source source, e_allocation_audit_event event_type, const s_data_array* data, const void* return_address)
+{
+	ASSERT(data);
+
+	int32 size = source == _allocation_audit_source_datum && event_type != _allocation_audit_event_free ? data->size : 0;
+	begin(source, event_type, data->name.get_string(), NULL, NONE, return_address, size);
+}
+
+void c_allocation_audit_scope::begin(e_allocation_audit_event event_type, const s_memory_pool* pool, const char* file, int32 line, const void* return_address, int32 size)
+{
+	ASSERT(pool);
+
+	begin(_allocation_audit_source_memory_pool, event_type, pool->name.get_string(), file, line, return_address, size);
+}
+
+void c_allocation_audit_scope::end()
+{
+	g_allocation_audit_globals.depth--;
+}
+
+void allocation_audit_start()
+{
+	s_allocation_audit_globals* globals = &g_allocation_audit_globals;
+
+	globals->tick_count = 0;
+	globals->frame_count = 0;
+	globals->hot_path_count = 0;
+	globals->dropped_event_count = 0;
+	globals->callsite_count = 0;
+	csmemset(globals->callsite_hash_table, 0xFF, sizeof(globals->callsite_hash_table));
+	globals->enabled = true;
+}
+
+void allocation_audit_stop()
+{
+	g_allocation_audit_globals.enabled = false;
+}
+
+void allocation_audit_phase_begin(e_allocation_audit_phase phase)
+{
+	g_allocation_audit_globals.current_phase = phase;
+}
+
+void allocation_audit_phase_end(e_allocation_audit_phase phase)
+{
+	s_allocation_audit_globals* globals = &g_allocation_audit_globals;
+
+	if (globals->current_phase == phase)
+	{
+		globals->current_phase = NONE;
+	}
+}
+
+void allocation_audit_game_tick_end()
+{
+	s_allocation_audit_globals* globals = &g_allocation_audit_globals;
+
+	if (!globals->enabled)
+	{
+		return;
+	}
+
+	for (int32 callsite_index = 0; callsite_index < globals->callsite_count; callsite_index++)
+	{
+		s_allocation_audit_callsite* callsite = &globals->callsites[callsite_index];
+		if (callsite->tick_event_count > 0)
+		{
+			callsite->peak_tick_event_count = MAX(callsite->peak_tick_event_count, callsite->tick_event_count);
+			callsite->active_tick_count++;
+			callsite->tick_event_count = 0;
+		}
+	}
+
+	globals->tick_count++;
+}
+
+void allocation_audit_frame_end()
+{
+	s_allocation_audit_globals* globals = &g_allocation_audit_globals;
+
+	if (!globals->enabled)
+	{
+		return;
+	}
+
+	for (int32 callsite_index = 0; callsite_index < globals->callsite_count; callsite_index++)
+	{
+		s_allocation_audit_callsite* callsite = &globals->callsites[callsite_index];
+		if (callsite->frame_event_count > 0)
+		{
+			callsite->peak_frame_event_count = MAX(callsite->peak_frame_event_count, callsite->frame_event_count);
+			callsite->active_frame_count++;
+			callsite->frame_event_count = 0;
+		}
+	}
+
+	globals->frame_count++;
+}
+
+int __cdecl allocation_audit_callsite_rank_sort_proc(const void* a, const void* b)
+{
+	const s_allocation_audit_callsite* callsite_a = &g_allocation_audit_globals.callsites[*static_cast<const int32*>(a)];
+	const s_allocation_audit_callsite* callsite_b = &g_allocation_audit_globals.callsites[*static_cast<const int32*>(b)];
+
+	// hot path allocations first, then the callsites allocating the most
+	if (callsite_a->hot_path_count != callsite_b->hot_path_count)
+	{
+		return callsite_a->hot_path_count > callsite_b->hot_path_count ? -1 : 1;
+	}
+
+	int32 allocations_a = callsite_a->event_counts[_allocation_audit_event_allocate] + callsite_a->event_counts[_allocation_audit_event_reallocate];
+	int32 allocations_b = callsite_b->event_counts[_allocation_audit_event_allocate] + callsite_b->event_counts[_allocation_audit_event_reallocate];
+	if (allocations_a != allocations_b)
+	{
+		return allocations_a > allocations_b ? -1 : 1;
+	}
+
+	return callsite_a->event_counts[_allocation_audit_event_free] > callsite_b->event_counts[_allocation_audit_event_free] ? -1 :
+		callsite_a->event_counts[_allocation_audit_event_free] < callsite_b->event_counts[_allocation_audit_event_free] ? 1 : 0;
+}
+
+int32 allocation_audit_get_ranked_callsites(int32* callsite_indices, int32 maximum_count)
+{
+	s_allocation_audit_globals* globals = &g_allocation_audit_globals;
+	ASSERT(callsite_indices);
+
+	int32 ranked_callsite_indices[k_maximum_allocation_audit_callsites];
+	for (int32 callsite_index = 0; callsite_index < globals->callsite_count; callsite_index++)
+	{
+		ranked_callsite_indices[callsite_index] = callsite_index;
+	}
+	qsort(ranked_callsite_indices, globals->callsite_count, sizeof(int32), allocation_audit_callsite_rank_sort_proc);
+
+	int32 count = MIN(maximum_count, globals->callsite_count);
+	csmemcpy(callsite_indices, ranked_callsite_indices, count * sizeof(int32));
+	return count;
+}
+
+void allocation_audit_callsite_get_location(const s_allocation_audit_callsite* callsite, c_static_string<256>* location)
+{
+	ASSERT(callsite);
+	ASSERT(location);
+
+	if (callsite->file)
+	{
+		location->print("%s(%d)", callsite->file, callsite->line);
+	}
+	else
+	{
+		location->print("0x%08X", uns32(uintptr_t(callsite->return_address)));
+	}
+}
+
+// appends every callsite ranked to a report, each line is the callsite, what it allocates from, its counts over the
+// audit, its busiest tick and frame and its hot path allocations
+bool allocation_audit_export_report()
+{
+	s_allocation_audit_globals* globals = &g_allocation_audit_globals;
+
+	s_file_reference report_file{};
+	create_report_file_reference(&report_file, "allocation_audit.txt", true);
+
+	uns32 error = 0;
+	if (!file_exists(&report_file))
+	{
+		file_create(&report_file);
+	}
+
+	if (!file_open(&report_file, FLAG(_file_open_flag_desired_access_write), &error))
+	{
+		event(_event_warning, "memory:audit: failed to open the allocation audit report");
+		return false;
+	}
+
+	uns32 file_size = 0;
+	file_get_size(&report_file, &file_size);
+	file_set_position(&report_file, file_size, false);
+
+	file_printf(&report_file, "%s, %s, %d ticks, %d frames, %d hot path allocations, %d dropped events\r\n",
+		version_get_full_string(),
+		game_options_get()->scenario_path.get_string(),
+		globals->tick_count,
+		globals->frame_count,
+		globals->hot_path_count,
+		globals->dropped_event_count);
+
+	int32 callsite_indices[k_maximum_allocation_audit_callsites];
+	int32 callsite_count = allocation_audit_get_ranked_callsites(callsite_indices, k_maximum_allocation_audit_callsites);
+	for (int32 rank = 0; rank < callsite_count; rank++)
+	{
+		const s_allocation_audit_callsite* callsite = &globals->callsites[callsite_indices[rank]];
+
+		c_static_string<256> location;
+		allocation_audit_callsite_get_location(callsite, &location);
+
+		file_printf(&report_file, "% 4d,% 64s,% 16s,% 32s,% 10d,% 10d,% 10d,% 12lld,% 8d,% 8d,% 8d,% 8d,% 8d,% 20s\r\n",
+			rank,
+			location.get_string(),
+			allocation_audit_source_get_name(callsite->source),
+			callsite->name.get_string(),
+			callsite->event_counts[_allocation_audit_event_allocate],
+			callsite->event_counts[_allocation_audit_event_reallocate],
+			callsite->event_counts[_allocation_audit_event_free],
+			callsite->allocated_bytes,
+			callsite->peak_tick_event_count,
+			callsite->active_tick_count,
+			callsite->peak_frame_event_count,
+			callsite->active_frame_count,
+			callsite->hot_path_count,
+			callsite->hot_path_phase != NONE ? allocation_audit_phase_get_name(e_allocation_audit_phase(callsite->hot_path_phase)) : "");
+	}
+
+	file_close(&report_file);
+
+	event(_event_message, "memory:audit: exported %d callsites over %d ticks and %d frames", callsite_count, globals->tick_count, globals->frame_count);
+	return true;
+}
+
+const char* allocation_audit_phase_get_name(e_allocation_audit_phase phase)
+{
+	if (!VALID_INDEX(phase, k_allocation_audit_phase_count))
+	{
+		return "<invalid>";
+	}
+
+	return k_allocation_audit_phase_names[phase];
+}
+
+const char* allocation_audit_source_get_name(e_allocation_audit_source source)
+{
+	if (!VALID_INDEX(source, k_allocation_audit_source_count))
+	{
+		return "<invalid>";
+	}
+
+	return k_allocation_audit_source_names[source];
+}
+
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "cseries/cseries.hpp"
+
+// while the audit is enabled every memory pool block, data array, datum and optional cache allocation and free made on
+// the main thread is counted against the place it was made from, the `file` and `line` a memory pool block is allocated
+// with when there is one, the return address of the call otherwise, and the counts are rolled up every game tick and
+// every main loop frame, a frame runs any number of ticks and everything the main thread does outside of them
+
+// `game_tick` marks the phases of `e_allocation_audit_phase` as they run, the ones marked as allocation free flag anything
+// allocated while they are running, the first time for a callsite with a warning, the ranked callsites can be exported
+// to a report
+
+// every allocation and free goes through the scope, with the audit off it stops at checking `enabled`, the name and
+// datum size of a pool or data array are only looked up once the audit is on
+
+enum
+{
+	k_maximum_allocation_audit_callsites = 1024,
+};
+
+enum e_allocation_audit_phase
+{
+	_allocation_audit_phase_objects_update = 0,
+	_allocation_audit_phase_havok_update,
+
+	k_allocation_audit_phase_count
+};
+
+enum e_allocation_audit_source
+{
+	_allocation_audit_source_memory_pool = 0,
+	_allocation_audit_source_data_array,
+	_allocation_audit_source_datum,
+	_allocation_audit_source_optional_cache,
+
+	k_allocation_audit_source_count
+};
+
+enum e_allocation_audit_event
+{
+	_allocation_audit_event_allocate = 0,
+	_allocation_audit_event_reallocate,
+	_allocation_audit_event_free,
+
+	k_allocation_audit_event_count
+};
+
+struct s_allocation_audit_callsite
+{
+	e_allocation_audit_source source;
+	const char* file;
+	int32 line;
+	const void* return_address;
+
+	// the pool or data array of the first event, callsites are shared by everything allocated from the same place
+	c_static_string<32> name;
+
+	int32 event_counts[k_allocation_audit_event_count];
+	int64 allocated_bytes;
+
+	// events this tick, the most in any one tick and how many ticks had any
+	int32 tick_event_count;
+	int32 peak_tick_event_count;
+	int32 active_tick_count;
+
+	// the same for main loop frames
+	int32 frame_event_count;
+	int32 peak_frame_event_count;
+	int32 active_frame_count;
+
+	// allocations and reallocations made inside an allocation free phase
+	int32 hot_path_count;
+	int32 hot_path_phase;
+};
+
+struct s_allocation_audit_globals
+{
+	bool enabled;
+
+	// by `e_allocation_audit_phase`
+	uns32 allocation_free_phase_flags;
+	int32 current_phase;
+
+	// only the outermost call is counted, allocations made while an allocation is being made are part of it
+	int32 depth;
+
+	int32 tick_count;
+	int32 frame_count;
+	int32 hot_path_count;
+	int32 dropped_event_count;
+
+	int32 callsite_count;
+	s_allocation_audit_callsite callsites[k_maximum_allocation_audit_callsites];
+	int16 callsite_hash_table[k_maximum_allocation_audit_callsites * 2];
+};
+
+extern s_allocation_audit_globals g_allocation_audit_globals;
+
+struct s_data_array;
+struct s_memory_pool;
+
+class c_allocation_audit_scope
+{
+public:
+	c_allocation_audit_scope(e_allocation_audit_source source, e_allocation_audit_event event_type, const char* name, const char* file, int32 line, const void* return_address, int32 size) :
+		m_counted(false)
+	{
+		if (g_allocation_audit_globals.enabled)
+		{
+			begin(source, event_type, name, file, line, return_address, size);
+		}
+	}
+
+	// a data array being freed or a datum of it, a datum allocation counts the datum size of the array
+	c_allocation_audit_scope(e_allocation_audit_source source, e_allocation_audit_event event_type, const s_data_array* data, const void* return_address) :
+		m_counted(false)
+	{
+		if (g_allocation_audit_globals.enabled)
+		{
+			begin(source, event_type, data, return_address);
+		}
+	}
+
+	c_allocation_audit_scope(e_allocation_audit_event event_type, const s_memory_pool* pool, const char* file, int32 line, const void* return_address, int32 size) :
+		m_counted(false)
+	{
+		if (g_allocation_audit_globals.enabled)
+		{
+			begin(event_type, pool, file, line, return_address, size);
+		}
+	}
+
+	~c_allocation_audit_scope()
+	{
+		if (m_counted)
+		{
+			end();
+		}
+	}
+
+protected:
+	void begin(e_allocation_audit_source source, e_allocation_audit_event event_type, const char* name, const char* file, int32 line, const void* return_address, int32 size);
+	void begin(e_allocation_audit_source source, e_allocation_audit_event event_type, const s_data_array* data, const void* return_address);
+	void begin(e_allocation_audit_event event_type, const s_memory_pool* pool, const char* file, int32 line, const void* return_address, int32 size);
+	void end();
+
+	bool m_counted;
+};
+
+extern void allocation_audit_start();
+extern void allocation_audit_stop();
+extern void allocation_audit_phase_begin(e_allocation_audit_phase phase);
+extern void allocation_audit_phase_end(e_allocation_audit_phase phase);
+extern void allocation_audit_game_tick_end();
+extern void allocation_audit_frame_end();
+extern int32 allocation_audit_get_ranked_callsites(int32* callsite_indices, int32 maximum_count);
+extern void allocation_audit_callsite_get_location(const s_allocation_audit_callsite* callsite, c_static_string<256>* location);
+extern bool allocation_audit_export_report();
+extern const char* allocation_audit_phase_get_name(e_allocation_audit_phase phase);
+extern const char* allocation_audit_source_get_name(e_allocation_audit_source source);
+
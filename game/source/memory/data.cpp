@@ -1,7 +1,18 @@
 #include "memory/data.hpp"
 
+#include "memory/allocation_audit.hpp"
 #include "memory/module.hpp"
+#include "saved_games/game_state_telemetry.hpp"
 
+#include <intrin.h>
+
+HOOK_DECLARE(0x0055ACC0, data_dispose);
+HOOK_DECLARE(0x0055AFA0, data_new);
+HOOK_DECLARE(0x0055B2E0, datum_delete);
+HOOK_DECLARE(0x0055B410, datum_new);
+HOOK_DECLARE(0x0055B4D0, datum_new_at_absolute_index);
+HOOK_DECLARE(0x0055B550, datum_new_at_index);
+HOOK_DECLARE(0x0055B5D0, datum_new_in_range);
 HOOK_DECLARE(0x0055B6D0, datum_try_and_get);
 
 int32 __cdecl data_allocation_size(int32 maximum_count, int32 size, int32 alignment_bits)
@@ -57,7 +68,11 @@ void __cdecl data_disconnect(s_data_array* data)
 
 void __cdecl data_dispose(s_data_array* data)
 {
-	INVOKE(0x0055ACC0, data_dispose, data);
+	//INVOKE(0x0055ACC0, data_dispose, data);
+
+	c_allocation_audit_scope audit_scope(_allocation_audit_source_data_array, _allocation_audit_event_free, data, _ReturnAddress());
+
+	HOOK_INVOKE(, data_dispose, data);
 
 	//c_allocation_base* allocation = data->allocator;
 	//ASSERT(allocation != NULL);
@@ -167,7 +182,13 @@ void __cdecl data_make_valid(s_data_array* data)
 
 s_data_array* __cdecl data_new(const char* name, int32 maximum_count, int32 size, int32 alignment_bits, c_allocation_base* allocation)
 {
-	return INVOKE(0x0055AFA0, data_new, name, maximum_count, size, alignment_bits, allocation);
+	//return INVOKE(0x0055AFA0, data_new, name, maximum_count, size, alignment_bits, allocation);
+
+	c_allocation_audit_scope audit_scope(_allocation_audit_source_data_array, _allocation_audit_event_allocate, name, NULL, NONE, _ReturnAddress(), maximum_count * size);
+
+	s_data_array* data = NULL;
+	HOOK_INVOKE(data =, data_new, name, maximum_count, size, alignment_bits, allocation);
+	return data;
 
 	//s_data_array* data = static_cast<s_data_array*>(allocation->allocate(data_allocation_size(maximum_count, size, alignment_bits), name));
 	//if (data)
@@ -270,7 +291,11 @@ bool __cdecl datum_available_at_index(const s_data_array* data, int32 index)
 
 void __cdecl datum_delete(s_data_array* data, int32 index)
 {
-	INVOKE(0x0055B2E0, datum_delete, data, index);
+	//INVOKE(0x0055B2E0, datum_delete, data, index);
+
+	c_allocation_audit_scope audit_scope(_allocation_audit_source_datum, _allocation_audit_event_free, data, _ReturnAddress());
+
+	HOOK_INVOKE(, datum_delete, data, index);
 }
 
 void __cdecl datum_initialize(s_data_array* data, s_datum_header* header)
@@ -290,22 +315,70 @@ void __cdecl datum_initialize_isolated(s_data_array* data, s_datum_header* heade
 
 int32 __cdecl datum_new(s_data_array* data)
 {
-	return INVOKE(0x0055B410, datum_new, data);
+	//return INVOKE(0x0055B410, datum_new, data);
+
+	c_allocation_audit_scope audit_scope(_allocation_audit_source_datum, _allocation_audit_event_allocate, data, _ReturnAddress());
+
+	int32 datum_index = NONE;
+	HOOK_INVOKE(datum_index =, datum_new, data);
+
+	if (datum_index != NONE)
+	{
+		game_state_telemetry_notify_datum_new(data);
+	}
+
+	return datum_index;
 }
 
 int32 __cdecl datum_new_at_absolute_index(s_data_array* data, int32 absolute_index)
 {
-	return INVOKE(0x0055B4D0, datum_new_at_absolute_index, data, absolute_index);
+	//return INVOKE(0x0055B4D0, datum_new_at_absolute_index, data, absolute_index);
+
+	c_allocation_audit_scope audit_scope(_allocation_audit_source_datum, _allocation_audit_event_allocate, data, _ReturnAddress());
+
+	int32 datum_index = NONE;
+	HOOK_INVOKE(datum_index =, datum_new_at_absolute_index, data, absolute_index);
+
+	if (datum_index != NONE)
+	{
+		game_state_telemetry_notify_datum_new(data);
+	}
+
+	return datum_index;
 }
 
 int32 __cdecl datum_new_at_index(s_data_array* data, int32 index)
 {
-	return INVOKE(0x0055B550, datum_new_at_index, data, index);
+	//return INVOKE(0x0055B550, datum_new_at_index, data, index);
+
+	c_allocation_audit_scope audit_scope(_allocation_audit_source_datum, _allocation_audit_event_allocate, data, _ReturnAddress());
+
+	int32 datum_index = NONE;
+	HOOK_INVOKE(datum_index =, datum_new_at_index, data, index);
+
+	if (datum_index != NONE)
+	{
+		game_state_telemetry_notify_datum_new(data);
+	}
+
+	return datum_index;
 }
 
 int32 __cdecl datum_new_in_range(s_data_array* data, int32 minimum_index, int32 count_indices, bool initialize)
 {
-	return INVOKE(0x0055B5D0, datum_new_in_range, data, minimum_index, count_indices, initialize);
+	//return INVOKE(0x0055B5D0, datum_new_in_range, data, minimum_index, count_indices, initialize);
+
+	c_allocation_audit_scope audit_scope(_allocation_audit_source_datum, _allocation_audit_event_allocate, data, _ReturnAddress());
+
+	int32 datum_index = NONE;
+	HOOK_INVOKE(datum_index =, datum_new_in_range, data, minimum_index, count_indices, initialize);
+
+	if (datum_index != NONE)
+	{
+		game_state_telemetry_notify_datum_new(data);
+	}
+
+	return datum_index;
 }
 
 void* __cdecl datum_get(s_data_array* data, int32 index)
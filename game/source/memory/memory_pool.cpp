@@ -1,5 +1,15 @@
 #include "memory/memory_pool.hpp"
 
+#include "memory/allocation_audit.hpp"
+#include "memory/module.hpp"
+#include "saved_games/game_state_telemetry.hpp"
+
+#include <intrin.h>
+
+HOOK_DECLARE(0x00969B80, memory_pool_block_allocate);
+HOOK_DECLARE(0x00969C80, memory_pool_block_free_handle);
+HOOK_DECLARE(0x0096A0E0, memory_pool_block_reallocate);
+
 //.text:00969AC0 ; s_memory_pool* __cdecl fixed_memory_pool_new(const char*, void*, int32, e_memory_pool_callback_list)
 //.text:00969AF0 ; t_memory_pool_callback_list* (get_memory_pool_callback)(e_memory_pool_callback_list)
 //.text:00969B00 ; void __cdecl memory_block_notify_reference(s_memory_pool*, s_memory_pool_block*)
@@ -15,12 +25,33 @@ int32 __cdecl memory_pool_allocation_size(int32 size)
 
 bool __cdecl memory_pool_block_allocate(s_memory_pool* pool, void** ptr, int32 size, const char* file, int32 line)
 {
-	return INVOKE(0x00969B80, memory_pool_block_allocate, pool, ptr, size, file, line);
+	//return INVOKE(0x00969B80, memory_pool_block_allocate, pool, ptr, size, file, line);
+
+	c_allocation_audit_scope audit_scope(_allocation_audit_event_allocate, pool, file, line, _ReturnAddress(), size);
+
+	bool result = false;
+	HOOK_INVOKE(result =, memory_pool_block_allocate, pool, ptr, size, file, line);
+
+	if (result)
+	{
+		game_state_telemetry_notify_memory_pool_block_allocate(pool);
+	}
+
+	return result;
 }
 
 //.text:00969BF0 ; uns32 __cdecl memory_pool_block_allocate_handle_tracked(s_memory_pool*, int32, unsigned int, const char*, int32)
 //.text:00969C50 ; unsigned int __cdecl memory_pool_block_compute_actual_size(const s_memory_pool*, unsigned int)
 
+// `memory_pool_block_free` is overloaded, the hook of the payload handle version goes through this one, the payload data
+// version ends up in it too
+void __cdecl memory_pool_block_free_handle(s_memory_pool* pool, uns32 payload_handle)
+{
+	c_allocation_audit_scope audit_scope(_allocation_audit_event_free, pool, NULL, NONE, _ReturnAddress(), 0);
+
+	HOOK_INVOKE(, memory_pool_block_free_handle, pool, payload_handle);
+}
+
 void __cdecl memory_pool_block_free(s_memory_pool* pool, uns32 payload_handle)
 {
 	//INVOKE(0x00969C80, memory_pool_block_free, pool, payload_handle);
@@ -106,7 +137,19 @@ int32 __cdecl memory_pool_block_handle_from_payload_handle(int32 payload_handle)
 
 bool __cdecl memory_pool_block_reallocate(s_memory_pool* pool, void** ptr, int32 size, const char* file, int32 line)
 {
-	return INVOKE(0x0096A0E0, memory_pool_block_reallocate, pool, ptr, size, file, line);
+	//return INVOKE(0x0096A0E0, memory_pool_block_reallocate, pool, ptr, size, file, line);
+
+	c_allocation_audit_scope audit_scope(_allocation_audit_event_reallocate, pool, file, line, _ReturnAddress(), size);
+
+	bool result = false;
+	HOOK_INVOKE(result =, memory_pool_block_reallocate, pool, ptr, size, file, line);
+
+	if (result)
+	{
+		game_state_telemetry_notify_memory_pool_block_allocate(pool);
+	}
+
+	return result;
 }
 
 //.text:0096A130 ; int32 __cdecl memory_pool_block_reallocate_handle(s_memory_pool*, int32, int32, const char*, int32)
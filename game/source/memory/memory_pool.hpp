@@ -51,6 +51,7 @@ extern int32 __cdecl memory_pool_allocation_size(int32 size);
 extern bool __cdecl memory_pool_block_allocate(s_memory_pool* pool, void** ptr, int32 size, const char* file, int32 line);
 extern void __cdecl memory_pool_block_free(s_memory_pool* pool, uns32 payload_handle);
 extern void memory_pool_block_free(s_memory_pool* pool, const void** payload_data);
+extern void __cdecl memory_pool_block_free_handle(s_memory_pool* pool, uns32 payload_handle);
 extern s_memory_pool_block* __cdecl memory_pool_block_get(s_memory_pool* pool, int32 payload_handle);
 extern int32 __cdecl memory_pool_block_handle_from_payload_handle(int32 payload_handle);
 extern bool __cdecl memory_pool_block_reallocate(s_memory_pool* pool, void** ptr, int32 size, const char* file, int32 line);
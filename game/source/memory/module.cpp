@@ -90,28 +90,31 @@ void apply_all_patches(bool revert)
 c_hook::c_hook(const char* name, uns32 address, module_address const function, bool remove_base) :
 	m_name(name),
 	m_addr({ .address = global_address_get(remove_base ? function.address - 0x00400000 : function.address) }),
-	m_orig({ .address = global_address_get(remove_base ? address - 0x00400000 : address) })
+	m_orig({ .address = global_address_get(remove_base ? address - 0x00400000 : address) }),
+	m_applied(false)
 {
 	ASSERT(VALID_COUNT(g_detour_hook_count,  k_maximum_individual_modification_count));
 	detour_hooks[g_detour_hook_count++] = this;
 }
 
-bool c_hook::apply(bool revert)
+// attaching replaces `original` with a trampoline that runs the overwritten instructions and jumps back into the
+// original code, detaching puts the original code back in place and restores `original`
+static bool detour_apply(void** original, void* detour, bool revert)
 {
-	if (m_addr.pointer == nullptr || m_orig.pointer == nullptr)
-		return false;
-	
-	if (m_addr.address == 0xFEFEFEFE || m_orig.address == 0xFEFEFEFE)
-		return false;
-
 	if (NO_ERROR != DetourTransactionBegin())
 		return false;
 
 	if (NO_ERROR != DetourUpdateThread(GetCurrentThread()))
+	{
+		DetourTransactionAbort();
 		return false;
+	}
 
-	if (NO_ERROR != (revert ? DetourDetach : DetourAttach)(&m_orig.pointer, m_addr.pointer))
+	if (NO_ERROR != (revert ? DetourDetach : DetourAttach)(original, detour))
+	{
+		DetourTransactionAbort();
 		return false;
+	}
 
 	if (NO_ERROR != DetourTransactionCommit())
 		return false;
@@ -119,6 +122,25 @@ bool c_hook::apply(bool revert)
 	return true;
 }
 
+bool c_hook::apply(bool revert)
+{
+	if (m_addr.pointer == nullptr || m_orig.pointer == nullptr)
+		return false;
+	
+	if (m_addr.address == 0xFEFEFEFE || m_orig.address == 0xFEFEFEFE)
+		return false;
+
+	if (m_applied == !revert)
+		return true;
+
+	if (!detour_apply(&m_orig.pointer, m_addr.pointer, revert))
+		return false;
+
+	m_applied = !revert;
+
+	return true;
+}
+
 c_hook_call::c_hook_call(const char* name, uns32 address, module_address const function, bool remove_base) :
 	m_name(name),
 	m_addr({ .address = global_address_get(remove_base ? address - 0x00400000 : address) }),
@@ -261,3 +283,94 @@ bool patch_pointer(module_address address, const void* pointer)
 	return true;
 }
 
+
+// mov eax, 0x0000D0E5; ret; the five byte mov leaves detours exactly enough room for its jump
+static const byte k_hook_invoke_test_code[]
+{
+	0xB8, 0xE5, 0xD0, 0x00, 0x00,
+	0xC3,
+	0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC
+};
+const uns32 k_hook_invoke_test_result = 0xD0E5;
+
+static module_address hook_invoke_test_original{};
+
+static uns32 __cdecl hook_invoke_test_function()
+{
+	return reinterpret_cast<decltype(&hook_invoke_test_function)>(hook_invoke_test_original.pointer)() + 1;
+}
+
+static real32 hook_invoke_counter_to_nanoseconds(int64 counter_delta, int32 call_count)
+{
+	LARGE_INTEGER frequency{};
+	QueryPerformanceFrequency(&frequency);
+
+	return real32(1000000000.0 * counter_delta / frequency.QuadPart / MAX(call_count, 1));
+}
+
+bool hook_invoke_benchmark(int32 iterations, s_hook_invoke_benchmark_result* result)
+{
+	ASSERT(result);
+
+	csmemset(result, 0, sizeof(s_hook_invoke_benchmark_result));
+
+	void* code = VirtualAlloc(NULL, sizeof(k_hook_invoke_test_code), MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+	if (!code)
+		return false;
+
+	csmemcpy(code, k_hook_invoke_test_code, sizeof(k_hook_invoke_test_code));
+	FlushInstructionCache(GetCurrentProcess(), code, sizeof(k_hook_invoke_test_code));
+
+	typedef uns32(__cdecl* test_function_t)();
+	test_function_t test_function = reinterpret_cast<test_function_t>(code);
+
+	bool passed = test_function() == k_hook_invoke_test_result;
+
+	hook_invoke_test_original.pointer = code;
+	if (passed && detour_apply(&hook_invoke_test_original.pointer, hook_invoke_test_function, false))
+	{
+		// the generated function now reaches the hook, the trampoline still reaches the generated code
+		passed = hook_invoke_test_original.pointer != code
+			&& test_function() == k_hook_invoke_test_result + 1
+			&& reinterpret_cast<test_function_t>(hook_invoke_test_original.pointer)() == k_hook_invoke_test_result;
+
+		uns32 checksum = 0;
+		LARGE_INTEGER start{};
+		LARGE_INTEGER end{};
+
+		result->trampoline_call_count = MAX(iterations, 1);
+		QueryPerformanceCounter(&start);
+		for (int32 call_index = 0; call_index < result->trampoline_call_count; call_index++)
+		{
+			checksum += reinterpret_cast<test_function_t>(hook_invoke_test_original.pointer)();
+		}
+		QueryPerformanceCounter(&end);
+		result->trampoline_call_nanoseconds = hook_invoke_counter_to_nanoseconds(end.QuadPart - start.QuadPart, result->trampoline_call_count);
+
+		// every toggle rewrites the code page twice, a thousand calls are plenty to measure it
+		result->toggle_call_count = MIN(result->trampoline_call_count, 1000);
+		QueryPerformanceCounter(&start);
+		for (int32 call_index = 0; call_index < result->toggle_call_count; call_index++)
+		{
+			detour_apply(&hook_invoke_test_original.pointer, hook_invoke_test_function, true);
+			checksum += reinterpret_cast<test_function_t>(hook_invoke_test_original.pointer)();
+			detour_apply(&hook_invoke_test_original.pointer, hook_invoke_test_function, false);
+		}
+		QueryPerformanceCounter(&end);
+		result->toggle_call_nanoseconds = hook_invoke_counter_to_nanoseconds(end.QuadPart - start.QuadPart, result->toggle_call_count);
+
+		passed = passed && checksum == uns32(result->trampoline_call_count + result->toggle_call_count) * k_hook_invoke_test_result;
+
+		detour_apply(&hook_invoke_test_original.pointer, hook_invoke_test_function, true);
+		passed = passed && hook_invoke_test_original.pointer == code && test_function() == k_hook_invoke_test_result;
+	}
+	else
+	{
+		passed = false;
+	}
+
+	VirtualFree(code, 0, MEM_RELEASE);
+
+	result->self_test_passed = passed;
+	return passed;
+}
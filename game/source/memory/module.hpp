@@ -8,25 +8,20 @@
 #define HOOK_DECLARE_CLASS(ADDR, CLASS, NAME) inline static c_hook CLASS##_##NAME##_hook(#NAME, ADDR, { .pointer = CLASS::NAME })
 #define HOOK_DECLARE_CLASS_MEMBER(ADDR, CLASS, NAME) inline static c_hook CLASS##_##NAME##_hook(#NAME, ADDR, { .pointer = member_to_static_function(&CLASS##::##NAME) })
 
+// calls the original function through the trampoline built when the hook was applied, no code is patched per call
 #define HOOK_INVOKE(RESULT, NAME, ...) \
 { \
-	NAME##_hook.apply(true); \
 	RESULT reinterpret_cast<decltype(&NAME)>(NAME##_hook.get_original())(__VA_ARGS__); \
-	NAME##_hook.apply(false); \
 }
 
 #define HOOK_INVOKE_CLASS(RESULT, CLASS, NAME, TYPE, ...) \
 { \
-	CLASS##_##NAME##_hook.apply(true); \
 	RESULT reinterpret_cast<TYPE>(CLASS##_##NAME##_hook.get_original())(__VA_ARGS__); \
-	CLASS##_##NAME##_hook.apply(false); \
 }
 
 #define HOOK_INVOKE_CLASS_MEMBER(RESULT, CLASS, NAME, ...) \
 { \
-    CLASS##_##NAME##_hook.apply(true); \
     RESULT (this->*static_to_member_t<decltype(&CLASS##::##NAME)>{ .address = CLASS##_##NAME##_hook.get_original() }.function)(__VA_ARGS__); \
-    CLASS##_##NAME##_hook.apply(false); \
 }
 
 #define DATA_PATCH_DECLARE(ADDR, NAME, ...) static c_data_patch CONCAT(NAME##_patch,__LINE__)(#NAME, ADDR, NUMBEROF(__VA_ARGS__), __VA_ARGS__)
@@ -70,15 +65,22 @@ public:
 		return m_addr.address;
 	}
 
+	// the trampoline to the original code while the hook is applied, the original code itself otherwise
 	uns32 get_original()
 	{
 		return m_orig.address;
 	}
 
+	bool applied()
+	{
+		return m_applied;
+	}
+
 private:
 	c_static_string<128> m_name;
 	module_address m_addr;
 	module_address m_orig;
+	bool m_applied;
 };
 
 class c_hook_call
@@ -172,3 +174,18 @@ void type_as_byte_string(t_type* type, char(&out_string)[k_string_size])
 
 extern bool patch_pointer(module_address address, const void* pointer);
 
+struct s_hook_invoke_benchmark_result
+{
+	// hooks a function generated at runtime and checks calls to it reach the hook and the trampoline reaches the original
+	bool self_test_passed;
+
+	int32 trampoline_call_count;
+	real32 trampoline_call_nanoseconds;
+
+	// the detach, call and attach every call used to go through
+	int32 toggle_call_count;
+	real32 toggle_call_nanoseconds;
+};
+
+extern bool hook_invoke_benchmark(int32 iterations, s_hook_invoke_benchmark_result* result);
+
@@ -0,0 +1,136 @@
+#include "multithreading/job_system.hpp"
+
+#include "cseries/cseries_events.hpp"
+#include "multithreading/threads.hpp"
+
+#include <windows.h>
+
+s_job_system_globals g_job_system_globals{};
+
+uns32 __stdcall job_system_worker_thread(void* parameter)
+{
+	s_job_system_worker* worker = (s_job_system_worker*)parameter;
+
+	while (true)
+	{
+		WaitForSingleObject(worker->start_event, INFINITE);
+		if (g_job_system_globals.workers_exiting)
+		{
+			break;
+		}
+
+		for (int32 job_index = worker->first_job_index; job_index < worker->first_job_index + worker->job_count; job_index++)
+		{
+			g_job_system_globals.job_proc(g_job_system_globals.job_context, job_index);
+		}
+		SetEvent(worker->done_event);
+	}
+
+	return 0;
+}
+
+static bool job_system_workers_create(int32 worker_count)
+{
+	for (int32 worker_index = 0; worker_index < worker_count; worker_index++)
+	{
+		s_job_system_worker* worker = &g_job_system_globals.workers[worker_index];
+		if (worker->running)
+		{
+			continue;
+		}
+
+		if (!worker->start_event)
+			worker->start_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+		if (!worker->done_event)
+			worker->done_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+		if (!worker->start_event || !worker->done_event)
+		{
+			event(_event_warning, "jobs: failed to create events for worker %d", worker_index);
+			return false;
+		}
+
+		uns32 thread_id = 0;
+		worker->thread_handle = CreateThread(NULL, 0, job_system_worker_thread, worker, 0, &thread_id);
+		if (!worker->thread_handle)
+		{
+			event(_event_warning, "jobs: failed to create thread for worker %d", worker_index);
+			return false;
+		}
+		worker->running = true;
+
+		c_static_string<32> thread_name;
+		SetThreadName(thread_id, thread_name.print("JOB_WORKER_%d", worker_index));
+	}
+
+	return true;
+}
+
+void __cdecl job_system_dispose()
+{
+	s_job_system_globals* globals = &g_job_system_globals;
+	ASSERT(!globals->running);
+
+	globals->workers_exiting = true;
+	for (int32 worker_index = 0; worker_index < k_maximum_job_system_workers; worker_index++)
+	{
+		s_job_system_worker* worker = &globals->workers[worker_index];
+		if (worker->running)
+		{
+			SetEvent(worker->start_event);
+			WaitForSingleObject(worker->thread_handle, INFINITE);
+			CloseHandle(worker->thread_handle);
+		}
+
+		if (worker->start_event)
+			CloseHandle(worker->start_event);
+		if (worker->done_event)
+			CloseHandle(worker->done_event);
+
+		csmemset(worker, 0, sizeof(s_job_system_worker));
+	}
+	globals->workers_exiting = false;
+}
+
+// runs every job of the batch and returns once all of them are done, on the calling thread when a single worker is
+// asked for or the workers can't be created
+void __cdecl job_system_run(job_system_job_proc_t* job_proc, void* context, int32 job_count, int32 worker_count)
+{
+	s_job_system_globals* globals = &g_job_system_globals;
+	ASSERT(job_proc);
+	ASSERT(!globals->running);
+
+	worker_count = MIN(MIN(worker_count, job_count), k_maximum_job_system_workers);
+	if (worker_count <= 1 || !job_system_workers_create(worker_count))
+	{
+		for (int32 job_index = 0; job_index < job_count; job_index++)
+		{
+			job_proc(context, job_index);
+		}
+		return;
+	}
+
+	globals->running = true;
+	globals->job_proc = job_proc;
+	globals->job_context = context;
+
+	void* done_events[k_maximum_job_system_workers]{};
+	int32 first_job_index = 0;
+	for (int32 worker_index = 0; worker_index < worker_count; worker_index++)
+	{
+		s_job_system_worker* worker = &globals->workers[worker_index];
+		int32 last_job_index = (job_count * (worker_index + 1)) / worker_count;
+
+		worker->first_job_index = first_job_index;
+		worker->job_count = last_job_index - first_job_index;
+		done_events[worker_index] = worker->done_event;
+		SetEvent(worker->start_event);
+
+		first_job_index = last_job_index;
+	}
+
+	WaitForMultipleObjects(worker_count, done_events, TRUE, INFINITE);
+
+	globals->job_proc = NULL;
+	globals->job_context = NULL;
+	globals->running = false;
+}
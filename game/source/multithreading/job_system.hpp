@@ -0,0 +1,42 @@
+#pragma once
+
+#include "cseries/cseries.hpp"
+
+// one pool of worker threads shared by every system that splits work into independent jobs, the workers are created the
+// first time a batch needs them and live until `job_system_dispose`, a batch is split into contiguous ranges of jobs,
+// one per worker, and the caller waits for all of them, batches never overlap
+
+enum
+{
+	k_maximum_job_system_workers = 4,
+};
+
+typedef void __cdecl job_system_job_proc_t(void* context, int32 job_index);
+
+struct s_job_system_worker
+{
+	void* thread_handle;
+	void* start_event;
+	void* done_event;
+	bool running;
+
+	int32 first_job_index;
+	int32 job_count;
+};
+
+struct s_job_system_globals
+{
+	bool workers_exiting;
+
+	// the batch the workers are running, set by `job_system_run` before any worker is started
+	bool running;
+	job_system_job_proc_t* job_proc;
+	void* job_context;
+
+	s_job_system_worker workers[k_maximum_job_system_workers];
+};
+
+extern s_job_system_globals g_job_system_globals;
+
+extern void __cdecl job_system_dispose();
+extern void __cdecl job_system_run(job_system_job_proc_t* job_proc, void* context, int32 job_count, int32 worker_count);
@@ -3,6 +3,7 @@
 #include "cseries/cseries_events.hpp"
 #include "memory/module.hpp"
 #include "networking/delivery/network_link.hpp"
+#include "networking/logic/network_search_summary.hpp"
 #include "networking/messages/network_messages_out_of_band.hpp"
 #include "networking/messages/network_messages_session_protocol.hpp"
 #include "networking/network_memory.hpp"
@@ -53,6 +54,7 @@ bool __cdecl network_broadcast_search_begin(int32 controller_index, int32 maximu
 			g_broadcast_search_globals.available_sessions = session_storage;
 
 			csmemset(session_storage, 0, sizeof(s_available_session) * maximum_session_count);
+			network_search_summary_begin(session_storage, maximum_session_count);
 		}
 		else
 		{
@@ -75,6 +77,7 @@ void __cdecl network_broadcast_search_end()
 	//INVOKE(0x004D9D20, network_broadcast_search_end);
 
 	g_broadcast_search_globals.search_active = 0;
+	network_search_summary_end();
 }
 
 void __cdecl network_broadcast_search_handle_reply(const transport_address* address, const s_network_message_broadcast_reply* message)
@@ -85,82 +88,46 @@ void __cdecl network_broadcast_search_handle_reply(const transport_address* addr
 
 	if (g_broadcast_search_globals.search_active)
 	{
-		int32 existing_session_index = NONE;
-		int32 v7 = NONE;
-		int32 v6 = NONE;
-		int32 v5 = NONE;
-
-		for (int32 i = 0; i < g_broadcast_search_globals.maximum_session_count; i++)
+		// replies are matched against the summaries, only sessions holding storage copy their full status data
+		bool summary_changed = false;
+		int32 summary_index = network_search_summary_update(&message->status_data, network_time_get(), &summary_changed);
+		if (summary_index == NONE)
+		{
+			event(_event_error, "networking:logic:broadcast-search: too many games on the network, can't store reply");
+		}
+		else
 		{
-			s_available_session* session = &g_broadcast_search_globals.available_sessions[i];
+			// a session the reply moved into the list is pinned before it claims storage
+			const int16* index = NULL;
+			network_search_summary_build_index(&index);
 
-			if (session->session_valid)
+			bool taken_over = false;
+			s_available_session* session = network_search_summary_claim_detail(summary_index, &taken_over);
+			if (session)
 			{
-				if (transport_secure_address_compare(&session->status_data.game_details.description.host_address, &message->status_data.game_details.description.host_address))
+				if (csmemcmp(&session->status_data, &message->status_data, sizeof(s_network_squad_status_data)))
 				{
-					ASSERT(existing_session_index == NONE);
-					existing_session_index = i;
-					break;
+					csmemcpy(&session->status_data, &message->status_data, sizeof(s_network_squad_status_data));
+
+					session->status_data_valid = true;
+					g_broadcast_search_globals.sessions_updated = true;
 				}
-			}
-			else if (v7 == NONE)
-			{
-				v7 = i;
-			}
-		}
 
-		if (existing_session_index == NONE)
-		{
-			if (v7 == NONE)
-			{
-				if (v6 == NONE)
-					v5 = NONE;
-				else
-					v5 = v6;
-			}
-			else
-			{
-				v5 = v7;
+				session->session_valid = true;
+				session->last_update_timestamp = network_time_get();
+				session->connect_established = true;
 			}
-		}
-		else
-		{
-			v5 = existing_session_index;
-		}
 
-		if (v5 == NONE)
-		{
-			event(_event_error, "networking:logic:broadcast-search: too many games on the network, can't store reply");
-		}
-		else
-		{
-			s_available_session* session = &g_broadcast_search_globals.available_sessions[v5];
-
-			if (v5 != existing_session_index)
-				csmemset(session, 0, sizeof(s_available_session));
-
-			if (csmemcmp(&session->status_data, &message->status_data, sizeof(s_network_squad_status_data)))
+			if (summary_changed || taken_over)
 			{
-				csmemcpy(&session->status_data, &message->status_data, sizeof(s_network_squad_status_data));
-
-				session->status_data_valid = true;
 				g_broadcast_search_globals.sessions_updated = true;
 			}
-
-			session->session_valid = true;
-			session->last_update_timestamp = network_time_get();
-			session->connect_established = true;
 		}
 	}
 
-	bool add_session = false;
-	for (int32 i = 0; i < g_broadcast_search_globals.maximum_session_count; i++)
-	{
-		s_available_session const session = g_broadcast_search_globals.available_sessions[i];
-
-		if (session.session_valid && transport_secure_identifier_compare(&session.status_data.game_details.description.id, &message->status_data.game_details.description.id))
-			add_session = true;
-	}
+	// the summaries outlive the search, a reply arriving after it ended is still matched
+	const s_network_search_summary* summary = network_search_summary_get(network_search_summary_find(&message->status_data.game_details.description.host_address));
+	bool add_session = summary && transport_secure_identifier_compare(&summary->session_id, &message->status_data.game_details.description.id);
 
 	if (add_session)
 		XNetAddEntry(address, &message->status_data.game_details.description.host_address, &message->status_data.game_details.description.id);
@@ -210,14 +177,15 @@ void __cdecl network_broadcast_search_update()
 			g_broadcast_search_globals.last_broadcast_message_sent = network_time_get();
 		}
 
-		for (int32 i = 0; i < g_broadcast_search_globals.maximum_session_count; i++)
+		// a session times out along with its summary, the storage it held goes back to the sessions without
+		for (int32 summary_index = 0; summary_index < g_network_search_summary_globals.summary_count; summary_index++)
 		{
-			s_available_session* session = &g_broadcast_search_globals.available_sessions[i];
-			if (session->session_valid)
+			const s_network_search_summary* summary = &g_network_search_summary_globals.summaries[summary_index];
+			if (summary->valid)
 			{
-				if (network_time_since(session->last_update_timestamp) > 4000)
+				if (network_time_since(summary->last_update_timestamp) > 4000)
 				{
-					csmemset(session, 0, sizeof(s_available_session));
+					network_search_summary_expire(summary_index);
 					g_broadcast_search_globals.sessions_updated = true;
 				}
 			}
@@ -1,11 +1,15 @@
 #include "networking/logic/network_search.hpp"
 
+#include "memory/module.hpp"
 #include "networking/logic/network_broadcast_search.hpp"
 #include "networking/logic/network_recruiting_search.hpp"
+#include "networking/logic/network_search_summary.hpp"
 
 
 REFERENCE_DECLARE(0x0229AEA8, s_network_search_globals, g_network_search_globals);
 
+HOOK_DECLARE(0x004E1200, network_search_session);
+
 void network_search_active(int32 controller_index, bool active)
 {
 	//INVOKE(0x004E1030, network_search_active, controller_index, active);
@@ -98,14 +102,18 @@ bool network_search_initialize()
 	return true;
 }
 
-s_available_session* network_search_session(int32 available_squad_index)
+s_available_session* __cdecl network_search_session(int32 available_squad_index)
 {
 	//return INVOKE(0x004E1200, network_search_session, available_squad_index);
 
 	if (available_squad_index >= 0 && available_squad_index < g_network_search_globals.available_session_count)
 	{
-		s_available_session* session = &g_network_search_globals.available_sessions[available_squad_index];
-		if (network_search_session_valid(session))
+		// broadcast sessions are listed through their summaries, in the list order
+		s_available_session* session = g_network_search_globals.search_category == 0
+			? network_search_summary_list_session(available_squad_index)
+			: &g_network_search_globals.available_sessions[available_squad_index];
+
+		if (session && network_search_session_valid(session))
 			return session;
 	}
 
@@ -0,0 +1,385 @@
+#include "networking/logic/network_search_summary.hpp"
+
+#include "networking/logic/network_search.hpp"
+#include "networking/messages/network_messages_out_of_band.hpp"
+#include "networking/network_time.hpp"
+
+s_network_search_summary_globals g_network_search_summary_globals{};
+
+static bool network_search_summary_filter_match(const s_network_search_summary* summary, const s_network_search_summary_filter* filter)
+{
+	return (filter->game_engine_type == NONE || summary->game_engine_type == filter->game_engine_type)
+		&& (filter->map_id == NONE || summary->map_id == filter->map_id)
+		&& summary->open_slot_count >= filter->minimum_open_slot_count;
+}
+
+static bool network_search_summary_filter_equal(const s_network_search_summary_filter* a, const s_network_search_summary_filter* b)
+{
+	return a->game_engine_type == b->game_engine_type
+		&& a->map_id == b->map_id
+		&& a->minimum_open_slot_count == b->minimum_open_slot_count;
+}
+
+// counts sort the largest first, everything else the smallest first
+static int32 network_search_summary_sort_key(const s_network_search_summary* summary, e_network_search_summary_sort sort)
+{
+	switch (sort)
+	{
+	case _network_search_summary_sort_player_count:
+		return summary->player_count;
+	case _network_search_summary_sort_open_slot_count:
+		return summary->open_slot_count;
+	case _network_search_summary_sort_connection_quality:
+		return summary->connection_quality;
+	case _network_search_summary_sort_game_engine:
+		return -summary->game_engine_type;
+	case _network_search_summary_sort_map:
+		return -summary->map_id;
+	}
+
+	return 0;
+}
+
+void network_search_summary_begin(s_available_session* detail_storage, int32 detail_count)
+{
+	s_network_search_summary_globals* globals = &g_network_search_summary_globals;
+	ASSERT(detail_storage);
+	ASSERT(detail_count > 0 && detail_count <= k_maximum_network_search_summaries);
+
+	// the list order is kept from one search to the next
+	e_network_search_summary_sort list_sort = globals->list_sort;
+	s_network_search_summary_filter list_filter = globals->list_filter;
+	bool list_order_set = globals->list_order_set;
+
+	csmemset(globals, 0, sizeof(s_network_search_summary_globals));
+	globals->detail_storage = detail_storage;
+	globals->detail_count = detail_count;
+	globals->index_generation = NONE;
+
+	globals->list_order_set = list_order_set;
+	globals->list_sort = list_sort;
+	globals->list_filter = list_filter;
+	if (!globals->list_order_set)
+	{
+		globals->list_sort = _network_search_summary_sort_none;
+		globals->list_filter.game_engine_type = NONE;
+		globals->list_filter.map_id = NONE;
+		globals->list_filter.minimum_open_slot_count = 0;
+	}
+}
+
+void network_search_summary_end()
+{
+	s_network_search_summary_globals* globals = &g_network_search_summary_globals;
+
+	// the session storage goes back to its allocator once the search ends, the summaries stay for late replies
+	for (int32 summary_index = 0; summary_index < globals->summary_count; summary_index++)
+	{
+		s_network_search_summary* summary = &globals->summaries[summary_index];
+		summary->detail_index = NONE;
+		summary->detail_wanted = false;
+		summary->pinned = false;
+	}
+
+	globals->detail_storage = NULL;
+	globals->detail_count = 0;
+	globals->generation++;
+}
+
+int32 network_search_summary_find(const s_transport_secure_address* host_address)
+{
+	s_network_search_summary_globals* globals = &g_network_search_summary_globals;
+	ASSERT(host_address);
+
+	for (int32 summary_index = 0; summary_index < globals->summary_count; summary_index++)
+	{
+		const s_network_search_summary* summary = &globals->summaries[summary_index];
+		if (summary->valid && transport_secure_address_compare(&summary->host_address, host_address))
+		{
+			return summary_index;
+		}
+	}
+
+	return NONE;
+}
+
+// returns the summary of the session `status_data` describes, adding one when the session is new,
+// `NONE` when every summary is taken
+int32 network_search_summary_update(const s_network_squad_status_data* status_data, uns32 timestamp, bool* out_changed)
+{
+	s_network_search_summary_globals* globals = &g_network_search_summary_globals;
+	ASSERT(status_data);
+	ASSERT(out_changed);
+
+	const s_network_squad_status_data_game_details* game_details = &status_data->game_details;
+	globals->replies_handled++;
+
+	bool added = false;
+	int32 summary_index = network_search_summary_find(&game_details->description.host_address);
+	if (summary_index == NONE)
+	{
+		for (int32 free_index = 0; free_index < k_maximum_network_search_summaries; free_index++)
+		{
+			if (!globals->summaries[free_index].valid)
+			{
+				summary_index = free_index;
+				break;
+			}
+		}
+
+		if (summary_index == NONE)
+		{
+			return NONE;
+		}
+
+		s_network_search_summary* summary = &globals->summaries[summary_index];
+		csmemset(summary, 0, sizeof(s_network_search_summary));
+		summary->valid = true;
+		summary->detail_index = NONE;
+		summary->host_address = game_details->description.host_address;
+		globals->summary_count = MAX(globals->summary_count, summary_index + 1);
+		added = true;
+	}
+
+	s_network_search_summary summary = globals->summaries[summary_index];
+	summary.last_update_timestamp = timestamp;
+	summary.session_id = game_details->description.id;
+	summary.session_class = int8(game_details->session_class);
+	summary.session_type = int8(game_details->session_type);
+	summary.privacy_mode = int8(game_details->session_privacy_mode);
+	summary.game_engine_type = int8(game_details->game_engine_type);
+	summary.player_count = game_details->player_count;
+	summary.open_slot_count = game_details->open_public_slot_count;
+	summary.game_mode = game_details->game_mode;
+	summary.connection_quality = game_details->connection_quality;
+	summary.map_id = game_details->map_id;
+
+	// only the timestamp moves while a session sits in its lobby
+	s_network_search_summary* previous_summary = &globals->summaries[summary_index];
+	*out_changed = added
+		|| csmemcmp(&previous_summary->session_id, &summary.session_id, sizeof(s_network_search_summary) - OFFSETOF(s_network_search_summary, session_id)) != 0;
+
+	*previous_summary = summary;
+	if (*out_changed)
+	{
+		globals->generation++;
+	}
+
+	return summary_index;
+}
+
+// returns the storage holding the full status data of the session, claiming some when there is storage to spare or
+// when it is listed or was selected, `NULL` when the session only keeps its summary, `out_taken_over` is set when
+// another session lost its storage to it
+s_available_session* network_search_summary_claim_detail(int32 summary_index, bool* out_taken_over)
+{
+	s_network_search_summary_globals* globals = &g_network_search_summary_globals;
+	ASSERT(VALID_INDEX(summary_index, globals->summary_count));
+	ASSERT(out_taken_over);
+
+	*out_taken_over = false;
+
+	s_network_search_summary* summary = &globals->summaries[summary_index];
+	ASSERT(summary->valid);
+
+	if (!globals->detail_storage)
+	{
+		return NULL;
+	}
+
+	if (summary->detail_index != NONE)
+	{
+		return &globals->detail_storage[summary->detail_index];
+	}
+
+	int32 detail_index = NONE;
+	for (int32 storage_index = 0; storage_index < globals->detail_count; storage_index++)
+	{
+		if (!globals->detail_storage[storage_index].session_valid)
+		{
+			detail_index = storage_index;
+			break;
+		}
+	}
+
+	if (detail_index == NONE && (summary->pinned || summary->detail_wanted))
+	{
+		// take the storage over from the unlisted session selected longest ago, it keeps its summary
+		int32 oldest_summary_index = NONE;
+		for (int32 owner_index = 0; owner_index < globals->summary_count; owner_index++)
+		{
+			const s_network_search_summary* owner = &globals->summaries[owner_index];
+			if (!owner->valid || owner->pinned || owner->detail_index == NONE)
+			{
+				continue;
+			}
+
+			if (oldest_summary_index == NONE || owner->last_selected_timestamp < globals->summaries[oldest_summary_index].last_selected_timestamp)
+			{
+				oldest_summary_index = owner_index;
+			}
+		}
+
+		if (oldest_summary_index != NONE)
+		{
+			detail_index = globals->summaries[oldest_summary_index].detail_index;
+			globals->summaries[oldest_summary_index].detail_index = NONE;
+			*out_taken_over = true;
+		}
+	}
+
+	if (detail_index == NONE)
+	{
+		globals->summary_only_replies++;
+		return NULL;
+	}
+
+	s_available_session* session = &globals->detail_storage[detail_index];
+	csmemset(session, 0, sizeof(s_available_session));
+	summary->detail_index = int16(detail_index);
+	summary->detail_wanted = false;
+	globals->details_claimed++;
+
+	return session;
+}
+
+void network_search_summary_expire(int32 summary_index)
+{
+	s_network_search_summary_globals* globals = &g_network_search_summary_globals;
+	ASSERT(VALID_INDEX(summary_index, globals->summary_count));
+
+	s_network_search_summary* summary = &globals->summaries[summary_index];
+	if (summary->detail_index != NONE && globals->detail_storage)
+	{
+		csmemset(&globals->detail_storage[summary->detail_index], 0, sizeof(s_available_session));
+	}
+
+	csmemset(summary, 0, sizeof(s_network_search_summary));
+	summary->detail_index = NONE;
+	globals->generation++;
+}
+
+const s_network_search_summary* network_search_summary_get(int32 summary_index)
+{
+	s_network_search_summary_globals* globals = &g_network_search_summary_globals;
+
+	if (!VALID_INDEX(summary_index, globals->summary_count) || !globals->summaries[summary_index].valid)
+	{
+		return NULL;
+	}
+
+	return &globals->summaries[summary_index];
+}
+
+// returns the full status data of the session when it is already held, otherwise the next reply of the session brings it
+const s_available_session* network_search_summary_select(int32 summary_index)
+{
+	s_network_search_summary_globals* globals = &g_network_search_summary_globals;
+
+	if (!network_search_summary_get(summary_index))
+	{
+		return NULL;
+	}
+
+	s_network_search_summary* summary = &globals->summaries[summary_index];
+	summary->last_selected_timestamp = network_time_get();
+
+	if (summary->detail_index == NONE)
+	{
+		summary->detail_wanted = globals->detail_storage != NULL;
+		return NULL;
+	}
+
+	return &globals->detail_storage[summary->detail_index];
+}
+
+void network_search_summary_set_list_order(const s_network_search_summary_filter* filter, e_network_search_summary_sort sort)
+{
+	s_network_search_summary_globals* globals = &g_network_search_summary_globals;
+	ASSERT(filter);
+	ASSERT(VALID_INDEX(sort, k_network_search_summary_sort_count));
+
+	globals->list_order_set = true;
+	globals->list_sort = sort;
+	globals->list_filter = *filter;
+}
+
+// returns the number of summaries passing the list filter, their indices in the list order go to `out_index`, the index
+// is only built again once a summary changed or the list order is different, building it pins the sessions listed
+int32 network_search_summary_build_index(const int16** out_index)
+{
+	s_network_search_summary_globals* globals = &g_network_search_summary_globals;
+	ASSERT(out_index);
+
+	*out_index = globals->index;
+
+	e_network_search_summary_sort sort = globals->list_sort;
+	const s_network_search_summary_filter* filter = &globals->list_filter;
+	if (globals->index_generation == globals->generation
+		&& globals->index_sort == sort
+		&& network_search_summary_filter_equal(&globals->index_filter, filter))
+	{
+		return globals->index_count;
+	}
+
+	globals->index_count = 0;
+	for (int32 summary_index = 0; summary_index < globals->summary_count; summary_index++)
+	{
+		s_network_search_summary* summary = &globals->summaries[summary_index];
+		summary->pinned = false;
+		if (!summary->valid || !network_search_summary_filter_match(summary, filter))
+		{
+			continue;
+		}
+
+		// an insertion sort keeps sessions of equal keys in the order they were first heard from
+		int32 key = network_search_summary_sort_key(summary, sort);
+		int32 insert_index = globals->index_count;
+		while (insert_index > 0 && network_search_summary_sort_key(&globals->summaries[globals->index[insert_index - 1]], sort) < key)
+		{
+			globals->index[insert_index] = globals->index[insert_index - 1];
+			insert_index--;
+		}
+
+		globals->index[insert_index] = int16(summary_index);
+		globals->index_count++;
+	}
+
+	for (int32 list_index = 0; list_index < MIN(globals->index_count, globals->detail_count); list_index++)
+	{
+		globals->summaries[globals->index[list_index]].pinned = true;
+	}
+
+	globals->index_generation = globals->generation;
+	globals->index_sort = sort;
+	globals->index_filter = *filter;
+	globals->index_builds++;
+
+	return globals->index_count;
+}
+
+// the session the session browser shows at `list_index`, `NULL` until its full status data arrived
+s_available_session* network_search_summary_list_session(int32 list_index)
+{
+	s_network_search_summary_globals* globals = &g_network_search_summary_globals;
+
+	if (!globals->detail_storage)
+	{
+		return NULL;
+	}
+
+	const int16* index = NULL;
+	int32 index_count = network_search_summary_build_index(&index);
+	if (!VALID_INDEX(list_index, index_count))
+	{
+		return NULL;
+	}
+
+	const s_network_search_summary* summary = &globals->summaries[index[list_index]];
+	if (summary->detail_index == NONE)
+	{
+		return NULL;
+	}
+
+	return &globals->detail_storage[summary->detail_index];
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "cseries/cseries.hpp"
+#include "networking/transport/transport_security.hpp"
+
+// every session a broadcast search hears from gets a small summary in a dense array, finding the session of a reply,
+// timing sessions out, listing, sorting and filtering them only ever touch the summaries,
+// the full status data of a session is kept in the session storage of the search, which only holds `maximum_sessions`
+// of them, sessions that don't fit keep only their summary until they are listed or selected
+
+// the session browser reads the sessions through the list, the summaries passing the list filter in the list order,
+// the first `maximum_sessions` of them are pinned, a pinned session always gets storage from its next reply and its
+// storage is never taken over, a session selected while it isn't listed takes over the storage of the unlisted session
+// selected longest ago
+
+// summaries outlive the search, replies arriving after it ended are still matched against them, they are only dropped
+// when the next search begins
+
+enum
+{
+	k_maximum_network_search_summaries = 256,
+};
+
+enum e_network_search_summary_sort
+{
+	_network_search_summary_sort_none = 0,
+	_network_search_summary_sort_player_count,
+	_network_search_summary_sort_open_slot_count,
+	_network_search_summary_sort_connection_quality,
+	_network_search_summary_sort_game_engine,
+	_network_search_summary_sort_map,
+
+	k_network_search_summary_sort_count
+};
+
+struct s_network_search_summary
+{
+	bool valid;
+
+	// selected while it had no storage, it takes some over from its next reply
+	bool detail_wanted;
+
+	// among the first `maximum_sessions` of the list, its storage is never taken over
+	bool pinned;
+
+	// the index of the session storage holding its full status data, `NONE` when it only has a summary
+	int16 detail_index;
+
+	uns32 last_update_timestamp;
+	uns32 last_selected_timestamp;
+
+	s_transport_secure_identifier session_id;
+	s_transport_secure_address host_address;
+
+	int8 session_class;
+	int8 session_type;
+	int8 privacy_mode;
+	int8 game_engine_type;
+	int16 player_count;
+	int16 open_slot_count;
+	int16 game_mode;
+	int16 connection_quality;
+	int32 map_id;
+};
+static_assert(sizeof(s_network_search_summary) == 0x40);
+
+struct s_network_search_summary_filter
+{
+	// `NONE` matches everything
+	int32 game_engine_type;
+	int32 map_id;
+
+	int16 minimum_open_slot_count;
+};
+
+struct s_available_session;
+
+struct s_network_search_summary_globals
+{
+	// summaries past `summary_count` have never been used since the search began
+	int32 summary_count;
+	s_network_search_summary summaries[k_maximum_network_search_summaries];
+
+	int32 detail_count;
+	s_available_session* detail_storage;
+
+	// goes up whenever a summary is added, removed or changes a field sorting or filtering looks at
+	int32 generation;
+
+	// the order the session browser lists the sessions in, the order heard from and unfiltered until one is set
+	bool list_order_set;
+	e_network_search_summary_sort list_sort;
+	s_network_search_summary_filter list_filter;
+
+	// the last index built, rebuilt only when the generation, the sort or the filter changes
+	int32 index_generation;
+	e_network_search_summary_sort index_sort;
+	s_network_search_summary_filter index_filter;
+	int32 index_count;
+	int16 index[k_maximum_network_search_summaries];
+
+	int32 replies_handled;
+	int32 details_claimed;
+	int32 summary_only_replies;
+	int32 index_builds;
+};
+
+struct s_network_squad_status_data;
+
+extern s_network_search_summary_globals g_network_search_summary_globals;
+
+extern void network_search_summary_begin(s_available_session* detail_storage, int32 detail_count);
+extern void network_search_summary_end();
+extern int32 network_search_summary_find(const s_transport_secure_address* host_address);
+extern int32 network_search_summary_update(const s_network_squad_status_data* status_data, uns32 timestamp, bool* out_changed);
+extern s_available_session* network_search_summary_claim_detail(int32 summary_index, bool* out_taken_over);
+extern void network_search_summary_expire(int32 summary_index);
+extern const s_network_search_summary* network_search_summary_get(int32 summary_index);
+extern const s_available_session* network_search_summary_select(int32 summary_index);
+extern void network_search_summary_set_list_order(const s_network_search_summary_filter* filter, e_network_search_summary_sort sort);
+extern int32 network_search_summary_build_index(const int16** out_index);
+extern s_available_session* network_search_summary_list_session(int32 list_index);
+
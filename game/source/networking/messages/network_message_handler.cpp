@@ -5,6 +5,7 @@
 #include "networking/logic/network_life_cycle.hpp"
 #include "networking/messages/network_message_type_collection.hpp"
 #include "networking/messages/network_messages_connect.hpp"
+#include "networking/messages/network_messages_determinism.hpp"
 #include "networking/messages/network_messages_out_of_band.hpp"
 #include "networking/messages/network_messages_session_membership.hpp"
 #include "networking/messages/network_messages_session_parameters.hpp"
@@ -559,6 +560,16 @@ void c_network_message_handler::handle_channel_message(c_network_channel* channe
 		}
 	}
 	break;
+	case _custom_network_message_determinism_verification:
+	{
+		ASSERT(message_storage_size == sizeof(s_network_message_determinism_verification));
+
+		if (channel->connected())
+		{
+			handle_determinism_verification(channel, converter.message_determinism_verification);
+		}
+	}
+	break;
 	case _network_message_test:
 	{
 		ASSERT(message_storage_size == sizeof(s_network_message_test));
@@ -1749,3 +1760,15 @@ void c_network_message_handler::handle_text_chat(c_network_channel* channel, con
 	}
 }
 
+void c_network_message_handler::handle_determinism_verification(c_network_channel* channel, const s_network_message_determinism_verification* message)
+{
+	c_network_session* session = m_session_manager->get_session(&message->session_id);
+	if (!session || !session->is_host())
+	{
+		event(_event_warning, "networking:messages:determinism: received a determinism verification from '%s' for a session we don't host",
+			channel->get_name());
+		return;
+	}
+
+	determinism_debug_manager_handle_remote_game_state_checksum(message->game_time, &message->verification);
+}
@@ -48,6 +48,7 @@ struct s_network_message_distributed_game_results;
 struct s_network_message_test;
 struct s_network_message_text_chat;
 struct s_network_message_directed_search;
+struct s_network_message_determinism_verification;
 
 union network_message_converter_t
 {
@@ -92,6 +93,7 @@ union network_message_converter_t
 	const s_network_message_test* message_test;
 	const s_network_message_text_chat* message_text_chat;
 	const s_network_message_directed_search* message_directed_search;
+	const s_network_message_determinism_verification* message_determinism_verification;
 };
 
 class c_network_message_handler
@@ -144,6 +146,7 @@ public:
 	void handle_test(c_network_channel* channel, const s_network_message_test* message);
 	void handle_directed_search(const transport_address* address, const s_network_message_directed_search* message);
 	void handle_text_chat(c_network_channel* channel, const s_network_message_text_chat* message);
+	void handle_determinism_verification(c_network_channel* channel, const s_network_message_determinism_verification* message);
 
 
 //protected:
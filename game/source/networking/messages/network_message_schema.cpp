@@ -0,0 +1,434 @@
+#include "networking/messages/network_message_schema.hpp"
+
+#include "cseries/cseries_events.hpp"
+#include "networking/messages/network_messages_session_protocol.hpp"
+#include "networking/messages/network_messages_simulation.hpp"
+#include "profiler/profiler_stopwatch.hpp"
+
+enum
+{
+	k_network_message_schema_maximum_message_size = 0x400,
+	k_network_message_schema_packet_size = 0x1000,
+	k_network_message_schema_guard_size = 0x10,
+	k_network_message_schema_guard_value = 0xCD,
+
+	k_network_message_schema_wire_check_iterations = 256,
+	k_network_message_schema_parity_check_iterations = 4096,
+};
+
+using c_network_message_peer_connect_schema = c_network_message_schema<s_network_message_peer_connect,
+	c_network_message_integer_field<&s_network_message_peer_connect::protocol, 16>,
+	c_network_message_raw_field<&s_network_message_peer_connect::session_id>,
+	c_network_message_qword_field<&s_network_message_peer_connect::join_nonce>>;
+
+using c_network_message_join_abort_schema = c_network_message_schema<s_network_message_join_abort,
+	c_network_message_raw_field<&s_network_message_join_abort::session_id>,
+	c_network_message_qword_field<&s_network_message_join_abort::join_nonce>>;
+
+using c_network_message_join_refuse_schema = c_network_message_schema<s_network_message_join_refuse,
+	c_network_message_raw_field<&s_network_message_join_refuse::session_id>,
+	c_network_message_enum_field<&s_network_message_join_refuse::reason, k_network_join_refuse_reason_count>>;
+
+using c_network_message_leave_session_schema = c_network_message_schema<s_network_message_leave_session,
+	c_network_message_raw_field<&s_network_message_leave_session::session_id>>;
+
+using c_network_message_leave_acknowledge_schema = c_network_message_schema<s_network_message_leave_acknowledge,
+	c_network_message_raw_field<&s_network_message_leave_acknowledge::session_id>>;
+
+using c_network_message_session_disband_schema = c_network_message_schema<s_network_message_session_disband,
+	c_network_message_raw_field<&s_network_message_session_disband::session_id>>;
+
+using c_network_message_session_boot_schema = c_network_message_schema<s_network_message_session_boot,
+	c_network_message_raw_field<&s_network_message_session_boot::session_id>,
+	c_network_message_enum_field<&s_network_message_session_boot::reason, k_network_session_boot_reason_count>>;
+
+using c_network_message_host_decline_schema = c_network_message_schema<s_network_message_host_decline,
+	c_network_message_raw_field<&s_network_message_host_decline::session_id>,
+	c_network_message_bool_field<&s_network_message_host_decline::session_exists>,
+	c_network_message_bool_field<&s_network_message_host_decline::peer_exists>,
+	c_network_message_bool_field<&s_network_message_host_decline::host_exists>,
+	c_network_message_raw_field<&s_network_message_host_decline::host_address>>;
+
+using c_network_message_peer_establish_schema = c_network_message_schema<s_network_message_peer_establish,
+	c_network_message_raw_field<&s_network_message_peer_establish::session_id>>;
+
+using c_network_message_time_synchronize_schema = c_network_message_schema<s_network_message_time_synchronize,
+	c_network_message_raw_field<&s_network_message_time_synchronize::session_id>,
+	c_network_message_array_field<&s_network_message_time_synchronize::client_timestamp, 32>,
+	c_network_message_array_field<&s_network_message_time_synchronize::authority_timestamp, 32>,
+	c_network_message_integer_field<&s_network_message_time_synchronize::synchronization_stage, 32>>;
+
+using c_network_message_view_establishment_schema = c_network_message_schema<s_network_message_view_establishment,
+	c_network_message_enum_field<&s_network_message_view_establishment::establishment_mode, k_simulation_view_establishment_mode_count>,
+	c_network_message_integer_field<&s_network_message_view_establishment::establishment_identifier, 32>,
+	c_network_message_bool_field<&s_network_message_view_establishment::signature_exists>,
+	c_network_message_counted_array_field<&s_network_message_view_establishment::signature_size, &s_network_message_view_establishment::signature_data>>;
+
+using c_network_message_player_acknowledge_schema = c_network_message_schema<s_network_message_player_acknowledge,
+	c_network_message_integer_field<&s_network_message_player_acknowledge::player_valid_mask, 16>,
+	c_network_message_integer_field<&s_network_message_player_acknowledge::player_in_game_mask, 16>,
+	c_network_message_raw_field<&s_network_message_player_acknowledge::player_identifiers>>;
+
+#define NETWORK_MESSAGE_SCHEMA_DEFINITION(_message_type, _message_type_name, _message, _handler, _schema) \
+	{ _message_type, _message_type_name, sizeof(_message), _schema::k_maximum_size_in_bits, _handler::encode, _handler::decode, _schema::encode, _schema::decode, _schema::randomize }
+
+// `join-request` carries the whole join request with its counts and payload unions,
+// random contents would send the registered handlers off the end of its arrays so it has no schema here
+const s_network_message_schema_definition k_network_message_schema_definitions[]
+{
+	NETWORK_MESSAGE_SCHEMA_DEFINITION(_network_message_peer_connect, "peer-connect", s_network_message_peer_connect, c_network_message_peer_connect, c_network_message_peer_connect_schema),
+	NETWORK_MESSAGE_SCHEMA_DEFINITION(_network_message_join_abort, "join-abort", s_network_message_join_abort, c_network_message_join_abort, c_network_message_join_abort_schema),
+	NETWORK_MESSAGE_SCHEMA_DEFINITION(_network_message_join_refuse, "join-refuse", s_network_message_join_refuse, c_network_message_join_refuse, c_network_message_join_refuse_schema),
+	NETWORK_MESSAGE_SCHEMA_DEFINITION(_network_message_leave_session, "leave-session", s_network_message_leave_session, c_network_message_leave_session, c_network_message_leave_session_schema),
+	NETWORK_MESSAGE_SCHEMA_DEFINITION(_network_message_leave_acknowledge, "leave-acknowledge", s_network_message_leave_acknowledge, c_network_message_leave_acknowledge, c_network_message_leave_acknowledge_schema),
+	NETWORK_MESSAGE_SCHEMA_DEFINITION(_network_message_session_disband, "session-disband", s_network_message_session_disband, c_network_message_session_disband, c_network_message_session_disband_schema),
+	NETWORK_MESSAGE_SCHEMA_DEFINITION(_network_message_session_boot, "session-boot", s_network_message_session_boot, c_network_message_session_boot, c_network_message_session_boot_schema),
+	NETWORK_MESSAGE_SCHEMA_DEFINITION(_network_message_host_decline, "host-decline", s_network_message_host_decline, c_network_message_host_decline, c_network_message_host_decline_schema),
+	NETWORK_MESSAGE_SCHEMA_DEFINITION(_network_message_peer_establish, "peer-establish", s_network_message_peer_establish, c_network_message_peer_establish, c_network_message_peer_establish_schema),
+	NETWORK_MESSAGE_SCHEMA_DEFINITION(_network_message_time_synchronize, "time-synchronize", s_network_message_time_synchronize, c_network_message_time_synchronize, c_network_message_time_synchronize_schema),
+	NETWORK_MESSAGE_SCHEMA_DEFINITION(_network_message_view_establishment, "view-establishment", s_network_message_view_establishment, c_network_message_view_establishment, c_network_message_view_establishment_schema),
+	NETWORK_MESSAGE_SCHEMA_DEFINITION(_network_message_player_acknowledge, "player-acknowledge", s_network_message_player_acknowledge, c_network_message_player_acknowledge, c_network_message_player_acknowledge_schema),
+};
+
+#undef NETWORK_MESSAGE_SCHEMA_DEFINITION
+
+static byte g_network_message_schema_packet_data[k_network_message_schema_packet_size];
+static byte g_network_message_schema_round_trip_packet_data[k_network_message_schema_packet_size];
+
+static bool g_network_message_schema_registered[NUMBEROF(k_network_message_schema_definitions)]{};
+
+const s_network_message_schema_definition* network_message_schema_definition_get(int32 definition_index)
+{
+	if (!VALID_INDEX(definition_index, NUMBEROF(k_network_message_schema_definitions)))
+	{
+		return NULL;
+	}
+
+	return &k_network_message_schema_definitions[definition_index];
+}
+
+int32 network_message_schema_definition_count()
+{
+	return NUMBEROF(k_network_message_schema_definitions);
+}
+
+bool network_message_schema_registered(int32 definition_index)
+{
+	if (!VALID_INDEX(definition_index, NUMBEROF(k_network_message_schema_definitions)))
+	{
+		return false;
+	}
+
+	return g_network_message_schema_registered[definition_index];
+}
+
+// a schema only replaces the handlers of a message type registered in this collection, and only when it passes the wire check
+// and accepts and rejects exactly the random packets the handlers do, a schema that doesn't keeps the handlers and says so once
+void network_message_schemas_register(c_network_message_type_collection* message_collection)
+{
+	ASSERT(message_collection);
+
+	for (int32 definition_index = 0; definition_index < NUMBEROF(k_network_message_schema_definitions); definition_index++)
+	{
+		const s_network_message_schema_definition* definition = &k_network_message_schema_definitions[definition_index];
+		if (g_network_message_schema_registered[definition_index] || !message_collection->message_type_registered(definition->message_type))
+		{
+			continue;
+		}
+
+		int32 mismatch_count = network_message_schema_wire_check(definition_index, 0x6C8E9CF5 + definition_index, k_network_message_schema_wire_check_iterations);
+		if (mismatch_count > 0)
+		{
+			event(_event_warning, "networking:messages:schema: '%s' differs from its handlers on the wire in %d of %d messages, keeping the handlers",
+				definition->message_type_name,
+				mismatch_count,
+				k_network_message_schema_wire_check_iterations);
+			continue;
+		}
+
+		int32 parity_mismatch_count = network_message_schema_parity_check(definition_index, 0x1B873593 + definition_index, k_network_message_schema_parity_check_iterations);
+		if (parity_mismatch_count > 0)
+		{
+			event(_event_warning, "networking:messages:schema: '%s' decodes %d of %d random packets differently from its handlers, keeping the handlers",
+				definition->message_type_name,
+				parity_mismatch_count,
+				k_network_message_schema_parity_check_iterations);
+			continue;
+		}
+
+		message_collection->replace_message_type_functions(definition->message_type, definition->encode_function, definition->decode_function);
+		g_network_message_schema_registered[definition_index] = true;
+	}
+}
+
+// encodes random messages with the registered handlers and with the schema and checks both wrote the same bits,
+// then decodes the handlers' packet with both and checks they read back the same message
+int32 network_message_schema_wire_check(int32 definition_index, uns32 seed, int32 iterations)
+{
+	const s_network_message_schema_definition* definition = network_message_schema_definition_get(definition_index);
+	ASSERT(definition);
+	ASSERT(definition->message_size <= k_network_message_schema_maximum_message_size);
+
+	byte message[k_network_message_schema_maximum_message_size];
+	byte handler_message[k_network_message_schema_maximum_message_size];
+	byte schema_message[k_network_message_schema_maximum_message_size];
+
+	int32 mismatch_count = 0;
+	for (int32 iteration = 0; iteration < iterations; iteration++)
+	{
+		csmemset(message, 0, definition->message_size);
+		definition->randomize_function(message, &seed);
+
+		csmemset(g_network_message_schema_packet_data, 0, sizeof(g_network_message_schema_packet_data));
+		c_bitstream handler_packet(g_network_message_schema_packet_data, sizeof(g_network_message_schema_packet_data));
+		handler_packet.begin_writing(1);
+		definition->handler_encode_function(&handler_packet, definition->message_size, message);
+		int32 handler_size_in_bits = handler_packet.get_space_used_in_bits();
+		handler_packet.finish_writing(NULL);
+
+		csmemset(g_network_message_schema_round_trip_packet_data, 0, sizeof(g_network_message_schema_round_trip_packet_data));
+		c_bitstream schema_packet(g_network_message_schema_round_trip_packet_data, sizeof(g_network_message_schema_round_trip_packet_data));
+		schema_packet.begin_writing(1);
+		definition->encode_function(&schema_packet, definition->message_size, message);
+		int32 schema_size_in_bits = schema_packet.get_space_used_in_bits();
+		schema_packet.finish_writing(NULL);
+
+		if (handler_size_in_bits != schema_size_in_bits
+			|| csmemcmp(g_network_message_schema_packet_data, g_network_message_schema_round_trip_packet_data, (handler_size_in_bits + CHAR_BITS - 1) / CHAR_BITS) != 0)
+		{
+			mismatch_count++;
+			continue;
+		}
+
+		csmemset(handler_message, 0, definition->message_size);
+		handler_packet.begin_reading();
+		bool handler_decoded = definition->handler_decode_function(&handler_packet, definition->message_size, handler_message);
+		handler_packet.finish_reading();
+
+		csmemset(schema_message, 0, definition->message_size);
+		handler_packet.begin_reading();
+		bool schema_decoded = definition->decode_function(&handler_packet, definition->message_size, schema_message);
+		handler_packet.finish_reading();
+
+		if (handler_decoded != schema_decoded || csmemcmp(handler_message, schema_message, definition->message_size) != 0)
+		{
+			mismatch_count++;
+		}
+	}
+
+	return mismatch_count;
+}
+
+// fills the packet buffer with `packet_size` random bytes, the handlers and the schema both read it as untrusted
+static int32 network_message_schema_random_packet(const s_network_message_schema_definition* definition, uns32* seed)
+{
+	int32 maximum_packet_size = MIN((definition->maximum_size_in_bits + CHAR_BITS - 1) / CHAR_BITS + 8, k_network_message_schema_packet_size / 2);
+	int32 packet_size = 1 + int32(network_message_schema_random(seed) % maximum_packet_size);
+	for (int32 byte_index = 0; byte_index < packet_size; byte_index++)
+	{
+		g_network_message_schema_packet_data[byte_index] = byte(network_message_schema_random(seed) >> 24);
+	}
+
+	return packet_size;
+}
+
+static bool network_message_schema_decode_untrusted(c_network_message_type_collection::decode_t* decode_function, int32 packet_size, int32 message_size, void* message)
+{
+	csmemset(message, 0, message_size);
+
+	c_bitstream packet(g_network_message_schema_packet_data, packet_size);
+	packet.data_is_untrusted(true);
+	packet.begin_reading();
+	bool accepted = decode_function(&packet, message_size, message) && !packet.error_occurred();
+	packet.data_is_untrusted(false);
+	if (accepted)
+	{
+		packet.finish_reading();
+	}
+
+	return accepted;
+}
+
+// decodes random packets, out of range values and truncated ones included, with the registered handlers and with the schema,
+// both have to accept and reject the same packets and read the same message out of the ones they accept
+int32 network_message_schema_parity_check(int32 definition_index, uns32 seed, int32 iterations)
+{
+	const s_network_message_schema_definition* definition = network_message_schema_definition_get(definition_index);
+	ASSERT(definition);
+	ASSERT(definition->message_size <= k_network_message_schema_maximum_message_size);
+
+	byte handler_message[k_network_message_schema_maximum_message_size];
+	byte schema_message[k_network_message_schema_maximum_message_size];
+
+	int32 mismatch_count = 0;
+	for (int32 iteration = 0; iteration < iterations; iteration++)
+	{
+		int32 packet_size = network_message_schema_random_packet(definition, &seed);
+		bool handler_accepted = network_message_schema_decode_untrusted(definition->handler_decode_function, packet_size, definition->message_size, handler_message);
+		bool schema_accepted = network_message_schema_decode_untrusted(definition->decode_function, packet_size, definition->message_size, schema_message);
+
+		if (handler_accepted != schema_accepted
+			|| (handler_accepted && csmemcmp(handler_message, schema_message, definition->message_size) != 0))
+		{
+			mismatch_count++;
+		}
+	}
+
+	return mismatch_count;
+}
+
+// encodes with the schema and decodes what it wrote, the decoded message has to match the original byte for byte
+static bool network_message_schema_round_trip(const s_network_message_schema_definition* definition, const void* message, void* decoded_message)
+{
+	c_bitstream packet(g_network_message_schema_round_trip_packet_data, sizeof(g_network_message_schema_round_trip_packet_data));
+	packet.begin_writing(1);
+	definition->encode_function(&packet, definition->message_size, message);
+	packet.finish_writing(NULL);
+
+	csmemset(decoded_message, 0, definition->message_size);
+	packet.begin_reading();
+	bool decoded = definition->decode_function(&packet, definition->message_size, decoded_message);
+	packet.finish_reading();
+
+	return decoded && csmemcmp(message, decoded_message, definition->message_size) == 0;
+}
+
+void network_message_schema_benchmark(int32 definition_index, int32 iterations, s_network_message_schema_benchmark_result* result)
+{
+	const s_network_message_schema_definition* definition = network_message_schema_definition_get(definition_index);
+	ASSERT(definition);
+	ASSERT(definition->message_size <= k_network_message_schema_maximum_message_size);
+	ASSERT(result);
+
+	csmemset(result, 0, sizeof(s_network_message_schema_benchmark_result));
+	result->message_type_name = definition->message_type_name;
+
+	byte message[k_network_message_schema_maximum_message_size];
+	byte decoded_message[k_network_message_schema_maximum_message_size];
+
+	int64 handler_encode_cycles = 0;
+	int64 handler_decode_cycles = 0;
+	int64 schema_encode_cycles = 0;
+	int64 schema_decode_cycles = 0;
+
+	uns32 seed = 0x2545F491 + definition_index;
+	c_stop_watch stop_watch{};
+	for (int32 iteration = 0; iteration < iterations; iteration++)
+	{
+		csmemset(message, 0, definition->message_size);
+		definition->randomize_function(message, &seed);
+
+		c_bitstream packet(g_network_message_schema_packet_data, sizeof(g_network_message_schema_packet_data));
+
+		stop_watch.reset();
+		stop_watch.stop();
+		stop_watch.start();
+		packet.begin_writing(1);
+		definition->handler_encode_function(&packet, definition->message_size, message);
+		result->handler_size_in_bits = packet.get_space_used_in_bits();
+		packet.finish_writing(NULL);
+		handler_encode_cycles += stop_watch.stop();
+
+		stop_watch.reset();
+		stop_watch.stop();
+		stop_watch.start();
+		packet.begin_reading();
+		definition->handler_decode_function(&packet, definition->message_size, decoded_message);
+		packet.finish_reading();
+		handler_decode_cycles += stop_watch.stop();
+
+		stop_watch.reset();
+		stop_watch.stop();
+		stop_watch.start();
+		packet.begin_writing(1);
+		definition->encode_function(&packet, definition->message_size, message);
+		result->schema_size_in_bits = packet.get_space_used_in_bits();
+		packet.finish_writing(NULL);
+		schema_encode_cycles += stop_watch.stop();
+
+		stop_watch.reset();
+		stop_watch.stop();
+		stop_watch.start();
+		packet.begin_reading();
+		bool decoded = definition->decode_function(&packet, definition->message_size, decoded_message);
+		packet.finish_reading();
+		schema_decode_cycles += stop_watch.stop();
+
+		if (!decoded || csmemcmp(message, decoded_message, definition->message_size) != 0)
+		{
+			result->round_trip_mismatch_count++;
+		}
+	}
+
+	result->wire_mismatch_count = network_message_schema_wire_check(definition_index, 0x2545F491 + definition_index, iterations);
+	result->registered = network_message_schema_registered(definition_index);
+
+	result->handler_encode_milliseconds = 1000.0f * c_stop_watch::cycles_to_seconds(handler_encode_cycles);
+	result->handler_decode_milliseconds = 1000.0f * c_stop_watch::cycles_to_seconds(handler_decode_cycles);
+	result->schema_encode_milliseconds = 1000.0f * c_stop_watch::cycles_to_seconds(schema_encode_cycles);
+	result->schema_decode_milliseconds = 1000.0f * c_stop_watch::cycles_to_seconds(schema_decode_cycles);
+}
+
+// decodes random packets of random lengths as untrusted data, anything accepted has to survive a round trip,
+// and nothing may be written outside the message storage
+void network_message_schema_fuzz(int32 definition_index, uns32 seed, int32 iterations, s_network_message_schema_fuzz_result* result)
+{
+	const s_network_message_schema_definition* definition = network_message_schema_definition_get(definition_index);
+	ASSERT(definition);
+	ASSERT(definition->message_size <= k_network_message_schema_maximum_message_size);
+	ASSERT(result);
+
+	csmemset(result, 0, sizeof(s_network_message_schema_fuzz_result));
+	result->message_type_name = definition->message_type_name;
+
+	byte storage[k_network_message_schema_guard_size + k_network_message_schema_maximum_message_size + k_network_message_schema_guard_size];
+	byte* message = storage + k_network_message_schema_guard_size;
+	byte decoded_message[k_network_message_schema_maximum_message_size];
+
+	for (int32 iteration = 0; iteration < iterations; iteration++)
+	{
+		// only the first `packet_size` bytes are handed to the bitstream, the rest of the buffer is there to catch reads past its end
+		int32 packet_size = network_message_schema_random_packet(definition, &seed);
+
+		csmemset(storage, k_network_message_schema_guard_value, sizeof(storage));
+		csmemset(message, 0, definition->message_size);
+
+		c_bitstream packet(g_network_message_schema_packet_data, packet_size);
+		packet.data_is_untrusted(true);
+		packet.begin_reading();
+		bool accepted = definition->decode_function(&packet, definition->message_size, message);
+		packet.data_is_untrusted(false);
+
+		for (int32 byte_index = 0; byte_index < int32(sizeof(storage)); byte_index++)
+		{
+			if (byte_index >= k_network_message_schema_guard_size && byte_index < k_network_message_schema_guard_size + definition->message_size)
+			{
+				continue;
+			}
+
+			if (storage[byte_index] != k_network_message_schema_guard_value)
+			{
+				result->overrun_count++;
+				break;
+			}
+		}
+
+		if (!accepted)
+		{
+			result->rejected_count++;
+			continue;
+		}
+
+		packet.finish_reading();
+		result->accepted_count++;
+
+		if (!network_message_schema_round_trip(definition, message, decoded_message))
+		{
+			result->round_trip_mismatch_count++;
+		}
+	}
+
+	result->parity_mismatch_count = network_message_schema_parity_check(definition_index, seed, iterations);
+	result->registered = network_message_schema_registered(definition_index);
+}
+
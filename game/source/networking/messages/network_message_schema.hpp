@@ -0,0 +1,371 @@
+#pragma once
+
+#include "cseries/cseries.hpp"
+#include "memory/bitstream.hpp"
+#include "networking/messages/network_message_type_collection.hpp"
+
+#include <type_traits>
+
+// declarative layouts for network message structs,
+// every field is a type carrying its member pointer, width and limits as template parameters so a schema's `encode` and `decode`
+// compile down to straight bitstream reads and writes, with no debug strings and nothing looked up at runtime,
+// `decode` treats the packet as untrusted and fails on the first value outside the limits its schema declares,
+// both have the `encode_t` and `decode_t` signatures so a schema can stand in for the handlers a message type is registered with,
+// which it only does once it has written and read exactly the same bits as those handlers for every message of the wire check
+// and accepted and rejected exactly the same random packets as they did, otherwise it's only used by the benchmark and fuzz commands
+
+constexpr int32 network_message_schema_bits_for_value(uns32 maximum_value)
+{
+	int32 size_in_bits = 1;
+	while (size_in_bits < LONG_BITS && (maximum_value >> size_in_bits) != 0)
+	{
+		size_in_bits++;
+	}
+	return size_in_bits;
+}
+
+inline uns32 network_message_schema_random(uns32* seed)
+{
+	*seed = *seed * 1664525 + 1013904223;
+	return *seed;
+}
+
+template<typename t_member_pointer>
+struct s_network_message_member;
+
+template<typename t_message, typename t_field>
+struct s_network_message_member<t_field t_message::*>
+{
+	using message_type = t_message;
+	using field_type = t_field;
+};
+
+// integers, enums and bools, `k_maximum_value` below `MASK(k_size_in_bits)` is checked when decoding
+template<auto k_member, int32 k_size_in_bits, uns32 k_maximum_value = MASK(k_size_in_bits)>
+class c_network_message_integer_field
+{
+public:
+	using message_type = typename s_network_message_member<decltype(k_member)>::message_type;
+	using field_type = typename s_network_message_member<decltype(k_member)>::field_type;
+
+	static_assert(k_size_in_bits > 0 && k_size_in_bits <= LONG_BITS);
+	static_assert(k_maximum_value <= MASK(k_size_in_bits));
+
+	static int32 const k_maximum_size_in_bits = k_size_in_bits;
+
+	static void encode(c_bitstream* packet, const message_type* message)
+	{
+		uns32 value = static_cast<uns32>(message->*k_member);
+		ASSERT(value <= k_maximum_value);
+
+		packet->write_dword_internal(value, k_size_in_bits);
+	}
+
+	static bool decode(c_bitstream* packet, message_type* message)
+	{
+		uns32 value = packet->read_dword_internal(k_size_in_bits);
+		if constexpr (k_maximum_value < MASK(k_size_in_bits))
+		{
+			if (value > k_maximum_value)
+			{
+				return false;
+			}
+		}
+
+		message->*k_member = static_cast<field_type>(value);
+		return true;
+	}
+
+	static void randomize(message_type* message, uns32* seed)
+	{
+		uns32 value = network_message_schema_random(seed);
+		if constexpr (k_maximum_value < MASK(LONG_BITS))
+		{
+			value %= k_maximum_value + 1;
+		}
+
+		message->*k_member = static_cast<field_type>(value);
+	}
+};
+
+template<auto k_member>
+using c_network_message_bool_field = c_network_message_integer_field<k_member, 1>;
+
+template<auto k_member, int32 k_count>
+using c_network_message_enum_field = c_network_message_integer_field<k_member, network_message_schema_bits_for_value(k_count - 1), k_count - 1>;
+
+template<auto k_member, int32 k_size_in_bits = QWORD_BITS>
+class c_network_message_qword_field
+{
+public:
+	using message_type = typename s_network_message_member<decltype(k_member)>::message_type;
+
+	static_assert(k_size_in_bits > 0 && k_size_in_bits <= QWORD_BITS);
+
+	static int32 const k_maximum_size_in_bits = k_size_in_bits;
+
+	static void encode(c_bitstream* packet, const message_type* message)
+	{
+		packet->write_qword_internal(message->*k_member, k_size_in_bits);
+	}
+
+	static bool decode(c_bitstream* packet, message_type* message)
+	{
+		message->*k_member = packet->read_qword_internal(k_size_in_bits);
+		return true;
+	}
+
+	static void randomize(message_type* message, uns32* seed)
+	{
+		uns64 value = (uns64(network_message_schema_random(seed)) << 32) | network_message_schema_random(seed);
+		message->*k_member = k_size_in_bits == QWORD_BITS ? value : value & ((1ULL << k_size_in_bits) - 1);
+	}
+};
+
+// identifiers, addresses and anything else copied bit for bit, arrays of them included
+template<auto k_member>
+class c_network_message_raw_field
+{
+public:
+	using message_type = typename s_network_message_member<decltype(k_member)>::message_type;
+	using field_type = typename s_network_message_member<decltype(k_member)>::field_type;
+
+	static int32 const k_maximum_size_in_bits = SIZEOF_BITS(field_type);
+
+	static void encode(c_bitstream* packet, const message_type* message)
+	{
+		packet->write_bits_internal(reinterpret_cast<const byte*>(&(message->*k_member)), k_maximum_size_in_bits);
+	}
+
+	static bool decode(c_bitstream* packet, message_type* message)
+	{
+		packet->read_bits_internal(reinterpret_cast<byte*>(&(message->*k_member)), k_maximum_size_in_bits);
+		return true;
+	}
+
+	static void randomize(message_type* message, uns32* seed)
+	{
+		byte* data = reinterpret_cast<byte*>(&(message->*k_member));
+		for (int32 byte_index = 0; byte_index < int32(sizeof(field_type)); byte_index++)
+		{
+			data[byte_index] = byte(network_message_schema_random(seed) >> 24);
+		}
+	}
+};
+
+// reals quantized to `k_size_in_bits` between `k_minimum_value` and `k_maximum_value`, both ends exact
+template<auto k_member, real32 k_minimum_value, real32 k_maximum_value, int32 k_size_in_bits>
+class c_network_message_quantized_real_field
+{
+public:
+	using message_type = typename s_network_message_member<decltype(k_member)>::message_type;
+
+	static_assert(k_minimum_value < k_maximum_value);
+	static_assert(k_size_in_bits > 1 && k_size_in_bits < LONG_BITS);
+
+	static int32 const k_maximum_size_in_bits = k_size_in_bits;
+	static int32 const k_step_count = MASK(k_size_in_bits);
+
+	static void encode(c_bitstream* packet, const message_type* message)
+	{
+		real32 value = PIN(message->*k_member, k_minimum_value, k_maximum_value);
+		int32 step = int32((value - k_minimum_value) * (k_step_count / (k_maximum_value - k_minimum_value)) + 0.5f);
+		packet->write_dword_internal(uns32(PIN(step, 0, k_step_count)), k_size_in_bits);
+	}
+
+	static bool decode(c_bitstream* packet, message_type* message)
+	{
+		uns32 step = packet->read_dword_internal(k_size_in_bits);
+		message->*k_member = step == uns32(k_step_count) ? k_maximum_value : k_minimum_value + step * ((k_maximum_value - k_minimum_value) / k_step_count);
+		return true;
+	}
+
+	static void randomize(message_type* message, uns32* seed)
+	{
+		uns32 step = network_message_schema_random(seed) % (k_step_count + 1);
+		message->*k_member = step == uns32(k_step_count) ? k_maximum_value : k_minimum_value + step * ((k_maximum_value - k_minimum_value) / k_step_count);
+	}
+};
+
+// fixed length arrays of integers
+template<auto k_member, int32 k_element_size_in_bits>
+class c_network_message_array_field
+{
+public:
+	using message_type = typename s_network_message_member<decltype(k_member)>::message_type;
+	using field_type = typename s_network_message_member<decltype(k_member)>::field_type;
+	using element_type = std::remove_extent_t<field_type>;
+
+	static_assert(std::rank_v<field_type> == 1);
+	static_assert(k_element_size_in_bits > 0 && k_element_size_in_bits <= LONG_BITS);
+
+	static int32 const k_element_count = std::extent_v<field_type>;
+	static int32 const k_maximum_size_in_bits = k_element_count * k_element_size_in_bits;
+
+	static void encode(c_bitstream* packet, const message_type* message)
+	{
+		for (int32 element_index = 0; element_index < k_element_count; element_index++)
+		{
+			packet->write_dword_internal(static_cast<uns32>((message->*k_member)[element_index]), k_element_size_in_bits);
+		}
+	}
+
+	static bool decode(c_bitstream* packet, message_type* message)
+	{
+		for (int32 element_index = 0; element_index < k_element_count; element_index++)
+		{
+			(message->*k_member)[element_index] = static_cast<element_type>(packet->read_dword_internal(k_element_size_in_bits));
+		}
+		return true;
+	}
+
+	static void randomize(message_type* message, uns32* seed)
+	{
+		for (int32 element_index = 0; element_index < k_element_count; element_index++)
+		{
+			(message->*k_member)[element_index] = static_cast<element_type>(network_message_schema_random(seed) & MASK(k_element_size_in_bits));
+		}
+	}
+};
+
+// variable length arrays of bytes whose length lives in `k_count_member`, a length past the end of the array fails to decode
+template<auto k_count_member, auto k_member>
+class c_network_message_counted_array_field
+{
+public:
+	using message_type = typename s_network_message_member<decltype(k_member)>::message_type;
+	using count_type = typename s_network_message_member<decltype(k_count_member)>::field_type;
+	using field_type = typename s_network_message_member<decltype(k_member)>::field_type;
+
+	static_assert(std::is_same_v<message_type, typename s_network_message_member<decltype(k_count_member)>::message_type>);
+	static_assert(std::rank_v<field_type> == 1 && sizeof(std::remove_extent_t<field_type>) == sizeof(byte));
+
+	static int32 const k_element_count = std::extent_v<field_type>;
+	static int32 const k_count_size_in_bits = network_message_schema_bits_for_value(k_element_count);
+	static int32 const k_maximum_size_in_bits = k_count_size_in_bits + k_element_count * CHAR_BITS;
+
+	static void encode(c_bitstream* packet, const message_type* message)
+	{
+		int32 count = static_cast<int32>(message->*k_count_member);
+		ASSERT(VALID_COUNT(count, k_element_count));
+
+		packet->write_dword_internal(uns32(count), k_count_size_in_bits);
+		packet->write_bits_internal(reinterpret_cast<const byte*>(message->*k_member), count * CHAR_BITS);
+	}
+
+	static bool decode(c_bitstream* packet, message_type* message)
+	{
+		int32 count = int32(packet->read_dword_internal(k_count_size_in_bits));
+		if (!VALID_COUNT(count, k_element_count))
+		{
+			return false;
+		}
+
+		message->*k_count_member = static_cast<count_type>(count);
+		packet->read_bits_internal(reinterpret_cast<byte*>(message->*k_member), count * CHAR_BITS);
+		csmemset(reinterpret_cast<byte*>(message->*k_member) + count, 0, k_element_count - count);
+		return true;
+	}
+
+	static void randomize(message_type* message, uns32* seed)
+	{
+		int32 count = int32(network_message_schema_random(seed) % (k_element_count + 1));
+		message->*k_count_member = static_cast<count_type>(count);
+
+		byte* data = reinterpret_cast<byte*>(message->*k_member);
+		for (int32 byte_index = 0; byte_index < k_element_count; byte_index++)
+		{
+			data[byte_index] = byte_index < count ? byte(network_message_schema_random(seed) >> 24) : 0;
+		}
+	}
+};
+
+template<typename t_message, typename... t_fields>
+class c_network_message_schema
+{
+public:
+	static_assert((std::is_same_v<t_message, typename t_fields::message_type> && ...));
+
+	static int32 const k_maximum_size_in_bits = (t_fields::k_maximum_size_in_bits + ... + 0);
+
+	static void __cdecl encode(c_bitstream* packet, int32 message_storage_size, const void* message_storage)
+	{
+		ASSERT(message_storage_size == sizeof(t_message));
+
+		const t_message* message = static_cast<const t_message*>(message_storage);
+		(t_fields::encode(packet, message), ...);
+	}
+
+	static bool __cdecl decode(c_bitstream* packet, int32 message_storage_size, void* message_storage)
+	{
+		if (message_storage_size != sizeof(t_message))
+		{
+			return false;
+		}
+
+		// the fold stops at the first field that fails, whatever follows it can't be trusted
+		t_message* message = static_cast<t_message*>(message_storage);
+		return (t_fields::decode(packet, message) && ...) && !packet->error_occurred();
+	}
+
+	static void __cdecl randomize(void* message_storage, uns32* seed)
+	{
+		t_message* message = static_cast<t_message*>(message_storage);
+		(t_fields::randomize(message, seed), ...);
+	}
+};
+
+struct s_network_message_schema_definition
+{
+	using randomize_t = void __cdecl(void* message_storage, uns32* seed);
+
+	e_network_message_type message_type;
+	const char* message_type_name;
+	int32 message_size;
+	int32 maximum_size_in_bits;
+
+	// the handlers the message type is registered with
+	c_network_message_type_collection::encode_t* handler_encode_function;
+	c_network_message_type_collection::decode_t* handler_decode_function;
+
+	c_network_message_type_collection::encode_t* encode_function;
+	c_network_message_type_collection::decode_t* decode_function;
+	randomize_t* randomize_function;
+};
+
+struct s_network_message_schema_benchmark_result
+{
+	const char* message_type_name;
+	int32 handler_size_in_bits;
+	int32 schema_size_in_bits;
+	real32 handler_encode_milliseconds;
+	real32 handler_decode_milliseconds;
+	real32 schema_encode_milliseconds;
+	real32 schema_decode_milliseconds;
+	int32 round_trip_mismatch_count;
+	int32 wire_mismatch_count;
+	bool registered;
+};
+
+struct s_network_message_schema_fuzz_result
+{
+	const char* message_type_name;
+	int32 accepted_count;
+	int32 rejected_count;
+	int32 round_trip_mismatch_count;
+	int32 overrun_count;
+
+	// random packets the registered handlers accepted or rejected differently, or read a different message out of
+	int32 parity_mismatch_count;
+	bool registered;
+};
+
+extern const s_network_message_schema_definition* network_message_schema_definition_get(int32 definition_index);
+extern int32 network_message_schema_definition_count();
+extern void network_message_schema_benchmark(int32 definition_index, int32 iterations, s_network_message_schema_benchmark_result* result);
+extern bool network_message_schema_registered(int32 definition_index);
+extern void network_message_schemas_register(c_network_message_type_collection* message_collection);
+extern int32 network_message_schema_wire_check(int32 definition_index, uns32 seed, int32 iterations);
+extern int32 network_message_schema_parity_check(int32 definition_index, uns32 seed, int32 iterations);
+extern void network_message_schema_fuzz(int32 definition_index, uns32 seed, int32 iterations, s_network_message_schema_fuzz_result* result);
+
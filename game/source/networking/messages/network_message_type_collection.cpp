@@ -228,3 +228,23 @@ void __cdecl c_network_message_type_collection::register_message_type(
 	type->initialized = true;
 }
 
+bool __cdecl c_network_message_type_collection::message_type_registered(e_network_message_type message_type) const
+{
+	ASSERT(message_type >= 0 && message_type < k_network_message_type_count);
+
+	return m_message_types[message_type].initialized;
+}
+
+void __cdecl c_network_message_type_collection::replace_message_type_functions(e_network_message_type message_type, encode_t* encode_function, decode_t* decode_function)
+{
+	ASSERT(message_type >= 0 && message_type < k_network_message_type_count);
+	ASSERT(encode_function);
+	ASSERT(decode_function);
+
+	s_network_message_type* type = &m_message_types[message_type];
+	ASSERT(type->initialized);
+
+	type->encode_function = encode_function;
+	type->decode_function = decode_function;
+}
+
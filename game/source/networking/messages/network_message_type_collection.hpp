@@ -69,6 +69,11 @@ public:
 		dispose_t* dispose_function
 	);
 
+	bool __cdecl message_type_registered(e_network_message_type message_type) const;
+
+	// swaps the encode and decode of a registered message type for ones that read and write the same bits
+	void __cdecl replace_message_type_functions(e_network_message_type message_type, encode_t* encode_function, decode_t* decode_function);
+
 protected:
 	s_network_message_type m_message_types[k_network_message_type_count];
 };
@@ -0,0 +1,62 @@
+#include "networking/messages/network_messages_determinism.hpp"
+
+#include "cseries/cseries.hpp"
+#include "memory/bitstream.hpp"
+#include "networking/messages/network_message_type_collection.hpp"
+
+bool c_network_message_determinism_verification::decode(c_bitstream* packet, int32 message_storage_size, void* message_storage)
+{
+	ASSERT(message_storage_size == sizeof(s_network_message_determinism_verification));
+
+	s_network_message_determinism_verification* message = static_cast<s_network_message_determinism_verification*>(message_storage);
+
+	packet->read_raw_data("session-id", &message->session_id, 128);
+	message->game_time = packet->read_signed_integer("game-time", 32);
+
+	s_determinism_verification* verification = &message->verification;
+	verification->unchanged_field_mask = packet->read_integer("unchanged-field-mask", 32);
+	verification->game_state_check = int32(packet->read_integer("game-state-check", 32));
+	verification->cheats_check = int32(packet->read_integer("cheats-check", 32));
+	for (int32 consumer_index = 0; consumer_index < verification->consumer_check.get_count(); consumer_index++)
+	{
+		verification->consumer_check[consumer_index] = int32(packet->read_integer("consumer-check", 32));
+	}
+
+	return !packet->error_occurred() && message->game_time >= 0;
+}
+
+void c_network_message_determinism_verification::encode(c_bitstream* packet, int32 message_storage_size, const void* message_storage)
+{
+	ASSERT(message_storage_size == sizeof(s_network_message_determinism_verification));
+
+	const s_network_message_determinism_verification* message = (const s_network_message_determinism_verification*)message_storage;
+
+	packet->write_raw_data("session-id", &message->session_id, 128);
+	packet->write_signed_integer("game-time", message->game_time, 32);
+
+	const s_determinism_verification* verification = &message->verification;
+	packet->write_integer("unchanged-field-mask", verification->unchanged_field_mask, 32);
+	packet->write_integer("game-state-check", uns32(verification->game_state_check), 32);
+	packet->write_integer("cheats-check", uns32(verification->cheats_check), 32);
+	for (int32 consumer_index = 0; consumer_index < verification->consumer_check.get_count(); consumer_index++)
+	{
+		packet->write_integer("consumer-check", uns32(verification->consumer_check[consumer_index]), 32);
+	}
+}
+
+void __cdecl network_message_types_register_determinism(c_network_message_type_collection* message_collection)
+{
+	ASSERT(message_collection);
+
+	message_collection->register_message_type(
+		_custom_network_message_determinism_verification,
+		"determinism verification",
+		0,
+		sizeof(s_network_message_determinism_verification),
+		sizeof(s_network_message_determinism_verification),
+		c_network_message_determinism_verification::encode,
+		c_network_message_determinism_verification::decode,
+		nullptr,
+		nullptr);
+}
+
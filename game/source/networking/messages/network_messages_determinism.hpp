@@ -0,0 +1,26 @@
+#pragma once
+
+#include "networking/transport/transport_security.hpp"
+#include "saved_games/determinism_debug_manager.hpp"
+
+// sent by a client with game state hashing on to the host of its session for every tick it has a verification of, the
+// host compares it against its own verification of the same tick
+struct s_network_message_determinism_verification
+{
+	s_transport_secure_identifier session_id;
+	int32 game_time;
+	s_determinism_verification verification;
+};
+static_assert(sizeof(s_network_message_determinism_verification) == 0x98);
+
+class c_bitstream;
+class c_network_message_determinism_verification
+{
+public:
+	static void encode(c_bitstream* packet, int32 message_storage_size, const void* message_storage);
+	static bool decode(c_bitstream* packet, int32 message_storage_size, void* message_storage);
+};
+
+class c_network_message_type_collection;
+extern void __cdecl network_message_types_register_determinism(c_network_message_type_collection* message_collection);
+
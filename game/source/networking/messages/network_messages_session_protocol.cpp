@@ -1,6 +1,7 @@
 #include "networking/messages/network_messages_session_protocol.hpp"
 
 #include "memory/module.hpp"
+#include "networking/messages/network_message_schema.hpp"
 #include "networking/messages/network_message_type_collection.hpp"
 
 HOOK_DECLARE(0x004DD5D0, network_message_types_register_session_protocol);
@@ -296,5 +297,7 @@ void __cdecl network_message_types_register_session_protocol(c_network_message_t
 		c_network_message_time_synchronize::decode,
 		c_network_message_time_synchronize::compare,
 		c_network_message_time_synchronize::dispose);
+
+	network_message_schemas_register(message_collection);
 }
 
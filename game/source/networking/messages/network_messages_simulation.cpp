@@ -1,6 +1,7 @@
 #include "networking/messages/network_messages_simulation.hpp"
 
 #include "memory/module.hpp"
+#include "networking/messages/network_message_schema.hpp"
 #include "networking/messages/network_message_type_collection.hpp"
 
 HOOK_DECLARE(0x004E0410, network_message_types_register_simulation);
@@ -52,5 +53,7 @@ void __cdecl network_message_types_register_simulation(c_network_message_type_co
 		c_network_message_player_acknowledge::decode,
 		nullptr,
 		nullptr);
+
+	network_message_schemas_register(message_collection);
 }
 
@@ -29,6 +29,7 @@
 #include "networking/logic/storage/network_storage_manifest.hpp"
 #include "networking/logic/storage/network_storage_queue.hpp"
 #include "networking/messages/network_messages_connect.hpp"
+#include "networking/messages/network_messages_determinism.hpp"
 #include "networking/messages/network_messages_out_of_band.hpp"
 #include "networking/messages/network_messages_session_membership.hpp"
 #include "networking/messages/network_messages_session_parameters.hpp"
@@ -281,6 +282,7 @@ void __cdecl network_initialize()
 	network_message_types_register_simulation_synchronous(g_network_message_types);
 	network_message_types_register_simulation_distributed(g_network_message_types);
 	network_message_types_register_text_chat(g_network_message_types);
+	network_message_types_register_determinism(g_network_message_types);
 	network_message_types_register_test(g_network_message_types);
 
 	success |=
@@ -6,6 +6,7 @@
 #include "memory/module.hpp"
 #include "networking/delivery/network_channel.hpp"
 #include "networking/messages/network_message_type_collection.hpp"
+#include "networking/messages/network_messages_determinism.hpp"
 #include "networking/messages/network_messages_session_membership.hpp"
 #include "networking/network_time.hpp"
 #include "networking/session/network_managed_session.hpp"
@@ -776,6 +777,33 @@ bool c_network_session::peer_request_player_desired_properties_update(int32 play
 	return true;
 }
 
+// custom function, hands the verification of a tick to the host to compare against its own
+bool c_network_session::peer_send_determinism_verification(int32 game_time, const s_determinism_verification* verification)
+{
+	ASSERT(verification);
+
+	if (!established() || is_host())
+	{
+		return false;
+	}
+
+	int32 observer_channel_index = m_session_membership.m_local_peer_state[m_session_membership.host_peer_index()].channel_index;
+	if (observer_channel_index == NONE)
+	{
+		return false;
+	}
+
+	s_network_message_determinism_verification message{};
+	csmemset(&message, 0, sizeof(s_network_message_determinism_verification));
+
+	managed_session_get_id(m_managed_session_index, &message.session_id);
+	message.game_time = game_time;
+	message.verification = *verification;
+
+	m_observer->observer_channel_send_message(m_session_index, observer_channel_index, false, _custom_network_message_determinism_verification, sizeof(message), &message);
+	return true;
+}
+
 //.text:0045DEB0 ; bool c_network_session::peer_request_player_remove(int32)
 //.text:0045DFE0 ; bool c_network_session::peer_request_properties_update(const s_transport_secure_address*, const s_network_session_peer_properties*)
 //.text:0045E110 ; bool c_network_session::player_is_member(const s_player_identifier*) const
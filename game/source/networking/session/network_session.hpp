@@ -41,6 +41,7 @@ struct s_network_message_player_remove;
 struct s_network_message_session_boot;
 struct s_network_message_session_disband;
 struct s_network_message_time_synchronize;
+struct s_determinism_verification;
 
 class c_network_message_gateway;
 class c_network_observer;
@@ -103,6 +104,7 @@ public:
 	void leave_session();
 	bool membership_is_locked() const;
 	bool peer_request_player_desired_properties_update(int32 player_update_number, e_controller_index controller_index, const s_player_configuration_from_client* player_data_from_client, uns32 player_voice);
+	bool peer_send_determinism_verification(int32 game_time, const s_determinism_verification* verification);
 	e_network_session_class session_class() const;
 
 private:
@@ -1,9 +1,13 @@
 #include "networking/tools/remote_command.hpp"
 
 #include "ai/ai.hpp"
+#include "animations/animation_node_matrices.hpp"
+#include "cache/cache_file_tag_resource_runtime.hpp"
+#include "cache/cache_file_tag_resource_trace.hpp"
 #include "cache/cache_files.hpp"
 #include "camera/observer.hpp"
 #include "cseries/cseries.hpp"
+#include "cseries/cseries_event_logs.hpp"
 #include "cseries/cseries_events.hpp"
 #include "editor/editor_stubs.hpp"
 #include "game/cheats.hpp"
@@ -17,6 +21,7 @@
 #include "interface/c_controller.hpp"
 #include "interface/debug_menu/debug_menu_main.hpp"
 #include "interface/gui_screens/game_browser/gui_game_browser.hpp"
+#include "interface/gui_widget_cache.hpp"
 #include "interface/user_interface_hs.hpp"
 #include "interface/user_interface_networking.hpp"
 #include "interface/user_interface_text.hpp"
@@ -27,13 +32,19 @@
 #include "main/main.hpp"
 #include "main/main_game.hpp"
 #include "main/main_game_launch.hpp"
+#include "main/main_headless.hpp"
+#include "memory/allocation_audit.hpp"
 #include "memory/data_packet_groups.hpp"
 #include "memory/data_packets.hpp"
 #include "memory/module.hpp"
 #include "memory/thread_local.hpp"
 #include "networking/logic/network_broadcast_search.hpp"
 #include "networking/logic/network_life_cycle.hpp"
+#include "networking/logic/network_search.hpp"
+#include "networking/logic/network_search_summary.hpp"
 #include "networking/logic/network_session_interface.hpp"
+#include "networking/messages/network_message_schema.hpp"
+#include "networking/messages/network_messages_determinism.hpp"
 #include "networking/messages/network_messages_text_chat.hpp"
 #include "networking/network_configuration.hpp"
 #include "networking/network_globals.hpp"
@@ -46,10 +57,17 @@
 #include "networking/transport/transport.hpp"
 #include "networking/transport/transport_endpoint_winsock.hpp"
 #include "objects/multiplayer_game_objects.hpp"
+#include "objects/object_scheduler.hpp"
+#include "profiler/profiler_stopwatch.hpp"
+#include "render/render_software_occlusion.hpp"
+#include "saved_games/determinism_debug_manager.hpp"
+#include "saved_games/game_state_telemetry.hpp"
 #include "saved_games/saved_film_manager.hpp"
 #include "shell/shell.hpp"
+#include "simulation/simulation_replay_benchmark.hpp"
 #include "sound/game_sound.hpp"
 #include "test/test_functions.hpp"
+#include "text/font_glyph_cache.hpp"
 #include "text/font_loading.hpp"
 #include "units/bipeds.hpp"
 #include "xbox/xnet.hpp"
@@ -891,3 +909,923 @@ callback_result_t controller_set_tertiary_change_color_callback(const void* user
 	return result;
 }
 
+
+callback_result_t event_logs_benchmark_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 iterations = (int32)atol(tokens[1]->get_string());
+	if (iterations <= 0)
+	{
+		iterations = 10000;
+	}
+
+	real32 calls_per_second_synchronous = 0.0f;
+	real32 calls_per_second_writer = 0.0f;
+	int32 overflow_count = 0;
+	event_logs_benchmark(iterations, &calls_per_second_synchronous, &calls_per_second_writer, &overflow_count);
+
+	result.append_print_line("iterations: %d", iterations);
+	result.append_print_line("synchronous: %.0f calls/s", calls_per_second_synchronous);
+	result.append_print_line("writer: %.0f calls/s (%d written synchronously)", calls_per_second_writer, overflow_count);
+	if (!g_event_log_record_queue.writer_running.peek())
+	{
+		result.append_print_line("writer thread is not running, both passes wrote synchronously");
+	}
+
+	return result;
+}
+
+callback_result_t tag_resources_zone_switches_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 mode = (int32)atol(tokens[1]->get_string());
+	if (mode == 0 || mode == 1)
+	{
+		g_tag_resource_zone_switch_globals.staged_switching_enabled = mode == 1;
+	}
+
+	result.append_print_line("mode: %s, switches: %d, progress: %.0f%%",
+		g_tag_resource_zone_switch_globals.staged_switching_enabled ? "staged" : "blocking",
+		g_tag_resource_zone_switch_globals.switch_count,
+		100.0f * tag_resources_zone_switch_progress());
+
+	for (int32 history_index = 0; history_index < k_tag_resource_zone_switch_history_count; history_index++)
+	{
+		const s_tag_resource_zone_switch* zone_switch = tag_resources_zone_switch_get(history_index);
+		if (!zone_switch)
+		{
+			break;
+		}
+
+		result.append_print_line("%d: bsps 0x%08X, +%d -%d resources, required %.3f ms, pending %.3f ms%s%s",
+			g_tag_resource_zone_switch_globals.switch_count - 1 - history_index,
+			zone_switch->zone_state.active_bsp_mask,
+			zone_switch->resources_added,
+			zone_switch->resources_removed,
+			1000.0f * c_stop_watch::cycles_to_seconds(zone_switch->required_stall_cycles),
+			1000.0f * c_stop_watch::cycles_to_seconds(zone_switch->pending_stall_cycles),
+			zone_switch->staged ? ", staged" : "",
+			zone_switch->complete ? "" : ", streaming");
+	}
+
+	return result;
+}
+
+callback_result_t tag_resource_trace_start_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	tag_resource_trace_start();
+	if (!g_tag_resource_trace_globals.recording)
+	{
+		result.append_print_line("failed, see the event log");
+	}
+
+	return result;
+}
+
+callback_result_t tag_resource_trace_stop_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	const char* filename = tokens[1]->get_string();
+	if (!tag_resource_trace_stop(filename))
+	{
+		result.append_print_line("failed, see the event log");
+		return result;
+	}
+
+	result.append_print_line("wrote %d records for '%s' to '%s'",
+		MIN(g_tag_resource_trace_globals.record_count.peek(), k_maximum_tag_resource_trace_records),
+		g_tag_resource_trace_globals.scenario_path.get_string(),
+		filename);
+
+	return result;
+}
+
+callback_result_t tag_resource_prefetch_build_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	c_static_string<1024> trace_list = tokens[2]->get_string();
+	const char* trace_filenames[k_maximum_tag_resource_prefetch_traces]{};
+	int32 trace_count = 0;
+
+	char* trace_filename = trace_list.get_buffer();
+	while (*trace_filename && trace_count < k_maximum_tag_resource_prefetch_traces)
+	{
+		trace_filenames[trace_count++] = trace_filename;
+
+		char* separator = strchr(trace_filename, ',');
+		if (!separator)
+		{
+			break;
+		}
+
+		*separator = 0;
+		trace_filename = separator + 1;
+	}
+
+	if (!tag_resource_prefetch_statistics_build(tokens[1]->get_string(), trace_filenames, trace_count))
+	{
+		result.append_print_line("failed, see the event log");
+		return result;
+	}
+
+	s_tag_resource_prefetch_statistics statistics{};
+	if (tag_resource_prefetch_statistics_load(tokens[1]->get_string(), &statistics))
+	{
+		result.append_print_line("'%s': %d traces, %d resource entries, %d transitions",
+			statistics.header.scenario_path.get_string(),
+			statistics.header.trace_count,
+			statistics.header.resource_entry_count,
+			statistics.header.transition_count);
+		tag_resource_prefetch_statistics_dispose(&statistics);
+	}
+
+	return result;
+}
+
+callback_result_t tag_resource_prefetch_replay_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	s_tag_resource_prefetch_replay_results results{};
+	if (!tag_resource_prefetch_replay(tokens[1]->get_string(), tokens[2]->get_string(), &results))
+	{
+		result.append_print_line("failed, see the event log");
+		return result;
+	}
+
+	real32 first_touch_count = (real32)MAX(1, results.first_touch_count);
+	result.append_print_line("first touches: %d, cluster changes: %d", results.first_touch_count, results.cluster_change_count);
+	result.append_print_line("zone set misses: %d (%.2f%%)", results.baseline_miss_count, 100.0f * results.baseline_miss_count / first_touch_count);
+	result.append_print_line("predicted misses: %d (%.2f%%), %d of them late", results.predicted_miss_count, 100.0f * results.predicted_miss_count / first_touch_count, results.late_prefetch_count);
+	result.append_print_line("prefetches: %d, unused: %d", results.prefetch_count, results.unused_prefetch_count);
+
+	return result;
+}
+
+callback_result_t tag_resource_prefetch_start_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	if (!tag_resource_prefetch_start(tokens[1]->get_string()))
+	{
+		result.append_print_line("failed, see the event log");
+		return result;
+	}
+
+	result.append_print_line("predicting for '%s' from %d traces, nothing is requested from the resource manager",
+		g_tag_resource_prefetch_globals.statistics.header.scenario_path.get_string(),
+		g_tag_resource_prefetch_globals.statistics.header.trace_count);
+
+	return result;
+}
+
+callback_result_t tag_resource_prefetch_stop_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	result.append_print_line("predicted missing: %d, made active later: %d, already active or pending: %d",
+		g_tag_resource_prefetch_globals.missing_count,
+		g_tag_resource_prefetch_globals.later_active_count,
+		g_tag_resource_prefetch_globals.resident_count);
+	tag_resource_prefetch_stop();
+
+	return result;
+}
+
+callback_result_t font_glyph_cache_benchmark_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 iterations = (int32)atol(tokens[1]->get_string());
+	if (iterations > 0)
+	{
+		font_glyph_cache_benchmark_start(iterations);
+		result.append_print_line("running %d iterations on the next frame", iterations);
+	}
+
+	const s_font_glyph_cache_benchmark_results* results = &g_font_glyph_cache_globals.benchmark_results;
+	if (results->iterations > 0)
+	{
+		result.append_print_line("last run: %d strings, %d characters (%d not resident), %d iterations", results->string_count, results->character_count, results->unresolved_count, results->iterations);
+		result.append_print_line("draw_string: %.3f ms uncached, %.3f ms cached", results->uncached_draw_milliseconds, results->cached_draw_milliseconds);
+		result.append_print_line("resolve: %.3f ms per character, %.3f ms batched", results->uncached_resolve_milliseconds, results->batch_resolve_milliseconds);
+		result.append_print_line("scoreboard hit rate: %.1f%% (%d hits, %d misses)", font_glyph_cache_hit_rate(results->hit_count, results->miss_count), results->hit_count, results->miss_count);
+	}
+
+	const s_font_glyph_cache_statistics* statistics = &g_font_glyph_cache_globals.statistics;
+	result.append_print_line("cache: %d hits, %d misses (%.1f%%), %d inserts, %d collisions",
+		statistics->hit_count.peek(),
+		statistics->miss_count.peek(),
+		font_glyph_cache_hit_rate(statistics->hit_count.peek(), statistics->miss_count.peek()),
+		statistics->insert_count.peek(),
+		statistics->collision_count.peek());
+	result.append_print_line("invalidation: %d whole cache, %d data slot evictions, %d stale entries",
+		statistics->invalidation_count.peek(),
+		statistics->eviction_count.peek(),
+		statistics->stale_count.peek());
+	result.append_print_line("batches: %d, %d duplicate misses skipped", statistics->batch_count.peek(), statistics->deduplicated_count.peek());
+
+	return result;
+}
+
+callback_result_t network_message_schema_benchmark_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 iterations = (int32)atol(tokens[1]->get_string());
+	if (iterations <= 0)
+	{
+		iterations = 1;
+	}
+
+	result.append_print_line("%d iterations, encode/decode ms and bits per message, handler vs schema", iterations);
+	for (int32 definition_index = 0; definition_index < network_message_schema_definition_count(); definition_index++)
+	{
+		s_network_message_schema_benchmark_result benchmark_result{};
+		network_message_schema_benchmark(definition_index, iterations, &benchmark_result);
+
+		result.append_print_line("%s: %.3f/%.3f ms %d bits vs %.3f/%.3f ms %d bits, %d round trip mismatches, %d wire mismatches, %s",
+			benchmark_result.message_type_name,
+			benchmark_result.handler_encode_milliseconds,
+			benchmark_result.handler_decode_milliseconds,
+			benchmark_result.handler_size_in_bits,
+			benchmark_result.schema_encode_milliseconds,
+			benchmark_result.schema_decode_milliseconds,
+			benchmark_result.schema_size_in_bits,
+			benchmark_result.round_trip_mismatch_count,
+			benchmark_result.wire_mismatch_count,
+			benchmark_result.registered ? "registered" : "handlers kept");
+	}
+
+	return result;
+}
+
+callback_result_t network_message_schema_fuzz_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 iterations = (int32)atol(tokens[1]->get_string());
+	if (iterations <= 0)
+	{
+		iterations = 1;
+	}
+
+	for (int32 definition_index = 0; definition_index < network_message_schema_definition_count(); definition_index++)
+	{
+		s_network_message_schema_fuzz_result fuzz_result{};
+		network_message_schema_fuzz(definition_index, 0x9E3779B9 * (definition_index + 1), iterations, &fuzz_result);
+
+		result.append_print_line("%s: %d accepted, %d rejected, %d round trip mismatches, %d overruns, %d decoded differently by the handlers, %s",
+			fuzz_result.message_type_name,
+			fuzz_result.accepted_count,
+			fuzz_result.rejected_count,
+			fuzz_result.round_trip_mismatch_count,
+			fuzz_result.overrun_count,
+			fuzz_result.parity_mismatch_count,
+			fuzz_result.registered ? "registered" : "handlers kept");
+	}
+
+	return result;
+}
+
+callback_result_t headless_server_status_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 checksum_interval = (int32)atol(tokens[1]->get_string());
+	if (checksum_interval >= 0)
+	{
+		g_main_headless_globals.checksum_interval = checksum_interval;
+	}
+
+	result.append_print_line("headless: %s, checksum interval: %d, last checksum: %08X at game time %d over %d simulation allocations",
+		main_headless_server() ? "yes" : "no",
+		g_main_headless_globals.checksum_interval,
+		g_main_headless_globals.last_checksum,
+		g_main_headless_globals.last_checksum_time,
+		g_main_headless_globals.last_simulation_allocation_count);
+
+	const struct
+	{
+		const char* name;
+		const s_main_headless_histogram* histogram;
+	} histograms[]
+	{
+		{ "frame", &g_main_headless_globals.frame_histogram },
+		{ "game tick", &g_main_headless_globals.game_tick_histogram },
+		{ "wait", &g_main_headless_globals.wait_histogram },
+	};
+
+	for (int32 histogram_index = 0; histogram_index < NUMBEROF(histograms); histogram_index++)
+	{
+		const s_main_headless_histogram* histogram = histograms[histogram_index].histogram;
+
+		result.append_print_line("%s: %d samples, %.3f ms average, %.3f ms maximum",
+			histograms[histogram_index].name,
+			histogram->sample_count,
+			histogram->sample_count > 0 ? histogram->total_milliseconds / histogram->sample_count : 0.0f,
+			histogram->maximum_milliseconds);
+
+		for (int32 bucket_index = 0; bucket_index < k_main_headless_histogram_bucket_count; bucket_index++)
+		{
+			if (histogram->bucket_counts[bucket_index] == 0)
+			{
+				continue;
+			}
+
+			if (bucket_index < k_main_headless_histogram_bucket_count - 1)
+			{
+				result.append_print_line("    < %.3f ms: %d", main_headless_histogram_bucket_milliseconds(bucket_index), histogram->bucket_counts[bucket_index]);
+			}
+			else
+			{
+				result.append_print_line("    >= %.3f ms: %d", main_headless_histogram_bucket_milliseconds(bucket_index - 1), histogram->bucket_counts[bucket_index]);
+			}
+		}
+	}
+
+	main_headless_histograms_reset();
+
+	return result;
+}
+
+callback_result_t simulation_replay_checksums_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 checkpoint_interval = (int32)atol(tokens[1]->get_string());
+	simulation_replay_record_checksums(checkpoint_interval > 0, checkpoint_interval);
+
+	if (checkpoint_interval > 0)
+	{
+		result.append_print_line("recording a simulation checksum every %d ticks with every new film", checkpoint_interval);
+	}
+	else
+	{
+		result.append_print_line("not recording simulation checksums");
+	}
+
+	return result;
+}
+
+callback_result_t simulation_replay_benchmark_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	const s_simulation_replay_benchmark_result* benchmark_result = simulation_replay_benchmark_get_result();
+	if (benchmark_result->tick_count > 0)
+	{
+		result.append_print_line("previous run: %d ticks in %.2f s, %.3f ms per tick, %.3f ms maximum",
+			benchmark_result->tick_count,
+			benchmark_result->wall_seconds,
+			benchmark_result->tick_milliseconds,
+			benchmark_result->maximum_tick_milliseconds);
+
+		for (int32 phase = 0; phase < k_simulation_replay_phase_count; phase++)
+		{
+			result.append_print_line("    %s: %.3f ms per tick, %.3f ms maximum",
+				simulation_replay_phase_get_name(e_simulation_replay_phase(phase)),
+				benchmark_result->phase_milliseconds[phase],
+				benchmark_result->maximum_phase_milliseconds[phase]);
+		}
+
+		result.append_print_line("    %d/%d checkpoints verified, %d mismatched, final checksum %08X at tick %d %s",
+			benchmark_result->verified_checkpoint_count,
+			benchmark_result->checkpoint_count,
+			benchmark_result->mismatched_checkpoint_count,
+			benchmark_result->final_checksum,
+			benchmark_result->final_tick,
+			benchmark_result->final_checksum_matched ? "matched" : "mismatched");
+	}
+
+	const char* film_name = tokens[1]->get_string();
+	if (simulation_replay_benchmark_start(film_name))
+	{
+		result.append_print_line("replaying '%s'", film_name);
+	}
+	else
+	{
+		result.append_print_line("failed to start replaying '%s'", film_name);
+	}
+
+	return result;
+}
+
+callback_result_t hook_invoke_benchmark_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 iterations = (int32)atol(tokens[1]->get_string());
+
+	s_hook_invoke_benchmark_result benchmark_result{};
+	hook_invoke_benchmark(iterations, &benchmark_result);
+
+	result.append_print_line("self test: %s", benchmark_result.self_test_passed ? "passed" : "FAILED");
+	result.append_print_line("trampoline: %.1f ns per call over %d calls", benchmark_result.trampoline_call_nanoseconds, benchmark_result.trampoline_call_count);
+	result.append_print_line("detach, call, attach: %.1f ns per call over %d calls", benchmark_result.toggle_call_nanoseconds, benchmark_result.toggle_call_count);
+
+	return result;
+}
+
+callback_result_t render_software_occlusion_status_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 worker_count = (int32)atol(tokens[1]->get_string());
+	if (worker_count < 0)
+	{
+		render_software_occlusion_set_mode(false, g_render_software_occlusion_globals.worker_count);
+	}
+	else if (worker_count <= k_maximum_render_software_occlusion_workers)
+	{
+		render_software_occlusion_set_mode(true, worker_count);
+	}
+
+	const s_render_software_occlusion_statistics* last_view = &g_render_software_occlusion_globals.last_view;
+	const s_render_software_occlusion_statistics* totals = &g_render_software_occlusion_globals.totals;
+	result.append_print_line("software occlusion: %s, %d workers",
+		g_render_software_occlusion_globals.enabled ? "enabled" : "disabled",
+		g_render_software_occlusion_globals.worker_count);
+	result.append_print_line("last view: %d occluders, %d of %d objects rejected, %.3f ms rasterizing, %.3f ms testing",
+		last_view->occluder_count,
+		last_view->objects_rejected,
+		last_view->objects_tested,
+		1000.0f * c_stop_watch::cycles_to_seconds(last_view->rasterize_cycles),
+		1000.0f * c_stop_watch::cycles_to_seconds(last_view->test_cycles));
+
+	if (totals->view_count > 0)
+	{
+		result.append_print_line("views: %d prepared, %d built without a prepared view, %d built again for another camera",
+			totals->prepared_view_count,
+			totals->unprepared_view_count,
+			totals->mismatched_view_count);
+		result.append_print_line("average over %d views: %.1f occluders, %.1f of %.1f objects rejected, %.3f ms per view",
+			totals->view_count,
+			real32(totals->occluder_count) / totals->view_count,
+			real32(totals->objects_rejected) / totals->view_count,
+			real32(totals->objects_tested) / totals->view_count,
+			1000.0f * c_stop_watch::cycles_to_seconds(totals->rasterize_cycles + totals->test_cycles) / totals->view_count);
+	}
+
+	return result;
+}
+
+callback_result_t render_software_occlusion_benchmark_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 iterations = (int32)atol(tokens[1]->get_string());
+
+	s_render_software_occlusion_benchmark_result benchmark_result{};
+	render_software_occlusion_benchmark(iterations, &benchmark_result);
+
+	result.append_print_line("self test: %s", benchmark_result.self_test_passed ? "passed" : "FAILED");
+	result.append_print_line("%d occluders, %d of %d spheres rejected, %d expected",
+		benchmark_result.occluder_count,
+		benchmark_result.spheres_rejected,
+		benchmark_result.sphere_count,
+		benchmark_result.expected_spheres_rejected);
+	result.append_print_line("rasterize: %.3f ms serial, %.3f ms on %d workers",
+		benchmark_result.serial_rasterize_milliseconds,
+		benchmark_result.parallel_rasterize_milliseconds,
+		MAX(g_render_software_occlusion_globals.worker_count, 1));
+	result.append_print_line("sphere test: %.2f us per sphere", benchmark_result.test_microseconds);
+
+	return result;
+}
+
+callback_result_t render_software_occlusion_prepare_views_benchmark_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 iterations = (int32)atol(tokens[1]->get_string());
+
+	s_render_software_occlusion_prepare_views_benchmark_result benchmark_result{};
+	render_software_occlusion_prepare_views_benchmark(iterations, &benchmark_result);
+
+	result.append_print_line("%s cameras, %d workers",
+		benchmark_result.captured_cameras ? "captured" : "synthetic",
+		benchmark_result.worker_count);
+	for (int32 view_count = 1; view_count <= k_maximum_render_software_occlusion_prepared_views; view_count++)
+	{
+		real32 serial_milliseconds = benchmark_result.serial_milliseconds[view_count - 1];
+		real32 parallel_milliseconds = benchmark_result.parallel_milliseconds[view_count - 1];
+		result.append_print_line("%d occlusion views: %d occluders, %.3f ms serial, %.3f ms parallel, %.2fx",
+			view_count,
+			benchmark_result.occluder_count[view_count - 1],
+			serial_milliseconds,
+			parallel_milliseconds,
+			parallel_milliseconds > 0.0f ? serial_milliseconds / parallel_milliseconds : 0.0f);
+	}
+
+	return result;
+}
+
+callback_result_t gui_widget_cache_status_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 enable = (int32)atol(tokens[1]->get_string());
+	if (enable == 0 || enable == 1)
+	{
+		gui_widget_cache_set_enabled(enable == 1);
+	}
+
+	const s_gui_widget_cache_counters* last_frame = &g_gui_widget_cache_globals.last_frame;
+	const s_gui_widget_cache_counters* totals = &g_gui_widget_cache_globals.totals;
+	result.append_print_line("widget cache: %s", g_gui_widget_cache_globals.enabled ? "enabled" : "disabled");
+	result.append_print_line("last frame: %d widgets animated, %d changed, %d volatile, %d time driven, %d render states updated, %d skipped, %d of %d bounds cached, %.3f ms updating",
+		last_frame->widgets_animated,
+		last_frame->widgets_changed,
+		last_frame->widgets_volatile,
+		last_frame->widgets_time_driven,
+		last_frame->render_state_updates,
+		last_frame->render_state_skips,
+		last_frame->bounds_hits,
+		last_frame->bounds_hits + last_frame->bounds_misses,
+		1000.0f * c_stop_watch::cycles_to_seconds(last_frame->update_cycles));
+
+	int32 frame_count = g_gui_widget_cache_globals.frame_count;
+	if (frame_count > 0)
+	{
+		result.append_print_line("average over %d frames: %.1f render states updated, %.1f skipped, %.1f of %.1f bounds cached, %.3f ms updating",
+			frame_count,
+			real32(totals->render_state_updates) / frame_count,
+			real32(totals->render_state_skips) / frame_count,
+			real32(totals->bounds_hits) / frame_count,
+			real32(totals->bounds_hits + totals->bounds_misses) / frame_count,
+			1000.0f * c_stop_watch::cycles_to_seconds(totals->update_cycles) / frame_count);
+	}
+
+	return result;
+}
+
+callback_result_t network_search_summary_list_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 sort = (int32)atol(tokens[1]->get_string());
+	if (!VALID_INDEX(sort, k_network_search_summary_sort_count))
+	{
+		sort = _network_search_summary_sort_none;
+	}
+
+	s_network_search_summary_filter filter{};
+	filter.game_engine_type = NONE;
+	filter.map_id = NONE;
+	filter.minimum_open_slot_count = 0;
+
+	network_search_summary_set_list_order(&filter, e_network_search_summary_sort(sort));
+
+	const int16* index = NULL;
+	int32 index_count = network_search_summary_build_index(&index);
+	for (int32 i = 0; i < index_count; i++)
+	{
+		const s_network_search_summary* summary = network_search_summary_get(index[i]);
+		result.append_print_line("%d: %d players, %d open slots, quality %d, engine %d, map %d%s%s",
+			index[i],
+			summary->player_count,
+			summary->open_slot_count,
+			summary->connection_quality,
+			summary->game_engine_type,
+			summary->map_id,
+			summary->detail_index != NONE ? ", details held" : summary->detail_wanted ? ", details wanted" : "",
+			summary->pinned ? ", listed" : "");
+	}
+
+	const s_network_search_summary_globals* globals = &g_network_search_summary_globals;
+	result.append_print_line("%d sessions, %d replies, %d details claimed, %d replies kept as summaries only, %d index builds",
+		index_count,
+		globals->replies_handled,
+		globals->details_claimed,
+		globals->summary_only_replies,
+		globals->index_builds);
+
+	return result;
+}
+
+callback_result_t network_search_summary_select_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 summary_index = (int32)atol(tokens[1]->get_string());
+	if (!network_search_summary_get(summary_index))
+	{
+		result.append_print_line("no session %d", summary_index);
+		return result;
+	}
+
+	const s_available_session* session = network_search_summary_select(summary_index);
+	if (!session)
+	{
+		result.append_print_line("session %d selected, its details arrive with its next reply", summary_index);
+		return result;
+	}
+
+	result.append_print_line("session %d: '%ls'", summary_index, session->status_data.game_details.session_name);
+
+	return result;
+}
+
+callback_result_t object_update_lod_status_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 enable = (int32)atol(tokens[1]->get_string());
+	if (enable == 0 || enable == 1)
+	{
+		object_scheduler_lod_set_enabled(enable == 1);
+	}
+
+	const s_object_scheduler_lod_globals* globals = &g_object_scheduler_lod_globals;
+	result.append_print_line("object update lod: %s", globals->enabled ? "enabled" : "disabled");
+	for (int32 tier = 0; tier < k_object_scheduler_lod_tier_count; tier++)
+	{
+		result.append_print_line("tier %d (every %d ticks): last tick %d updated, %d deferred, average %.1f updated, %.1f deferred",
+			tier,
+			FLAG(tier),
+			globals->last_tick.objects_updated[tier],
+			globals->last_tick.objects_deferred[tier],
+			globals->tick_count > 0 ? real32(globals->totals.objects_updated[tier]) / globals->tick_count : 0.0f,
+			globals->tick_count > 0 ? real32(globals->totals.objects_deferred[tier]) / globals->tick_count : 0.0f);
+	}
+	result.append_print_line("last tick: %d promoted, %.3f ms in objects_update",
+		globals->last_tick.objects_promoted,
+		1000.0f * c_stop_watch::cycles_to_seconds(globals->last_tick.update_cycles));
+
+	return result;
+}
+
+callback_result_t object_update_lod_benchmark_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	const s_object_scheduler_lod_benchmark* benchmark = &g_object_scheduler_lod_globals.benchmark;
+
+	int32 tick_count = (int32)atol(tokens[1]->get_string());
+	if (tick_count > 0 && !benchmark->running)
+	{
+		object_scheduler_lod_benchmark_start(tick_count);
+		result.append_print_line("timing %d ticks without and %d ticks with the update lod", tick_count, tick_count);
+		return result;
+	}
+
+	if (benchmark->running)
+	{
+		result.append_print_line("benchmark running, %d ticks left in its %s phase",
+			benchmark->ticks_remaining,
+			benchmark->phase == _object_scheduler_lod_benchmark_phase_enabled ? "second" : "first");
+	}
+	else if (benchmark->finished)
+	{
+		for (int32 phase = 0; phase < k_object_scheduler_lod_benchmark_phase_count; phase++)
+		{
+			result.append_print_line("%s: %.3f ms and %.1f object updates per tick",
+				phase == _object_scheduler_lod_benchmark_phase_enabled ? "with lod" : "without lod",
+				1000.0f * c_stop_watch::cycles_to_seconds(benchmark->cycles[phase]) / benchmark->tick_count,
+				real32(benchmark->objects_updated[phase]) / benchmark->tick_count);
+		}
+	}
+	else
+	{
+		result.append_print_line("no benchmark has run");
+	}
+
+	return result;
+}
+
+callback_result_t determinism_hash_status_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 enable = (int32)atol(tokens[1]->get_string());
+	if (enable == 0 || enable == 1)
+	{
+		determinism_debug_manager_set_game_state_hashing(enable == 1);
+	}
+
+	const s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+	result.append_print_line("game state hashing: %s", globals->enabled ? "enabled" : "disabled");
+	result.append_print_line("%d subsystems, %d sectors in %d stripes, %d layout builds, %d after game state loads",
+		globals->subsystem_count,
+		globals->sector_count,
+		k_determinism_hash_stripe_count,
+		globals->layout_builds,
+		globals->discontinuity_count);
+	result.append_print_line("last tick: %d sectors hashed (%d KB), %d changed, %.3f ms",
+		globals->last_tick_sectors_hashed,
+		globals->last_tick_sectors_hashed * k_determinism_hash_sector_size / 1024,
+		globals->last_tick_sectors_dirty,
+		1000.0f * c_stop_watch::cycles_to_seconds(globals->last_tick_cycles));
+	if (globals->tick_count > 0)
+	{
+		result.append_print_line("per tick over %d ticks: %.1f sectors hashed (%.1f KB), %.1f changed, %.3f ms",
+			globals->tick_count,
+			real32(globals->total_sectors_hashed) / globals->tick_count,
+			real32(globals->total_sectors_hashed) * k_determinism_hash_sector_size / 1024 / globals->tick_count,
+			real32(globals->total_sectors_dirty) / globals->tick_count,
+			1000.0f * c_stop_watch::cycles_to_seconds(globals->total_cycles) / globals->tick_count);
+		result.append_print_line("per tick sent to the host: %.1f bytes in %d verifications",
+			real32(globals->sent_count) * sizeof(s_network_message_determinism_verification) / globals->tick_count,
+			globals->sent_count);
+	}
+	result.append_print_line("%d client verifications compared, %d mismatches",
+		globals->compare_count,
+		globals->mismatch_count);
+
+	s_determinism_verification verification{};
+	if (determinism_debug_manager_generate_game_state_checksum(&verification))
+	{
+		result.append_print_line("game state check %08X, unchanged mask %08X",
+			verification.game_state_check,
+			verification.unchanged_field_mask);
+	}
+
+	return result;
+}
+
+callback_result_t determinism_hash_consumer_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 consumer_index = (int32)atol(tokens[1]->get_string());
+
+	const s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+	for (int32 subsystem_index = 0; subsystem_index < globals->subsystem_count; subsystem_index++)
+	{
+		const s_determinism_hash_subsystem* subsystem = &globals->subsystems[subsystem_index];
+		if (subsystem->consumer_index != consumer_index)
+		{
+			continue;
+		}
+
+		result.append_print_line("'%s' %u bytes, hash %08X, last changed at game time %d in sectors %d-%d",
+			subsystem->name,
+			subsystem->size,
+			subsystem->hash,
+			subsystem->last_change_time,
+			subsystem->first_dirty_sector,
+			subsystem->last_dirty_sector);
+	}
+
+	return result;
+}
+
+callback_result_t game_state_budgets_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 minimum_percent = (int32)atol(tokens[1]->get_string());
+
+	const s_game_state_telemetry_globals* globals = &g_game_state_telemetry_globals;
+	result.append_print_line("%d allocations followed, %d ticks this match",
+		globals->allocation_count,
+		globals->match_tick_count);
+
+	for (int32 allocation_index = 0; allocation_index < globals->allocation_count; allocation_index++)
+	{
+		const s_game_state_telemetry_allocation* allocation = &globals->allocations[allocation_index];
+		if (allocation->capacity <= 0)
+		{
+			continue;
+		}
+
+		int32 peak_percent = int32(100LL * allocation->peak_used / allocation->capacity);
+		if (peak_percent < minimum_percent)
+		{
+			continue;
+		}
+
+		result.append_print_line("%s '%s': %d used, peak %d/%d (%d%%) at game time %d, high water %d",
+			game_state_telemetry_allocation_type_get_name(allocation->type),
+			allocation->name,
+			game_state_telemetry_allocation_get_used(allocation),
+			allocation->peak_used,
+			allocation->capacity,
+			peak_percent,
+			allocation->peak_time,
+			allocation->peak_high_water_count);
+	}
+
+	return result;
+}
+
+callback_result_t animation_node_matrices_benchmark_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 enable = (int32)atol(tokens[1]->get_string());
+	int32 iteration_count = (int32)atol(tokens[2]->get_string());
+
+	s_animation_node_matrices_globals* globals = &g_animation_node_matrices_globals;
+	if (enable == 0 || enable == 1)
+	{
+		globals->enabled = enable == 1;
+	}
+
+	result.append_print_line("node matrix batching: %s", globals->enabled ? "enabled" : "disabled");
+	result.append_print_line("%d batched compositions, %d original compositions (%d of them samples of verified graphs), %d mismatched graphs",
+		globals->batched_compositions.peek(),
+		globals->original_compositions.peek(),
+		globals->sampled_compositions.peek(),
+		globals->mismatched_graphs.peek());
+
+	s_animation_node_matrices_benchmark_result benchmark_result{};
+	if (!animation_node_matrices_benchmark(iteration_count, &benchmark_result))
+	{
+		result.append_print_line("no bipeds with a skeleton that can be batched");
+		return result;
+	}
+
+	result.append_print_line("%d objects, %d nodes, %d iterations",
+		benchmark_result.object_count,
+		benchmark_result.node_count,
+		benchmark_result.iteration_count);
+	result.append_print_line("original %.3f ms, scalar %.3f ms, batched %.3f ms (%.2fx)",
+		benchmark_result.original_milliseconds,
+		benchmark_result.scalar_milliseconds,
+		benchmark_result.batched_milliseconds,
+		benchmark_result.batched_milliseconds > 0.0f ? benchmark_result.original_milliseconds / benchmark_result.batched_milliseconds : 0.0f);
+	result.append_print_line("%d floats differ between batched and scalar, %d between batched and the original, maximum error against the original %g",
+		benchmark_result.batched_scalar_mismatches,
+		benchmark_result.batched_original_mismatches,
+		benchmark_result.maximum_original_error);
+
+	return result;
+}
+
+callback_result_t allocation_audit_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	bool enabled = (int32)atol(tokens[1]->get_string()) != 0;
+	if (enabled == g_allocation_audit_globals.enabled)
+	{
+		result.append_print_line("allocation audit is already %s", enabled ? "running" : "stopped");
+		return result;
+	}
+
+	if (enabled)
+	{
+		allocation_audit_start();
+		result.append_print_line("allocation audit started");
+	}
+	else
+	{
+		allocation_audit_stop();
+		result.append_print_line("allocation audit stopped after %d ticks, %d frames, %d callsites, %d hot path allocations, report %s",
+			g_allocation_audit_globals.tick_count,
+			g_allocation_audit_globals.frame_count,
+			g_allocation_audit_globals.callsite_count,
+			g_allocation_audit_globals.hot_path_count,
+			allocation_audit_export_report() ? "exported" : "failed to export");
+	}
+
+	return result;
+}
+
+callback_result_t allocation_audit_report_callback(const void* userdata, int32 token_count, tokens_t const tokens)
+{
+	COMMAND_CALLBACK_PARAMETER_CHECK;
+
+	int32 count = (int32)atol(tokens[1]->get_string());
+
+	const s_allocation_audit_globals* globals = &g_allocation_audit_globals;
+	result.append_print_line("%d ticks, %d frames, %d callsites, %d hot path allocations, %d dropped events",
+		globals->tick_count,
+		globals->frame_count,
+		globals->callsite_count,
+		globals->hot_path_count,
+		globals->dropped_event_count);
+
+	int32 callsite_indices[k_maximum_allocation_audit_callsites];
+	int32 callsite_count = allocation_audit_get_ranked_callsites(callsite_indices, MAX(count, 0));
+	for (int32 rank = 0; rank < callsite_count; rank++)
+	{
+		const s_allocation_audit_callsite* callsite = &globals->callsites[callsite_indices[rank]];
+
+		c_static_string<256> location;
+		allocation_audit_callsite_get_location(callsite, &location);
+
+		result.append_print_line("%d: %s %s '%s': %d allocations, %d reallocations, %d frees, peak %d per tick, peak %d per frame, %d hot path",
+			rank,
+			location.get_string(),
+			allocation_audit_source_get_name(callsite->source),
+			callsite->name.get_string(),
+			callsite->event_counts[_allocation_audit_event_allocate],
+			callsite->event_counts[_allocation_audit_event_reallocate],
+			callsite->event_counts[_allocation_audit_event_free],
+			callsite->peak_tick_event_count,
+			callsite->peak_frame_event_count,
+			callsite->hot_path_count);
+	}
+
+	return result;
+}
+
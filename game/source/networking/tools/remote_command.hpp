@@ -128,6 +128,36 @@ COMMAND_CALLBACK_DECLARE(controller_set_secondary_change_color);
 COMMAND_CALLBACK_DECLARE(controller_set_secondary_emblem_color);
 COMMAND_CALLBACK_DECLARE(controller_set_tertiary_change_color);
 
+COMMAND_CALLBACK_DECLARE(event_logs_benchmark);
+COMMAND_CALLBACK_DECLARE(tag_resources_zone_switches);
+COMMAND_CALLBACK_DECLARE(tag_resource_trace_start);
+COMMAND_CALLBACK_DECLARE(tag_resource_trace_stop);
+COMMAND_CALLBACK_DECLARE(tag_resource_prefetch_build);
+COMMAND_CALLBACK_DECLARE(tag_resource_prefetch_replay);
+COMMAND_CALLBACK_DECLARE(tag_resource_prefetch_start);
+COMMAND_CALLBACK_DECLARE(tag_resource_prefetch_stop);
+COMMAND_CALLBACK_DECLARE(font_glyph_cache_benchmark);
+COMMAND_CALLBACK_DECLARE(network_message_schema_benchmark);
+COMMAND_CALLBACK_DECLARE(network_message_schema_fuzz);
+COMMAND_CALLBACK_DECLARE(headless_server_status);
+COMMAND_CALLBACK_DECLARE(simulation_replay_checksums);
+COMMAND_CALLBACK_DECLARE(simulation_replay_benchmark);
+COMMAND_CALLBACK_DECLARE(hook_invoke_benchmark);
+COMMAND_CALLBACK_DECLARE(render_software_occlusion_status);
+COMMAND_CALLBACK_DECLARE(render_software_occlusion_benchmark);
+COMMAND_CALLBACK_DECLARE(render_software_occlusion_prepare_views_benchmark);
+COMMAND_CALLBACK_DECLARE(gui_widget_cache_status);
+COMMAND_CALLBACK_DECLARE(network_search_summary_list);
+COMMAND_CALLBACK_DECLARE(network_search_summary_select);
+COMMAND_CALLBACK_DECLARE(object_update_lod_status);
+COMMAND_CALLBACK_DECLARE(object_update_lod_benchmark);
+COMMAND_CALLBACK_DECLARE(determinism_hash_status);
+COMMAND_CALLBACK_DECLARE(determinism_hash_consumer);
+COMMAND_CALLBACK_DECLARE(game_state_budgets);
+COMMAND_CALLBACK_DECLARE(animation_node_matrices_benchmark);
+COMMAND_CALLBACK_DECLARE(allocation_audit);
+COMMAND_CALLBACK_DECLARE(allocation_audit_report);
+
 //-----------------------------------------------------------------------------
 
 s_command const k_registered_commands[] =
@@ -171,6 +201,36 @@ s_command const k_registered_commands[] =
 	COMMAND_CALLBACK_REGISTER(controller_set_secondary_change_color, 2, "<controller> <player_color>", "set secondary change color for specified controller\r\nNETWORK SAFE: No"),
 	COMMAND_CALLBACK_REGISTER(controller_set_secondary_emblem_color, 2, "<controller> <player_color>", "set secondary change color for specified controller\r\nNETWORK SAFE: No"),
 	COMMAND_CALLBACK_REGISTER(controller_set_tertiary_change_color, 2, "<controller> <player_color>", "set tertiary color for specified controller\r\nNETWORK SAFE: No"),
+
+	COMMAND_CALLBACK_REGISTER(event_logs_benchmark, 1, "<long>", "<iterations> measures event log calls per second from the calling thread with and without the event log writer thread\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(tag_resources_zone_switches, 1, "<long>", "<mode> 0 blocks zone switches on every pending resource, 1 only blocks on the required ones and streams the rest, anything else keeps the current mode. prints the stall time of recent zone switches\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(tag_resource_trace_start, 0, "", "starts recording the first touch of every tag resource along with the tick and the cluster the player is in\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(tag_resource_trace_stop, 1, "<string>", "<filename> stops recording tag resource first touches and writes the trace\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(tag_resource_prefetch_build, 2, "<string> <string>", "<statistics_filename> <trace_filename,...> builds per cluster prefetch statistics from traces recorded on the same map\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(tag_resource_prefetch_replay, 2, "<string> <string>", "<statistics_filename> <trace_filename> replays a trace against the prefetch predictor and compares its demand misses with the zone set prefetching the trace was recorded with\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(tag_resource_prefetch_start, 1, "<string>", "<statistics_filename> starts following the player with the prefetch predictor and counting the resources it expects to be touched next, without requesting them\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(tag_resource_prefetch_stop, 0, "", "stops the prefetch predictor and prints how many predicted resources were missing and how many the zone state made active later\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(font_glyph_cache_benchmark, 1, "<long>", "<iterations> draws the multiplayer scoreboard text that many times with and without the glyph cache on the next frame, 0 only prints the last results and the cache statistics\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(network_message_schema_benchmark, 1, "<long>", "<iterations> encodes and decodes random session protocol and simulation messages that many times with their handlers and with their schemas, checks both put the same bits on the wire and prints which schemas are registered\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(network_message_schema_fuzz, 1, "<long>", "<iterations> decodes that many random packets with every message schema, checks what they accept survives a round trip and that the registered handlers accept and reject the same packets\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(headless_server_status, 1, "<long>", "<checksum interval> prints frame, game tick and wait time histograms and logs the simulation checksum every that many ticks, 0 stops logging, -1 leaves it unchanged\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(simulation_replay_checksums, 1, "<long>", "<interval> records a simulation checksum every that many ticks next to every film recorded from now on, 0 stops recording checksums\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(simulation_replay_benchmark, 1, "<string>", "<film> plays a film recorded with checksums back at full speed, times the game tick phases, verifies the checksums and appends the results to replay_benchmark.txt\r\nNETWORK SAFE: No, for mainmenu only"),
+	COMMAND_CALLBACK_REGISTER(hook_invoke_benchmark, 1, "<long>", "<iterations> hooks a generated function, checks calls reach the hook and the original, and times calls through the trampoline against detaching and attaching around every call\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(render_software_occlusion_status, 1, "<long>", "<worker count> -1 disables software occlusion of camera visibility, 0 rasterizes occluders on the calling thread, up to 4 on worker threads, prints objects tested and rejected by the last view and overall\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(render_software_occlusion_benchmark, 1, "<long>", "<iterations> rasterizes a synthetic wall of occluders serially and on the worker threads, checks which spheres behind it are rejected and times both\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(render_software_occlusion_prepare_views_benchmark, 1, "<long>", "<iterations> builds the occlusion depth buffers of one to four cameras at once, serially and on the worker threads, using the cameras of the last frame rendered, the visibility collections are not included\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(gui_widget_cache_status, 1, "<long>", "<enable> 0 re-evaluates every widget every frame, 1 only re-evaluates widgets whose state changed, -1 leaves it as it is, prints widgets re-evaluated and skipped and the ui update time of the last frame and on average\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(network_search_summary_list, 1, "<long>", "<sort> lists the sessions heard by the broadcast search in the order the session browser then shows them, 0 in the order they were heard, 1 by players, 2 by open slots, 3 by connection quality, 4 by game engine, 5 by map\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(network_search_summary_select, 1, "<long>", "<session> selects a session listed by network_search_summary_list, its full status data is kept from its next reply on\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(object_update_lod_status, 1, "<long>", "<enable> 0 updates every awake object every tick, 1 updates objects far from every player less often, -1 leaves it as it is, prints objects updated and deferred per tier for the last tick and on average\r\nNETWORK SAFE: No"),
+	COMMAND_CALLBACK_REGISTER(object_update_lod_benchmark, 1, "<long>", "<ticks> times objects_update over this many ticks without and then with the update lod, prints the last results when a benchmark is running or 0 ticks are given\r\nNETWORK SAFE: No"),
+	COMMAND_CALLBACK_REGISTER(determinism_hash_status, 1, "<long>", "<enable> 0 stops hashing the game state every tick, 1 starts it, -1 leaves it as it is, prints the cost per tick, the checks of the last tick and the client verifications compared against them\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(determinism_hash_consumer, 1, "<long>", "<consumer> lists the game state subsystems folded into a consumer check with their hashes and where they last changed\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(game_state_budgets, 1, "<long>", "<percent> lists the game state data arrays and memory pools whose peak this match reached at least this percent of their capacity, with their current use, peak and high water\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(animation_node_matrices_benchmark, 2, "<long> <long>", "<enable> <iterations> 0 composes skeletons through the original, 1 batches the ones that match it bit for bit, -1 leaves it as it is, then composes the skeletons of 64 bipeds through the original, scalar and batched node matrix hierarchy update, prints the time of each and how far apart the results are\r\nNETWORK SAFE: No"),
+	COMMAND_CALLBACK_REGISTER(allocation_audit, 1, "<long>", "<enabled> starts counting memory pool, data array, datum and optional cache allocations and frees per callsite, stopping exports the ranked callsites to allocation_audit.txt\r\nNETWORK SAFE: Yes"),
+	COMMAND_CALLBACK_REGISTER(allocation_audit_report, 1, "<long>", "<count> lists the callsites with the most allocations made inside allocation free game tick phases, then the most allocations overall\r\nNETWORK SAFE: Yes"),
 };
 
 extern void command_tokenize(const char* input, tokens_t& tokens, int32* token_count);
@@ -1,5 +1,35 @@
 #include "objects/object_scheduler.hpp"
 
+#include "cache/restricted_memory.hpp"
+#include "cache/restricted_memory_regions.hpp"
+#include "game/game.hpp"
+#include "game/game_time.hpp"
+#include "game/players.hpp"
+#include "math/real_math.hpp"
+#include "memory/thread_local.hpp"
+#include "objects/objects.hpp"
+#include "profiler/profiler_stopwatch.hpp"
+
+s_object_scheduler_lod_globals g_object_scheduler_lod_globals
+{
+	.enabled = false,
+	.tier_distances = { 40.0f, 80.0f, 160.0f },
+	.state_member_index = NONE,
+};
+
+// the types that only ever update to animate or sound, device functions run off the tick count and are left alone
+static const uns32 k_object_scheduler_lod_type_mask =
+	FLAG(_object_type_scenery) |
+	FLAG(_object_type_sound_scenery) |
+	FLAG(_object_type_crate) |
+	FLAG(_object_type_effect_scenery);
+
+static c_stop_watch* object_scheduler_lod_stop_watch()
+{
+	static c_stop_watch stop_watch(true);
+	return &stop_watch;
+}
+
 //.text:00B99BD0 ; public: __cdecl t_restricted_allocation_manager<1, 0, 0, &void __cdecl __tls_set_g_object_schedule_globals_allocator(void*)>::t_restricted_allocation_manager<1, 0, 0, &void __cdecl __tls_set_g_object_schedule_globals_allocator(void*)>()
 //.text:00B99BF0 ; public: __cdecl t_restricted_allocation_manager<1, 0, 0, &void __cdecl __tls_set_g_object_schedule_globals_allocator(void*)>::~t_restricted_allocation_manager<1, 0, 0, &void __cdecl __tls_set_g_object_schedule_globals_allocator(void*)>()
 //.text:00B99C00 ; public: real32& __cdecl c_static_array<real32, 30>::operator[]<int32>(int32)
@@ -14,9 +44,22 @@
 //.text:00B99D20 ; public: int32 __cdecl c_schedule_iterator::next()
 //.text:00B99D70 ; int32 __cdecl object_scheduler_allocate(int32)
 
+static void __cdecl object_scheduler_lod_set_state_address(void* address)
+{
+	g_object_scheduler_lod_globals.state = static_cast<s_object_scheduler_lod_state*>(address);
+}
+
 void __cdecl object_scheduler_dispose()
 {
 	INVOKE(0x00B99E60, object_scheduler_dispose);
+
+	s_object_scheduler_lod_globals* globals = &g_object_scheduler_lod_globals;
+	if (globals->state_member_index != NONE)
+	{
+		restricted_region_free_member(k_game_state_update_region, globals->state_member_index);
+		globals->state_member_index = NONE;
+		globals->state = NULL;
+	}
 }
 
 void __cdecl object_scheduler_dispose_from_old_map()
@@ -27,11 +70,23 @@ void __cdecl object_scheduler_dispose_from_old_map()
 void __cdecl object_scheduler_initialize()
 {
 	INVOKE(0x00B99E90, object_scheduler_initialize);
+
+	s_object_scheduler_lod_globals* globals = &g_object_scheduler_lod_globals;
+	ASSERT(globals->state_member_index == NONE);
+
+	globals->state_member_index = restricted_region_add_member(k_game_state_update_region, "object scheduler lod", "s_object_scheduler_lod_state", sizeof(s_object_scheduler_lod_state), 0, object_scheduler_lod_set_state_address, NULL, NULL);
+	object_scheduler_lod_set_state_address(restricted_region_get_member_address(k_game_state_update_region, globals->state_member_index));
 }
 
 void __cdecl object_scheduler_initialize_for_new_map()
 {
 	INVOKE(0x00B99EF0, object_scheduler_initialize_for_new_map);
+
+	s_object_scheduler_lod_globals* globals = &g_object_scheduler_lod_globals;
+	if (globals->state)
+	{
+		csmemset(globals->state, 0, sizeof(s_object_scheduler_lod_state));
+	}
 }
 
 //.text:00B99F20 ; int32 __cdecl object_scheduler_optimal_phase_index_calculate(int32, int32, real32)
@@ -46,3 +101,219 @@ void __cdecl object_scheduler_update()
 //.text:00B9A2D0 ; int32 __cdecl phase_index_from_time(int32, int32)
 //.text:00B9A2F0 ; public: void* __cdecl t_restricted_allocation_manager<1, 0, 0, &void __cdecl __tls_set_g_object_schedule_globals_allocator(void*)>::reserve_memory(const char*, const char*, unsigned int, int32)
 
+// the tier an object belongs in this tick, anything that must not fall behind is kept in the first tier
+static int32 object_scheduler_lod_tier(int32 object_index, const object_header_datum* object_header, const object_datum* object)
+{
+	s_object_scheduler_lod_globals* globals = &g_object_scheduler_lod_globals;
+
+	if (!TEST_BIT(k_object_scheduler_lod_type_mask, object_header->object_type.get())
+		|| object_header->flags.test(_object_header_requires_motion_bit)
+		|| object->object.parent_object_index != NONE
+		|| object->object.first_child_object_index != NONE
+		|| object->object.name_index != NONE
+		|| object->object.next_sync_action_participant_index != NONE
+		|| (game_is_predicted() && object->object.simulation_object_glue_index != NONE)
+		|| object->object.recent_body_damage > 0.0f
+		|| object->object.recent_shield_damage > 0.0f
+		|| magnitude_squared3d(&object->object.transitional_velocity) > k_real_epsilon
+		|| magnitude_squared3d(&object->object.angular_velocity) > k_real_epsilon)
+	{
+		return 0;
+	}
+
+	// with no players to measure from everything keeps its full rate
+	if (globals->player_position_count <= 0)
+	{
+		return 0;
+	}
+
+	real32 nearest_distance_squared = k_real_max;
+	for (int32 player_position_index = 0; player_position_index < globals->player_position_count; player_position_index++)
+	{
+		real32 distance_squared = distance_squared3d(&object->object.bounding_sphere_center, &globals->player_positions[player_position_index]);
+		nearest_distance_squared = MIN(nearest_distance_squared, distance_squared);
+	}
+
+	real32 nearest_distance = MAX(square_root(nearest_distance_squared) - object->object.bounding_sphere_radius, 0.0f);
+
+	int32 tier = 0;
+	while (tier < k_object_scheduler_lod_tier_count - 1 && nearest_distance > globals->tier_distances[tier])
+	{
+		tier++;
+	}
+
+	return tier;
+}
+
+void object_scheduler_lod_set_enabled(bool enabled)
+{
+	s_object_scheduler_lod_globals* globals = &g_object_scheduler_lod_globals;
+
+	// objects deferred until now catch up on their next update, whatever their tier is
+	globals->enabled = enabled;
+}
+
+void object_scheduler_lod_tick_begin()
+{
+	s_object_scheduler_lod_globals* globals = &g_object_scheduler_lod_globals;
+
+	// players are measured from their units, which every machine in the game agrees on
+	globals->player_position_count = 0;
+	c_player_with_unit_iterator player_iterator;
+	player_iterator.begin();
+	while (player_iterator.next() && globals->player_position_count < k_maximum_players)
+	{
+		const player_datum* player = player_iterator.get_datum();
+		if (player->unit_index != NONE)
+		{
+			globals->player_positions[globals->player_position_count++] = object_get(player->unit_index)->object.bounding_sphere_center;
+		}
+	}
+
+	c_stop_watch* stop_watch = object_scheduler_lod_stop_watch();
+	stop_watch->reset();
+	stop_watch->start();
+}
+
+void object_scheduler_lod_tick_end()
+{
+	s_object_scheduler_lod_globals* globals = &g_object_scheduler_lod_globals;
+	s_object_scheduler_lod_counters* current = &globals->current;
+
+	current->update_cycles = object_scheduler_lod_stop_watch()->stop();
+	globals->last_tick = *current;
+
+	globals->tick_count++;
+	for (int32 tier = 0; tier < k_object_scheduler_lod_tier_count; tier++)
+	{
+		globals->totals.objects_updated[tier] += current->objects_updated[tier];
+		globals->totals.objects_deferred[tier] += current->objects_deferred[tier];
+	}
+	globals->totals.objects_promoted += current->objects_promoted;
+	globals->totals.update_cycles += current->update_cycles;
+
+	s_object_scheduler_lod_benchmark* benchmark = &globals->benchmark;
+	if (benchmark->running)
+	{
+		for (int32 tier = 0; tier < k_object_scheduler_lod_tier_count; tier++)
+		{
+			benchmark->objects_updated[benchmark->phase] += current->objects_updated[tier];
+		}
+		benchmark->cycles[benchmark->phase] += current->update_cycles;
+
+		if (--benchmark->ticks_remaining <= 0)
+		{
+			if (++benchmark->phase < k_object_scheduler_lod_benchmark_phase_count)
+			{
+				benchmark->ticks_remaining = benchmark->tick_count;
+				object_scheduler_lod_set_enabled(benchmark->phase == _object_scheduler_lod_benchmark_phase_enabled);
+			}
+			else
+			{
+				benchmark->running = false;
+				benchmark->finished = true;
+				object_scheduler_lod_set_enabled(benchmark->restore_enabled);
+			}
+		}
+	}
+
+	csmemset(current, 0, sizeof(s_object_scheduler_lod_counters));
+}
+
+static bool object_scheduler_lod_early_mover(int32 object_index)
+{
+	const int32* object_early_movers = NULL;
+	int32 object_early_movers_count = 0;
+	object_get_early_movers(&object_early_movers, &object_early_movers_count);
+
+	for (int32 object_early_mover_index = 0; object_early_mover_index < object_early_movers_count; object_early_mover_index++)
+	{
+		if (object_early_movers[object_early_mover_index] == object_index)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// returns false when the update of `object_index` is deferred to a later tick, otherwise `out_elapsed_ticks` is the
+// number of ticks the update has to cover
+bool object_scheduler_lod_update_begin(int32 object_index, int32* out_elapsed_ticks)
+{
+	s_object_scheduler_lod_globals* globals = &g_object_scheduler_lod_globals;
+	ASSERT(out_elapsed_ticks);
+
+	*out_elapsed_ticks = 1;
+
+	// only the updates of the object loop are scheduled, objects updated from anywhere else always run, early movers are
+	// updated first with the absolute index of the loop still at zero
+	int32 absolute_index = DATUM_INDEX_TO_ABSOLUTE_INDEX(object_index);
+	if (!globals->state
+		|| object_globals->object_update_absolute_index != absolute_index
+		|| !VALID_INDEX(absolute_index, k_maximum_object_scheduler_lod_objects)
+		|| object_scheduler_lod_early_mover(object_index))
+	{
+		return true;
+	}
+
+	const object_header_datum* object_header = object_header_get(object_index);
+	const object_datum* object = object_get(object_index);
+	int32 game_time = game_time_get();
+
+	s_object_scheduler_lod_object* lod_object = &globals->state->objects[absolute_index];
+	if (lod_object->object_index != object_index || lod_object->last_seen_time != game_time - 1)
+	{
+		// a new object, or one that slept through the last tick, starts over without anything to catch up on
+		csmemset(lod_object, 0, sizeof(s_object_scheduler_lod_object));
+		lod_object->object_index = object_index;
+		lod_object->vitality = object->object.body_vitality + object->object.shield_vitality;
+	}
+	lod_object->last_seen_time = game_time;
+
+	real32 vitality = object->object.body_vitality + object->object.shield_vitality;
+	bool damaged = vitality != lod_object->vitality;
+	lod_object->vitality = vitality;
+
+	int32 tier = globals->enabled && !damaged ? object_scheduler_lod_tier(object_index, object_header, object) : 0;
+	if (tier < lod_object->tier && lod_object->deferred_ticks > 0)
+	{
+		globals->current.objects_promoted++;
+	}
+	lod_object->tier = int8(tier);
+
+	int32 period = FLAG(tier);
+	bool bucket_tick = ((game_time + absolute_index) & (period - 1)) == 0;
+	if (!bucket_tick && lod_object->deferred_ticks + 1 < period)
+	{
+		lod_object->deferred_ticks++;
+		globals->current.objects_deferred[tier]++;
+		return false;
+	}
+
+	*out_elapsed_ticks = lod_object->deferred_ticks + 1;
+	lod_object->deferred_ticks = 0;
+	globals->current.objects_updated[tier]++;
+
+	return true;
+}
+
+void object_scheduler_lod_benchmark_start(int32 tick_count)
+{
+	s_object_scheduler_lod_globals* globals = &g_object_scheduler_lod_globals;
+	s_object_scheduler_lod_benchmark* benchmark = &globals->benchmark;
+
+	if (benchmark->running)
+	{
+		return;
+	}
+
+	csmemset(benchmark, 0, sizeof(s_object_scheduler_lod_benchmark));
+	benchmark->running = true;
+	benchmark->restore_enabled = globals->enabled;
+	benchmark->tick_count = MAX(tick_count, 1);
+	benchmark->phase = _object_scheduler_lod_benchmark_phase_disabled;
+	benchmark->ticks_remaining = benchmark->tick_count;
+	object_scheduler_lod_set_enabled(false);
+}
+
@@ -34,9 +34,100 @@ struct s_object_schedule_globals
 };
 static_assert(sizeof(s_object_schedule_globals) == 0x27C);
 
+// objects far from every player are updated less often, every tier halves the update rate of the one before it and
+// spreads its objects over its ticks by their absolute index, so the same objects update on the same ticks everywhere,
+// a deferred object runs its next update with the tick length stretched over every tick it missed,
+// objects that move, are attached, named for scripts, replicated to a predicting client or were damaged update every tick,
+// as do early movers and devices, whose functions don't follow the tick length
+
+// what every object missed is part of the game state, it is saved, reverted and loaded along with the objects
+
+enum
+{
+	k_object_scheduler_lod_tier_count = 4,
+	k_maximum_object_scheduler_lod_objects = 2048,
+};
+
+struct s_object_scheduler_lod_object
+{
+	// the object the absolute index belonged to when it was last seen
+	int32 object_index;
+	int32 last_seen_time;
+
+	real32 vitality;
+	int16 deferred_ticks;
+	int8 tier;
+};
+
+// name: "object scheduler lod"
+// type: "s_object_scheduler_lod_state"
+struct s_object_scheduler_lod_state
+{
+	s_object_scheduler_lod_object objects[k_maximum_object_scheduler_lod_objects];
+};
+
+struct s_object_scheduler_lod_counters
+{
+	int32 objects_updated[k_object_scheduler_lod_tier_count];
+	int32 objects_deferred[k_object_scheduler_lod_tier_count];
+	int32 objects_promoted;
+	int64 update_cycles;
+};
+
+enum e_object_scheduler_lod_benchmark_phase
+{
+	_object_scheduler_lod_benchmark_phase_disabled = 0,
+	_object_scheduler_lod_benchmark_phase_enabled,
+
+	k_object_scheduler_lod_benchmark_phase_count
+};
+
+struct s_object_scheduler_lod_benchmark
+{
+	bool running;
+	bool finished;
+	bool restore_enabled;
+	int32 tick_count;
+	int32 phase;
+	int32 ticks_remaining;
+
+	// `objects_update` cycles over the ticks of each phase
+	int64 cycles[k_object_scheduler_lod_benchmark_phase_count];
+	int32 objects_updated[k_object_scheduler_lod_benchmark_phase_count];
+};
+
+struct s_object_scheduler_lod_globals
+{
+	bool enabled;
+
+	// the distance from the nearest player past which every tier begins
+	real32 tier_distances[k_object_scheduler_lod_tier_count - 1];
+
+	int32 player_position_count;
+	real_point3d player_positions[k_maximum_players];
+
+	int32 state_member_index;
+	s_object_scheduler_lod_state* state;
+
+	s_object_scheduler_lod_counters current;
+	s_object_scheduler_lod_counters last_tick;
+
+	int32 tick_count;
+	s_object_scheduler_lod_counters totals;
+
+	s_object_scheduler_lod_benchmark benchmark;
+};
+
+extern s_object_scheduler_lod_globals g_object_scheduler_lod_globals;
+
 extern void __cdecl object_scheduler_dispose();
 extern void __cdecl object_scheduler_dispose_from_old_map();
 extern void __cdecl object_scheduler_initialize();
 extern void __cdecl object_scheduler_initialize_for_new_map();
 extern void __cdecl object_scheduler_update();
+extern void object_scheduler_lod_set_enabled(bool enabled);
+extern void object_scheduler_lod_tick_begin();
+extern void object_scheduler_lod_tick_end();
+extern bool object_scheduler_lod_update_begin(int32 object_index, int32* out_elapsed_ticks);
+extern void object_scheduler_lod_benchmark_start(int32 tick_count);
 
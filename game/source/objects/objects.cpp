@@ -3,10 +3,12 @@
 #include "cache/cache_files.hpp"
 #include "cache/restricted_memory_regions.hpp"
 #include "cseries/cseries_events.hpp"
+#include "game/game_time.hpp"
 #include "items/items.hpp"
 #include "memory/module.hpp"
 #include "memory/thread_local.hpp"
 #include "models/model_definitions.hpp"
+#include "objects/object_scheduler.hpp"
 #include "objects/object_types.hpp"
 #include "objects/watch_window.hpp"
 #include "physics/collision_models.hpp"
@@ -22,6 +24,7 @@
 
 HOOK_DECLARE(0x00B31590, object_placement_data_new);
 HOOK_DECLARE(0x00B32130, object_render_debug);
+HOOK_DECLARE(0x00B34630, object_update);
 
 s_object_override_globals object_override_globals;
 
@@ -1706,7 +1709,29 @@ void __cdecl object_unregister_scenario_object(int32 object_index)
 
 bool __cdecl object_update(int32 object_index)
 {
-	return INVOKE(0x00B34630, object_update, object_index);
+	//return INVOKE(0x00B34630, object_update, object_index);
+
+	int32 elapsed_ticks = 1;
+	if (!object_scheduler_lod_update_begin(object_index, &elapsed_ticks))
+	{
+		return false;
+	}
+
+	bool result = false;
+	if (elapsed_ticks > 1)
+	{
+		// a deferred object covers every tick it missed in a single update
+		real32 tick_length = game_time_globals->tick_length;
+		game_time_globals->tick_length = tick_length * elapsed_ticks;
+		HOOK_INVOKE(result =, object_update, object_index);
+		game_time_globals->tick_length = tick_length;
+	}
+	else
+	{
+		HOOK_INVOKE(result =, object_update, object_index);
+	}
+
+	return result;
 }
 
 void __cdecl object_update_collision_culling(int32 object_index)
@@ -1886,7 +1911,9 @@ void __cdecl objects_setup_structure_bsp_fake_lightprobes(int32 structure_bsp_in
 
 void __cdecl objects_update()
 {
+	object_scheduler_lod_tick_begin();
 	INVOKE(0x00B36840, objects_update);
+	object_scheduler_lod_tick_end();
 
 	//PROFILER(object_update)
 	//{
@@ -10,6 +10,7 @@
 #include "interface/user_interface.hpp"
 #include "main/global_preferences.hpp"
 #include "main/main.hpp"
+#include "main/main_headless.hpp"
 #include "memory/module.hpp"
 #include "memory/thread_local.hpp"
 #include "rasterizer/rasterizer_d3d_allocations.hpp"
@@ -448,7 +449,8 @@ void __cdecl c_rasterizer::shell_initialize(bool window_exists, bool windowed)
 	{
 		//set_render_resolution(1920, 1080, true);
 
-		if (c_rasterizer::initialize_device(window_exists, windowed))
+		// a headless server takes the same path as a device creation that left no device, without a window
+		if (main_headless_server() || c_rasterizer::initialize_device(window_exists, windowed))
 		{
 			if (c_rasterizer::g_device)
 			{
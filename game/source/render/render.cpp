@@ -18,6 +18,7 @@
 #include "render/render_lens_flares.hpp"
 #include "render/render_objects_static_lighting.hpp"
 #include "render/render_sky.hpp"
+#include "render/render_software_occlusion.hpp"
 #include "render/render_visibility_collection.hpp"
 #include "text/draw_string.hpp"
 
@@ -102,6 +103,8 @@ void __cdecl c_render_globals::increment_frame_index()
 void __cdecl render_dispose()
 {
 	INVOKE(0x00A296F0, render_dispose);
+
+	render_software_occlusion_dispose();
 }
 
 void __cdecl render_dispose_from_old_map()
@@ -46,6 +46,7 @@
 #include "structures/structure_detail_objects.hpp"
 #include "structures/structures.hpp"
 #include "text/draw_string.hpp"
+#include "text/font_glyph_cache.hpp"
 #include "visibility/visibility_collection.hpp"
 
 #include <math.h>
@@ -477,6 +478,7 @@ void __cdecl render_debug_clients(int32 user_index)
 	texture_cache_debug_render();
 	sound_cache_debug_render();
 	file_activity_debug_render();
+	font_glyph_cache_render_debug();
 
 	if (game_in_progress())
 	{
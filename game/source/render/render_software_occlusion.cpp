@@ -0,0 +1,859 @@
+#include "render/render_software_occlusion.hpp"
+
+#include "cseries/cseries_events.hpp"
+#include "cseries/cseries_system_memory.hpp"
+#include "multithreading/job_system.hpp"
+#include "physics/collision_bsp_references.hpp"
+#include "physics/collision_references.hpp"
+#include "profiler/profiler_stopwatch.hpp"
+#include "render/render_cameras.hpp"
+#include "render/render_structure.hpp"
+#include "scenario/scenario.hpp"
+
+#include <math.h>
+#include <xmmintrin.h>
+
+enum
+{
+	// surfaces smaller than this hide too little to be worth their rasterization
+	k_render_software_occlusion_minimum_surface_area = 1,
+
+	k_render_software_occlusion_maximum_surface_edges = 64,
+};
+
+// occluders farther away than this cover a handful of pixels at most
+real32 const k_render_software_occlusion_maximum_occluder_distance = 40.0f;
+
+s_render_software_occlusion_globals g_render_software_occlusion_globals
+{
+	.enabled = false,
+	.worker_count = k_render_software_occlusion_default_worker_count,
+	.scenario_index = NONE,
+	.active_view_index = NONE,
+};
+
+static c_stop_watch* render_software_occlusion_stop_watch()
+{
+	static c_stop_watch stop_watch(true);
+	return &stop_watch;
+}
+
+template<typename t_collision_bsp>
+static int32 render_software_occlusion_gather_triangles(c_collision_bsp_reference bsp_reference, const t_collision_bsp* bsp, s_render_software_occlusion_triangle* triangles, int32 maximum_triangle_count)
+{
+	int32 triangle_count = 0;
+	for (int32 surface_index = 0; surface_index < bsp->surfaces.count && triangle_count < maximum_triangle_count; surface_index++)
+	{
+		c_collision_surface_reference surface_reference(bsp_reference, surface_index);
+
+		// glass and invisible walls can be seen through, and a two-sided surface has no side that's solid behind it
+		uns8 surface_flags = surface_reference.get_flags();
+		if (TEST_BIT(surface_flags, _collision_surface_two_sided_bit)
+			|| TEST_BIT(surface_flags, _collision_surface_invisible_bit)
+			|| TEST_BIT(surface_flags, _collision_surface_breakable_bit)
+			|| TEST_BIT(surface_flags, _collision_surface_invalid_bit))
+		{
+			continue;
+		}
+
+		real_point3d points[k_render_software_occlusion_maximum_surface_edges];
+		int32 point_count = 0;
+
+		int32 first_edge_index = surface_reference.get_first_edge_index();
+		int32 edge_index = first_edge_index;
+		do
+		{
+			c_collision_edge_reference edge_reference(bsp_reference, edge_index);
+			int32 side = edge_reference.get_surface_index(0) == surface_index ? 0 : 1;
+
+			c_collision_vertex_reference vertex_reference(bsp_reference, edge_reference.get_vertex_index(side));
+			points[point_count++] = *vertex_reference.get_position();
+			edge_index = edge_reference.get_edge_index(side);
+		} while (edge_index != first_edge_index && edge_index != NONE && point_count < NUMBEROF(points));
+
+		if (edge_index != first_edge_index || point_count < 3)
+		{
+			continue;
+		}
+
+		real_plane3d plane_storage{};
+		const real_plane3d* plane = surface_reference.get_plane(&plane_storage);
+
+		// the surface polygons are convex, a fan covers them
+		real32 area = 0.0f;
+		for (int32 point_index = 2; point_index < point_count; point_index++)
+		{
+			real_vector3d edge0{ points[point_index - 1].x - points[0].x, points[point_index - 1].y - points[0].y, points[point_index - 1].z - points[0].z };
+			real_vector3d edge1{ points[point_index].x - points[0].x, points[point_index].y - points[0].y, points[point_index].z - points[0].z };
+			real_vector3d normal{};
+			cross_product3d(&edge0, &edge1, &normal);
+			area += 0.5f * sqrtf(dot_product3d(&normal, &normal));
+		}
+
+		if (area < k_render_software_occlusion_minimum_surface_area)
+		{
+			continue;
+		}
+
+		for (int32 point_index = 2; point_index < point_count && triangle_count < maximum_triangle_count; point_index++)
+		{
+			s_render_software_occlusion_triangle* triangle = &triangles[triangle_count++];
+			triangle->points[0] = points[0];
+			triangle->points[1] = points[point_index - 1];
+			triangle->points[2] = points[point_index];
+			triangle->plane = *plane;
+		}
+	}
+
+	return triangle_count;
+}
+
+static void render_software_occlusion_structure_bsps_dispose()
+{
+	for (int32 structure_bsp_index = 0; structure_bsp_index < k_maximum_render_software_occlusion_structure_bsps; structure_bsp_index++)
+	{
+		s_render_software_occlusion_structure_bsp* structure_bsp = &g_render_software_occlusion_globals.structure_bsps[structure_bsp_index];
+		if (structure_bsp->triangles)
+		{
+			system_free(structure_bsp->triangles);
+		}
+		csmemset(structure_bsp, 0, sizeof(s_render_software_occlusion_structure_bsp));
+	}
+}
+
+static const s_render_software_occlusion_structure_bsp* render_software_occlusion_structure_bsp_get(int32 structure_bsp_index)
+{
+	s_render_software_occlusion_globals* globals = &g_render_software_occlusion_globals;
+	if (globals->scenario_index != global_scenario_index || globals->active_structure_bsp_mask != g_active_structure_bsp_mask)
+	{
+		render_software_occlusion_structure_bsps_dispose();
+		globals->scenario_index = global_scenario_index;
+		globals->active_structure_bsp_mask = g_active_structure_bsp_mask;
+	}
+
+	if (!VALID_INDEX(structure_bsp_index, k_maximum_render_software_occlusion_structure_bsps) || !global_structure_bsp_is_active(structure_bsp_index))
+	{
+		return NULL;
+	}
+
+	s_render_software_occlusion_structure_bsp* structure_bsp = &globals->structure_bsps[structure_bsp_index];
+	if (!structure_bsp->built)
+	{
+		structure_bsp->built = true;
+
+		c_collision_bsp_reference bsp_reference(global_structure_bsp_get(structure_bsp_index));
+		if (!bsp_reference.valid())
+		{
+			return NULL;
+		}
+
+		structure_bsp->triangles = (s_render_software_occlusion_triangle*)system_malloc(k_maximum_render_software_occlusion_bsp_triangles * sizeof(s_render_software_occlusion_triangle));
+		if (!structure_bsp->triangles)
+		{
+			event(_event_warning, "render:occlusion: failed to allocate occluders for structure bsp %d", structure_bsp_index);
+			return NULL;
+		}
+
+		structure_bsp->triangle_count = bsp_reference.is_small() ?
+			render_software_occlusion_gather_triangles(bsp_reference, bsp_reference.get_small_bsp(), structure_bsp->triangles, k_maximum_render_software_occlusion_bsp_triangles) :
+			render_software_occlusion_gather_triangles(bsp_reference, bsp_reference.get_large_bsp(), structure_bsp->triangles, k_maximum_render_software_occlusion_bsp_triangles);
+	}
+
+	return structure_bsp->triangles ? structure_bsp : NULL;
+}
+
+static void render_software_occlusion_view_point(const s_render_software_occlusion_view* view, const real_point3d* point, real32* out_lateral, real32* out_vertical, real32* out_depth)
+{
+	real_vector3d offset{ point->x - view->position.x, point->y - view->position.y, point->z - view->position.z };
+
+	// screen x grows to the right and screen y grows down
+	*out_lateral = -dot_product3d(&offset, &view->left);
+	*out_vertical = -dot_product3d(&offset, &view->up);
+	*out_depth = dot_product3d(&offset, &view->forward);
+}
+
+static void render_software_occlusion_camera_from_render_camera(const render_camera* camera, s_render_software_occlusion_camera* occlusion_camera)
+{
+	int32 width = camera->render_pixel_bounds.x1 - camera->render_pixel_bounds.x0;
+	int32 height = camera->render_pixel_bounds.y1 - camera->render_pixel_bounds.y0;
+
+	csmemset(occlusion_camera, 0, sizeof(s_render_software_occlusion_camera));
+	occlusion_camera->position = camera->position;
+	occlusion_camera->forward = camera->forward;
+	occlusion_camera->up = camera->up;
+	occlusion_camera->vertical_field_of_view = camera->vertical_field_of_view;
+	occlusion_camera->aspect_ratio = height > 0 ? real32(width) / real32(height) : 1.0f;
+	occlusion_camera->near_distance = camera->z_near;
+}
+
+static void render_software_occlusion_view_build(s_render_software_occlusion_view_context* context, const s_render_software_occlusion_camera* camera)
+{
+	s_render_software_occlusion_view* view = &context->view;
+
+	context->prepared = false;
+	context->camera = *camera;
+	context->screen_triangle_count = 0;
+	csmemset(&context->statistics, 0, sizeof(context->statistics));
+
+	view->position = camera->position;
+	view->forward = camera->forward;
+	cross_product3d(&camera->up, &camera->forward, &view->left);
+	normalize3d(&view->left);
+	cross_product3d(&camera->forward, &view->left, &view->up);
+	view->near_distance = MAX(camera->near_distance, k_real_epsilon);
+
+	real32 tangent = tanf(0.5f * camera->vertical_field_of_view);
+	view->scale_y = (0.5f * k_render_software_occlusion_height) / tangent;
+	view->scale_x = (0.5f * k_render_software_occlusion_width) / (tangent * camera->aspect_ratio);
+}
+
+// front facing triangles entirely in front of the near plane and within reach, projected and wound clockwise on screen
+static void render_software_occlusion_project_triangles(s_render_software_occlusion_view_context* context, const s_render_software_occlusion_triangle* triangles, int32 triangle_count)
+{
+	const s_render_software_occlusion_view* view = &context->view;
+
+	real32 const center_x = 0.5f * k_render_software_occlusion_width;
+	real32 const center_y = 0.5f * k_render_software_occlusion_height;
+	real32 const maximum_distance_squared = k_render_software_occlusion_maximum_occluder_distance * k_render_software_occlusion_maximum_occluder_distance;
+
+	for (int32 triangle_index = 0; triangle_index < triangle_count && context->screen_triangle_count < k_maximum_render_software_occlusion_view_triangles; triangle_index++)
+	{
+		const s_render_software_occlusion_triangle* triangle = &triangles[triangle_index];
+		if (plane3d_distance_to_point(&triangle->plane, &view->position) <= 0.0f)
+		{
+			continue;
+		}
+
+		s_render_software_occlusion_screen_triangle screen_triangle{};
+		bool visible = true;
+		bool near_enough = false;
+		for (int32 point_index = 0; visible && point_index < 3; point_index++)
+		{
+			const real_point3d* point = &triangle->points[point_index];
+			real_vector3d offset{ point->x - view->position.x, point->y - view->position.y, point->z - view->position.z };
+			near_enough |= dot_product3d(&offset, &offset) < maximum_distance_squared;
+
+			real32 lateral;
+			real32 vertical;
+			real32 depth;
+			render_software_occlusion_view_point(view, point, &lateral, &vertical, &depth);
+
+			// dropping an occluder that crosses the near plane only costs culling, clipping it isn't worth the work
+			visible = depth > view->near_distance;
+			screen_triangle.points[point_index].x = center_x + view->scale_x * lateral / depth;
+			screen_triangle.points[point_index].y = center_y + view->scale_y * vertical / depth;
+			screen_triangle.farthest_depth = MAX(screen_triangle.farthest_depth, depth);
+		}
+
+		if (!visible || !near_enough)
+		{
+			continue;
+		}
+
+		const real_point2d* p = screen_triangle.points;
+		real32 signed_area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[1].y - p[0].y) * (p[2].x - p[0].x);
+		if (signed_area == 0.0f)
+		{
+			continue;
+		}
+
+		if (signed_area < 0.0f)
+		{
+			real_point2d swap = screen_triangle.points[1];
+			screen_triangle.points[1] = screen_triangle.points[2];
+			screen_triangle.points[2] = swap;
+		}
+
+		context->screen_triangles[context->screen_triangle_count++] = screen_triangle;
+	}
+}
+
+static void render_software_occlusion_rasterize_rows(s_render_software_occlusion_view_context* context, int32 first_row, int32 row_count)
+{
+	int32 last_row = first_row + row_count;
+	for (int32 row = first_row; row < last_row; row++)
+	{
+		real32* depth_row = context->depth[row];
+		for (int32 column = 0; column < k_render_software_occlusion_width; column += 4)
+		{
+			_mm_store_ps(&depth_row[column], _mm_set1_ps(k_real_max));
+		}
+	}
+
+	const __m128 pixel_offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+
+	for (int32 triangle_index = 0; triangle_index < context->screen_triangle_count; triangle_index++)
+	{
+		const s_render_software_occlusion_screen_triangle* triangle = &context->screen_triangles[triangle_index];
+		const real_point2d* p = triangle->points;
+
+		int32 x0 = MAX(int32(floorf(MIN(MIN(p[0].x, p[1].x), p[2].x))), 0) & ~3;
+		int32 x1 = MIN(int32(ceilf(MAX(MAX(p[0].x, p[1].x), p[2].x))), k_render_software_occlusion_width);
+		int32 y0 = MAX(int32(floorf(MIN(MIN(p[0].y, p[1].y), p[2].y))), first_row);
+		int32 y1 = MIN(int32(ceilf(MAX(MAX(p[0].y, p[1].y), p[2].y))), last_row);
+		if (x0 >= x1 || y0 >= y1)
+		{
+			continue;
+		}
+
+		// edge functions are positive inside, pixels are sampled at their centers so neighbouring triangles leave no cracks
+		__m128 edge_a[3];
+		__m128 edge_b[3];
+		__m128 edge_c[3];
+		for (int32 edge_index = 0; edge_index < 3; edge_index++)
+		{
+			const real_point2d* from = &p[edge_index];
+			const real_point2d* to = &p[(edge_index + 1) % 3];
+			real32 a = from->y - to->y;
+			real32 b = to->x - from->x;
+			real32 c = -(a * from->x + b * from->y);
+			edge_a[edge_index] = _mm_set1_ps(a);
+			edge_b[edge_index] = _mm_set1_ps(b);
+			edge_c[edge_index] = _mm_set1_ps(c);
+		}
+
+		const __m128 triangle_depth = _mm_set1_ps(triangle->farthest_depth);
+		for (int32 row = y0; row < y1; row++)
+		{
+			__m128 pixel_y = _mm_set1_ps(row + 0.5f);
+			real32* depth_row = context->depth[row];
+			for (int32 column = x0; column < x1; column += 4)
+			{
+				__m128 pixel_x = _mm_add_ps(_mm_set1_ps(real32(column)), pixel_offsets);
+				__m128 inside = _mm_cmpeq_ps(pixel_x, pixel_x);
+				for (int32 edge_index = 0; edge_index < 3; edge_index++)
+				{
+					__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge_a[edge_index], pixel_x), _mm_mul_ps(edge_b[edge_index], pixel_y)), edge_c[edge_index]);
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+				}
+
+				if (_mm_movemask_ps(inside) == 0)
+				{
+					continue;
+				}
+
+				__m128 depth = _mm_load_ps(&depth_row[column]);
+				__m128 nearer = _mm_min_ps(depth, triangle_depth);
+				_mm_store_ps(&depth_row[column], _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, depth)));
+			}
+		}
+	}
+}
+
+static void render_software_occlusion_run_job(int32 job_index)
+{
+	s_render_software_occlusion_globals* globals = &g_render_software_occlusion_globals;
+
+	switch (globals->job_type)
+	{
+	case _render_software_occlusion_job_project:
+	{
+		s_render_software_occlusion_view_context* context = &globals->views[globals->job_first_view_index + job_index];
+		for (int32 occluder_index = 0; occluder_index < globals->job_occluder_count; occluder_index++)
+		{
+			const s_render_software_occlusion_occluders* occluders = &globals->job_occluders[occluder_index];
+			render_software_occlusion_project_triangles(context, occluders->triangles, occluders->triangle_count);
+		}
+	}
+	break;
+	case _render_software_occlusion_job_rasterize:
+	{
+		// every job owns a band of rows of one view, so no two threads ever write the same pixel
+		s_render_software_occlusion_view_context* context = &globals->views[globals->job_first_view_index + job_index / globals->job_band_count];
+		int32 band_index = job_index % globals->job_band_count;
+		int32 first_row = (k_render_software_occlusion_height * band_index) / globals->job_band_count;
+		int32 last_row = (k_render_software_occlusion_height * (band_index + 1)) / globals->job_band_count;
+		render_software_occlusion_rasterize_rows(context, first_row, last_row - first_row);
+	}
+	break;
+	default:
+	{
+		UNREACHABLE();
+	}
+	break;
+	}
+}
+
+static void __cdecl render_software_occlusion_job_proc(void* context, int32 job_index)
+{
+	render_software_occlusion_run_job(job_index);
+}
+
+static void render_software_occlusion_dispatch(e_render_software_occlusion_job_type job_type, int32 job_count, int32 worker_count)
+{
+	g_render_software_occlusion_globals.job_type = job_type;
+	job_system_run(render_software_occlusion_job_proc, NULL, job_count, worker_count);
+}
+
+static void render_software_occlusion_gather_structure_occluders()
+{
+	s_render_software_occlusion_globals* globals = &g_render_software_occlusion_globals;
+
+	// the caches are built here on the calling thread, the workers only ever read them
+	globals->job_occluder_count = 0;
+	for (int32 structure_bsp_index = 0; structure_bsp_index < k_maximum_render_software_occlusion_structure_bsps; structure_bsp_index++)
+	{
+		if (const s_render_software_occlusion_structure_bsp* structure_bsp = render_software_occlusion_structure_bsp_get(structure_bsp_index))
+		{
+			s_render_software_occlusion_occluders* occluders = &globals->job_occluders[globals->job_occluder_count++];
+			occluders->triangles = structure_bsp->triangles;
+			occluders->triangle_count = structure_bsp->triangle_count;
+		}
+	}
+}
+
+// builds views `first_view_index` through `first_view_index + view_count` from the occluders gathered for the batch,
+// projecting spreads the views over the workers and rasterizing splits every view into enough bands to keep them all busy
+static int64 render_software_occlusion_build_views(int32 first_view_index, const s_render_software_occlusion_camera* cameras, int32 view_count, int32 worker_count)
+{
+	s_render_software_occlusion_globals* globals = &g_render_software_occlusion_globals;
+	ASSERT(first_view_index >= 0 && first_view_index + view_count <= k_maximum_render_software_occlusion_views);
+
+	c_stop_watch* stop_watch = render_software_occlusion_stop_watch();
+	stop_watch->reset();
+	stop_watch->start();
+
+	for (int32 view_index = 0; view_index < view_count; view_index++)
+	{
+		render_software_occlusion_view_build(&globals->views[first_view_index + view_index], &cameras[view_index]);
+	}
+
+	globals->job_first_view_index = first_view_index;
+	globals->job_band_count = MAX(worker_count / MAX(view_count, 1), 1);
+	render_software_occlusion_dispatch(_render_software_occlusion_job_project, view_count, worker_count);
+	render_software_occlusion_dispatch(_render_software_occlusion_job_rasterize, view_count * globals->job_band_count, worker_count);
+
+	// the views were built together, each one is charged an even share of the batch
+	int64 cycles = stop_watch->stop();
+	for (int32 view_index = 0; view_index < view_count; view_index++)
+	{
+		s_render_software_occlusion_view_context* context = &globals->views[first_view_index + view_index];
+		context->prepared = true;
+		context->statistics.occluder_count = context->screen_triangle_count;
+		context->statistics.rasterize_cycles = cycles / view_count;
+	}
+
+	return cycles;
+}
+
+void render_software_occlusion_dispose()
+{
+	render_software_occlusion_structure_bsps_dispose();
+	g_render_software_occlusion_globals.scenario_index = NONE;
+}
+
+void render_software_occlusion_set_mode(bool enabled, int32 worker_count)
+{
+	g_render_software_occlusion_globals.enabled = enabled;
+	g_render_software_occlusion_globals.worker_count = PIN(worker_count, 0, k_maximum_render_software_occlusion_workers);
+}
+
+void render_software_occlusion_prepare_views(const render_camera* const* cameras, int32 camera_count)
+{
+	s_render_software_occlusion_globals* globals = &g_render_software_occlusion_globals;
+
+	for (int32 view_index = 0; view_index < k_maximum_render_software_occlusion_views; view_index++)
+	{
+		globals->views[view_index].prepared = false;
+	}
+
+	if (!globals->enabled)
+	{
+		return;
+	}
+
+	// cameras are indexed by player window
+	int32 view_count = 0;
+	s_render_software_occlusion_camera occlusion_cameras[k_maximum_render_software_occlusion_prepared_views]{};
+	for (int32 camera_index = 0; camera_index < camera_count && view_count < k_maximum_render_software_occlusion_prepared_views; camera_index++)
+	{
+		if (!cameras[camera_index]->mirrored)
+		{
+			globals->views[view_count].player_window_index = camera_index;
+			render_software_occlusion_camera_from_render_camera(cameras[camera_index], &occlusion_cameras[view_count++]);
+		}
+	}
+
+	globals->captured_camera_count = view_count;
+	csmemcpy(globals->captured_cameras, occlusion_cameras, sizeof(s_render_software_occlusion_camera) * view_count);
+
+	if (view_count > 0)
+	{
+		render_software_occlusion_gather_structure_occluders();
+		render_software_occlusion_build_views(0, occlusion_cameras, view_count, globals->worker_count);
+	}
+}
+
+void render_software_occlusion_view_begin(const render_camera* camera, int32 player_window_index)
+{
+	s_render_software_occlusion_globals* globals = &g_render_software_occlusion_globals;
+
+	globals->active_view_index = NONE;
+	csmemset(&globals->last_view, 0, sizeof(globals->last_view));
+	if (!globals->enabled || camera->mirrored)
+	{
+		return;
+	}
+
+	s_render_software_occlusion_camera occlusion_camera{};
+	render_software_occlusion_camera_from_render_camera(camera, &occlusion_camera);
+
+	int32 prepared_view_index = NONE;
+	for (int32 view_index = 0; view_index < k_maximum_render_software_occlusion_prepared_views; view_index++)
+	{
+		const s_render_software_occlusion_view_context* context = &globals->views[view_index];
+		if (context->prepared && context->player_window_index == player_window_index)
+		{
+			prepared_view_index = view_index;
+			break;
+		}
+	}
+
+	int32 view_index = prepared_view_index;
+	bool mismatched = prepared_view_index != NONE && csmemcmp(&globals->views[prepared_view_index].camera, &occlusion_camera, sizeof(occlusion_camera)) != 0;
+	if (mismatched && !globals->mismatch_warned)
+	{
+		event(_event_warning, "render:occlusion: player window %d collected with another camera than its view was prepared from, building it again",
+			player_window_index);
+		globals->mismatch_warned = true;
+	}
+
+	// texture cameras and anything else that wasn't known up front are built on the spot
+	if (prepared_view_index == NONE || mismatched)
+	{
+		view_index = k_render_software_occlusion_unprepared_view_index;
+		render_software_occlusion_gather_structure_occluders();
+		render_software_occlusion_build_views(view_index, &occlusion_camera, 1, globals->worker_count);
+	}
+
+	s_render_software_occlusion_view_context* context = &globals->views[view_index];
+	context->prepared = false;
+	context->statistics.view_count = 1;
+	context->statistics.prepared_view_count = prepared_view_index != NONE && !mismatched ? 1 : 0;
+	context->statistics.unprepared_view_count = prepared_view_index == NONE ? 1 : 0;
+	context->statistics.mismatched_view_count = mismatched ? 1 : 0;
+	if (mismatched)
+	{
+		globals->views[prepared_view_index].prepared = false;
+	}
+	if (context->screen_triangle_count > 0)
+	{
+		globals->active_view_index = view_index;
+	}
+	globals->last_view = context->statistics;
+}
+
+void render_software_occlusion_view_end()
+{
+	s_render_software_occlusion_globals* globals = &g_render_software_occlusion_globals;
+
+	if (VALID_INDEX(globals->active_view_index, k_maximum_render_software_occlusion_views))
+	{
+		globals->last_view = globals->views[globals->active_view_index].statistics;
+	}
+	globals->active_view_index = NONE;
+
+	globals->totals.view_count += globals->last_view.view_count;
+	globals->totals.prepared_view_count += globals->last_view.prepared_view_count;
+	globals->totals.unprepared_view_count += globals->last_view.unprepared_view_count;
+	globals->totals.mismatched_view_count += globals->last_view.mismatched_view_count;
+	globals->totals.occluder_count += globals->last_view.occluder_count;
+	globals->totals.objects_tested += globals->last_view.objects_tested;
+	globals->totals.objects_rejected += globals->last_view.objects_rejected;
+	globals->totals.rasterize_cycles += globals->last_view.rasterize_cycles;
+	globals->totals.test_cycles += globals->last_view.test_cycles;
+}
+
+static bool render_software_occlusion_sphere_occluded_internal(const s_render_software_occlusion_view_context* context, const real_point3d* center, real32 radius)
+{
+	const s_render_software_occlusion_view* view = &context->view;
+
+	real32 lateral;
+	real32 vertical;
+	real32 depth;
+	render_software_occlusion_view_point(view, center, &lateral, &vertical, &depth);
+
+	real32 nearest_depth = depth - radius;
+	real32 farthest_depth = depth + radius;
+	if (nearest_depth <= view->near_distance)
+	{
+		return false;
+	}
+
+	// the screen bounds of every point of the sphere, each offset divided by whichever depth makes it largest
+	real32 left = (lateral - radius) / ((lateral - radius) < 0.0f ? nearest_depth : farthest_depth);
+	real32 right = (lateral + radius) / ((lateral + radius) > 0.0f ? nearest_depth : farthest_depth);
+	real32 top = (vertical - radius) / ((vertical - radius) < 0.0f ? nearest_depth : farthest_depth);
+	real32 bottom = (vertical + radius) / ((vertical + radius) > 0.0f ? nearest_depth : farthest_depth);
+
+	real32 const center_x = 0.5f * k_render_software_occlusion_width;
+	real32 const center_y = 0.5f * k_render_software_occlusion_height;
+
+	// grown by a pixel, a pixel is covered as soon as its center is, so an occluder edge can be up to half a pixel short
+	int32 x0 = int32(floorf(center_x + view->scale_x * left)) - 1;
+	int32 x1 = int32(ceilf(center_x + view->scale_x * right)) + 1;
+	int32 y0 = int32(floorf(center_y + view->scale_y * top)) - 1;
+	int32 y1 = int32(ceilf(center_y + view->scale_y * bottom)) + 1;
+
+	// anything reaching past the edges of the buffer could be seen past the occluders it holds
+	if (x0 < 0 || y0 < 0 || x1 > k_render_software_occlusion_width || y1 > k_render_software_occlusion_height || x0 >= x1 || y0 >= y1)
+	{
+		return false;
+	}
+
+	const __m128 sphere_depth = _mm_set1_ps(nearest_depth);
+	for (int32 row = y0; row < y1; row++)
+	{
+		const real32* depth_row = context->depth[row];
+		int32 column = x0;
+		for (; column + 4 <= x1; column += 4)
+		{
+			if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(&depth_row[column]), sphere_depth)) != 0)
+			{
+				return false;
+			}
+		}
+
+		for (; column < x1; column++)
+		{
+			if (depth_row[column] >= nearest_depth)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool render_software_occlusion_sphere_occluded(const real_point3d* center, real32 radius)
+{
+	s_render_software_occlusion_globals* globals = &g_render_software_occlusion_globals;
+	if (!VALID_INDEX(globals->active_view_index, k_maximum_render_software_occlusion_views))
+	{
+		return false;
+	}
+
+	s_render_software_occlusion_view_context* context = &globals->views[globals->active_view_index];
+
+	c_stop_watch* stop_watch = render_software_occlusion_stop_watch();
+	stop_watch->reset();
+	stop_watch->start();
+
+	bool occluded = render_software_occlusion_sphere_occluded_internal(context, center, radius);
+
+	context->statistics.test_cycles += stop_watch->stop();
+	context->statistics.objects_tested++;
+	context->statistics.objects_rejected += occluded ? 1 : 0;
+
+	return occluded;
+}
+
+enum
+{
+	k_render_software_occlusion_wall_rows = 8,
+	k_render_software_occlusion_wall_columns = 8,
+	k_render_software_occlusion_wall_triangle_count = k_render_software_occlusion_wall_rows * k_render_software_occlusion_wall_columns * 2,
+};
+
+real32 const k_render_software_occlusion_wall_distance = 10.0f;
+real32 const k_render_software_occlusion_wall_half_extent = 4.0f;
+
+// a wall of large triangles facing the origin ten units down +x
+static const s_render_software_occlusion_triangle* render_software_occlusion_benchmark_wall()
+{
+	static s_render_software_occlusion_triangle wall[k_render_software_occlusion_wall_triangle_count];
+	real32 const cell_size = (2.0f * k_render_software_occlusion_wall_half_extent) / k_render_software_occlusion_wall_rows;
+
+	int32 triangle_count = 0;
+	for (int32 row = 0; row < k_render_software_occlusion_wall_rows; row++)
+	{
+		for (int32 column = 0; column < k_render_software_occlusion_wall_columns; column++)
+		{
+			real32 y0 = -k_render_software_occlusion_wall_half_extent + column * cell_size;
+			real32 z0 = -k_render_software_occlusion_wall_half_extent + row * cell_size;
+			real_point3d corners[4]
+			{
+				{ k_render_software_occlusion_wall_distance, y0, z0 },
+				{ k_render_software_occlusion_wall_distance, y0 + cell_size, z0 },
+				{ k_render_software_occlusion_wall_distance, y0 + cell_size, z0 + cell_size },
+				{ k_render_software_occlusion_wall_distance, y0, z0 + cell_size },
+			};
+
+			real_plane3d plane{ { -1.0f, 0.0f, 0.0f }, -k_render_software_occlusion_wall_distance };
+			wall[triangle_count++] = { { corners[0], corners[1], corners[2] }, plane };
+			wall[triangle_count++] = { { corners[0], corners[2], corners[3] }, plane };
+		}
+	}
+
+	return wall;
+}
+
+// spheres spread in front of the wall, behind it and to the sides where it doesn't reach,
+// the ones fully behind the wall are the only ones that should be rejected
+bool render_software_occlusion_benchmark(int32 iterations, s_render_software_occlusion_benchmark_result* result)
+{
+	ASSERT(result);
+
+	s_render_software_occlusion_globals* globals = &g_render_software_occlusion_globals;
+	csmemset(result, 0, sizeof(s_render_software_occlusion_benchmark_result));
+
+	// the benchmark borrows the unprepared view, nothing may be collecting with it
+	if (globals->active_view_index != NONE)
+	{
+		return false;
+	}
+
+	enum
+	{
+		k_sphere_grid = 16,
+	};
+
+	globals->job_occluder_count = 1;
+	globals->job_occluders[0].triangles = render_software_occlusion_benchmark_wall();
+	globals->job_occluders[0].triangle_count = k_render_software_occlusion_wall_triangle_count;
+
+	s_render_software_occlusion_camera camera{};
+	camera.position = { 0.0f, 0.0f, 0.0f };
+	camera.forward = { 1.0f, 0.0f, 0.0f };
+	camera.up = { 0.0f, 0.0f, 1.0f };
+	camera.vertical_field_of_view = 70.0f * DEG;
+	camera.aspect_ratio = 16.0f / 9.0f;
+	camera.near_distance = 0.05f;
+
+	int32 const view_index = k_render_software_occlusion_unprepared_view_index;
+	const s_render_software_occlusion_view_context* context = &globals->views[view_index];
+
+	c_stop_watch* stop_watch = render_software_occlusion_stop_watch();
+	iterations = MAX(iterations, 1);
+
+	int64 serial_cycles = 0;
+	int64 parallel_cycles = 0;
+	for (int32 iteration = 0; iteration < iterations; iteration++)
+	{
+		serial_cycles += render_software_occlusion_build_views(view_index, &camera, 1, 0);
+		parallel_cycles += render_software_occlusion_build_views(view_index, &camera, 1, MAX(globals->worker_count, 1));
+	}
+	result->serial_rasterize_milliseconds = real32(1000.0 * c_stop_watch::cycles_to_seconds(serial_cycles) / iterations);
+	result->parallel_rasterize_milliseconds = real32(1000.0 * c_stop_watch::cycles_to_seconds(parallel_cycles) / iterations);
+	result->occluder_count = context->screen_triangle_count;
+
+	bool passed = result->occluder_count == k_render_software_occlusion_wall_triangle_count;
+
+	int64 test_cycles = 0;
+	for (int32 x_index = 0; x_index < k_sphere_grid; x_index++)
+	{
+		for (int32 y_index = 0; y_index < k_sphere_grid; y_index++)
+		{
+			real_point3d center{ 2.0f + 2.0f * x_index, -8.0f + y_index, 0.0f };
+			real32 radius = 0.5f;
+
+			// hidden exactly when the sphere is behind the wall and inside the pyramid the wall cuts out of the view,
+			// the sphere must be rejected when it's a few pixels inside that pyramid and must never be rejected outside it
+			real32 side_length = sqrtf(k_render_software_occlusion_wall_half_extent * k_render_software_occlusion_wall_half_extent + k_render_software_occlusion_wall_distance * k_render_software_occlusion_wall_distance);
+			real32 side_distance = (k_render_software_occlusion_wall_half_extent * center.x - k_render_software_occlusion_wall_distance * fabsf(center.y)) / side_length;
+			real32 top_distance = (k_render_software_occlusion_wall_half_extent * center.x - k_render_software_occlusion_wall_distance * fabsf(center.z)) / side_length;
+			real32 pixel_margin = 4.0f * center.x / MIN(context->view.scale_x, context->view.scale_y);
+			bool behind = center.x - radius > k_render_software_occlusion_wall_distance;
+			bool hidden = behind && side_distance >= radius && top_distance >= radius;
+			bool expected = behind && side_distance >= radius + pixel_margin && top_distance >= radius + pixel_margin;
+
+			stop_watch->reset();
+			stop_watch->start();
+			bool occluded = render_software_occlusion_sphere_occluded_internal(context, &center, radius);
+			test_cycles += stop_watch->stop();
+
+			result->sphere_count++;
+			result->spheres_rejected += occluded ? 1 : 0;
+			result->expected_spheres_rejected += expected ? 1 : 0;
+
+			if ((occluded && !hidden) || (expected && !occluded))
+			{
+				event(_event_warning, "render:occlusion: sphere at %.1f %.1f was %s",
+					center.x,
+					center.y,
+					occluded ? "rejected but can be seen" : "kept but is hidden");
+				passed = false;
+			}
+		}
+	}
+	result->test_microseconds = real32(1000000.0 * c_stop_watch::cycles_to_seconds(test_cycles) / MAX(result->sphere_count, 1));
+	result->self_test_passed = passed;
+
+	globals->views[view_index].prepared = false;
+
+	return passed;
+}
+
+// builds the occlusion depth buffers of one to four views at once, serially and on the workers, from the cameras of the
+// last frame that prepared any, without a map loaded the views are spread around the benchmark wall instead, the camera
+// visibility collections are not timed as they still run one view after another
+void render_software_occlusion_prepare_views_benchmark(int32 iterations, s_render_software_occlusion_prepare_views_benchmark_result* result)
+{
+	ASSERT(result);
+
+	s_render_software_occlusion_globals* globals = &g_render_software_occlusion_globals;
+	csmemset(result, 0, sizeof(s_render_software_occlusion_prepare_views_benchmark_result));
+
+	if (globals->active_view_index != NONE)
+	{
+		return;
+	}
+
+	s_render_software_occlusion_camera cameras[k_maximum_render_software_occlusion_prepared_views]{};
+	result->captured_cameras = globals->captured_camera_count > 0;
+	if (result->captured_cameras)
+	{
+		// split-screen has a camera per window, a single window is repeated so every view count has something to build
+		for (int32 camera_index = 0; camera_index < k_maximum_render_software_occlusion_prepared_views; camera_index++)
+		{
+			cameras[camera_index] = globals->captured_cameras[camera_index % globals->captured_camera_count];
+		}
+		render_software_occlusion_gather_structure_occluders();
+	}
+	else
+	{
+		for (int32 camera_index = 0; camera_index < k_maximum_render_software_occlusion_prepared_views; camera_index++)
+		{
+			s_render_software_occlusion_camera* camera = &cameras[camera_index];
+			camera->position = { 0.0f, -1.5f + camera_index, 0.5f * camera_index - 0.75f };
+			camera->forward = { 1.0f, 0.0f, 0.0f };
+			camera->up = { 0.0f, 0.0f, 1.0f };
+			camera->vertical_field_of_view = 70.0f * DEG;
+			camera->aspect_ratio = 16.0f / 9.0f;
+			camera->near_distance = 0.05f;
+		}
+
+		globals->job_occluder_count = 1;
+		globals->job_occluders[0].triangles = render_software_occlusion_benchmark_wall();
+		globals->job_occluders[0].triangle_count = k_render_software_occlusion_wall_triangle_count;
+	}
+
+	result->worker_count = MAX(globals->worker_count, 1);
+	iterations = MAX(iterations, 1);
+
+	for (int32 view_count = 1; view_count <= k_maximum_render_software_occlusion_prepared_views; view_count++)
+	{
+		int64 serial_cycles = 0;
+		int64 parallel_cycles = 0;
+		for (int32 iteration = 0; iteration < iterations; iteration++)
+		{
+			serial_cycles += render_software_occlusion_build_views(0, cameras, view_count, 0);
+			parallel_cycles += render_software_occlusion_build_views(0, cameras, view_count, result->worker_count);
+		}
+
+		for (int32 view_index = 0; view_index < view_count; view_index++)
+		{
+			result->occluder_count[view_count - 1] += globals->views[view_index].screen_triangle_count;
+		}
+		result->serial_milliseconds[view_count - 1] = real32(1000.0 * c_stop_watch::cycles_to_seconds(serial_cycles) / iterations);
+		result->parallel_milliseconds[view_count - 1] = real32(1000.0 * c_stop_watch::cycles_to_seconds(parallel_cycles) / iterations);
+	}
+
+	// the views were borrowed, the next collection must not pick them up
+	for (int32 view_index = 0; view_index < k_maximum_render_software_occlusion_views; view_index++)
+	{
+		globals->views[view_index].prepared = false;
+	}
+}
+
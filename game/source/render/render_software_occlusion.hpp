@@ -0,0 +1,198 @@
+#pragma once
+
+#include "cseries/cseries.hpp"
+#include "multithreading/job_system.hpp"
+
+// before the camera visibility collection runs, the large one-sided structure collision surfaces near the camera are
+// rasterized into a small depth buffer on the job system workers, every root object the collection adds afterwards that
+// casts no shadow is tested against it and left out of the visible items when structure covers the whole of its bounding sphere,
+// pixels take the farthest depth of the triangles covering their center and spheres are tested against the pixels of
+// their screen bounds grown by one, so an object is never rejected where some of it could be seen
+
+// every view has a context of its own, the views of all player windows are built together as soon as their cameras are
+// set up so split-screen spreads them over the workers, the collection of each view then only picks its context up,
+// only this occlusion work runs in parallel, the camera visibility collections themselves and the visible items they fill
+// belong to the original executable and still run one view after another
+
+// a collection picks up the view prepared for its player window when the camera it collects with is the one the view was
+// built from, any other camera has its view built on the spot and is counted, a prepared view passed over is warned about
+
+enum
+{
+	k_render_software_occlusion_width = 256,
+	k_render_software_occlusion_height = 128,
+
+	k_maximum_render_software_occlusion_workers = k_maximum_job_system_workers,
+	k_render_software_occlusion_default_worker_count = 2,
+
+	k_maximum_render_software_occlusion_structure_bsps = 16,
+	k_maximum_render_software_occlusion_bsp_triangles = 65536,
+	k_maximum_render_software_occlusion_view_triangles = 4096,
+
+	// one view per player window, and one more for the cameras that show up without having been prepared
+	k_maximum_render_software_occlusion_prepared_views = MAXIMUM_PLAYER_WINDOWS,
+	k_render_software_occlusion_unprepared_view_index = k_maximum_render_software_occlusion_prepared_views,
+	k_maximum_render_software_occlusion_views,
+};
+
+enum e_render_software_occlusion_job_type
+{
+	_render_software_occlusion_job_project = 0,
+	_render_software_occlusion_job_rasterize,
+
+	k_render_software_occlusion_job_type_count
+};
+
+struct s_render_software_occlusion_triangle
+{
+	real_point3d points[3];
+	real_plane3d plane;
+};
+
+struct s_render_software_occlusion_structure_bsp
+{
+	bool built;
+	int32 triangle_count;
+	s_render_software_occlusion_triangle* triangles;
+};
+
+struct s_render_software_occlusion_occluders
+{
+	const s_render_software_occlusion_triangle* triangles;
+	int32 triangle_count;
+};
+
+// a triangle projected to depth buffer pixels, wound so the inside of every edge is positive
+struct s_render_software_occlusion_screen_triangle
+{
+	real_point2d points[3];
+	real32 farthest_depth;
+};
+
+// the parts of a render camera a view is built from, kept so views can be matched to collections and rebuilt later
+struct s_render_software_occlusion_camera
+{
+	real_point3d position;
+	real_vector3d forward;
+	real_vector3d up;
+	real32 vertical_field_of_view;
+	real32 aspect_ratio;
+	real32 near_distance;
+};
+
+struct s_render_software_occlusion_view
+{
+	real_point3d position;
+	real_vector3d forward;
+	real_vector3d left;
+	real_vector3d up;
+	real32 near_distance;
+
+	// pixels per unit of view space offset at a depth of one
+	real32 scale_x;
+	real32 scale_y;
+};
+
+struct s_render_software_occlusion_statistics
+{
+	int32 view_count;
+
+	// views picked up as prepared, views built on the spot without a prepared view for their window,
+	// and views built on the spot because their window's prepared view was built from another camera
+	int32 prepared_view_count;
+	int32 unprepared_view_count;
+	int32 mismatched_view_count;
+
+	int32 occluder_count;
+	int32 objects_tested;
+	int32 objects_rejected;
+	int64 rasterize_cycles;
+	int64 test_cycles;
+};
+
+struct s_render_software_occlusion_view_context
+{
+	// set once the depth buffer is built, cleared again when a collection picks the view up
+	bool prepared;
+	int32 player_window_index;
+	s_render_software_occlusion_camera camera;
+	s_render_software_occlusion_view view;
+
+	int32 screen_triangle_count;
+	s_render_software_occlusion_screen_triangle screen_triangles[k_maximum_render_software_occlusion_view_triangles];
+
+	// the nearest occluder depth of every pixel, cleared to `k_real_max` for every view
+	alignas(16) real32 depth[k_render_software_occlusion_height][k_render_software_occlusion_width];
+
+	s_render_software_occlusion_statistics statistics;
+};
+
+struct s_render_software_occlusion_globals
+{
+	bool enabled;
+
+	// how many of the shared job system workers a batch is spread over
+	int32 worker_count;
+
+	// occluders are gathered once per structure bsp and thrown away whenever the scenario or the active bsps change
+	int32 scenario_index;
+	uns32 active_structure_bsp_mask;
+	s_render_software_occlusion_structure_bsp structure_bsps[k_maximum_render_software_occlusion_structure_bsps];
+
+	// the batch the workers are running, jobs are views when projecting and bands of rows of views when rasterizing
+	e_render_software_occlusion_job_type job_type;
+	int32 job_first_view_index;
+	int32 job_band_count;
+	int32 job_occluder_count;
+	s_render_software_occlusion_occluders job_occluders[k_maximum_render_software_occlusion_structure_bsps + 1];
+
+	s_render_software_occlusion_view_context views[k_maximum_render_software_occlusion_views];
+
+	// the view of the collection running between `render_software_occlusion_view_begin` and `render_software_occlusion_view_end`
+	int32 active_view_index;
+	bool mismatch_warned;
+
+	// the cameras of the last views prepared, for benchmarking against a real frame
+	int32 captured_camera_count;
+	s_render_software_occlusion_camera captured_cameras[k_maximum_render_software_occlusion_prepared_views];
+
+	s_render_software_occlusion_statistics last_view;
+	s_render_software_occlusion_statistics totals;
+};
+
+struct s_render_software_occlusion_benchmark_result
+{
+	bool self_test_passed;
+	int32 occluder_count;
+	int32 sphere_count;
+	int32 spheres_rejected;
+	int32 expected_spheres_rejected;
+	real32 serial_rasterize_milliseconds;
+	real32 parallel_rasterize_milliseconds;
+	real32 test_microseconds;
+};
+
+struct s_render_software_occlusion_prepare_views_benchmark_result
+{
+	bool captured_cameras;
+	int32 worker_count;
+
+	// indexed by the number of views built at once minus one
+	int32 occluder_count[k_maximum_render_software_occlusion_prepared_views];
+	real32 serial_milliseconds[k_maximum_render_software_occlusion_prepared_views];
+	real32 parallel_milliseconds[k_maximum_render_software_occlusion_prepared_views];
+};
+
+struct render_camera;
+
+extern s_render_software_occlusion_globals g_render_software_occlusion_globals;
+
+extern void render_software_occlusion_dispose();
+extern void render_software_occlusion_set_mode(bool enabled, int32 worker_count);
+extern void render_software_occlusion_prepare_views(const render_camera* const* cameras, int32 camera_count);
+extern void render_software_occlusion_view_begin(const render_camera* camera, int32 player_window_index);
+extern void render_software_occlusion_view_end();
+extern bool render_software_occlusion_sphere_occluded(const real_point3d* center, real32 radius);
+extern bool render_software_occlusion_benchmark(int32 iterations, s_render_software_occlusion_benchmark_result* result);
+extern void render_software_occlusion_prepare_views_benchmark(int32 iterations, s_render_software_occlusion_prepare_views_benchmark_result* result);
+
@@ -1,9 +1,13 @@
 #include "render/render_visibility_collection.hpp"
 
+#include "memory/module.hpp"
 #include "render/render_cameras.hpp"
+#include "render/render_software_occlusion.hpp"
 #include "render/render_visibility.hpp"
 #include "visibility/visibility_collection.hpp"
 
+HOOK_DECLARE(0x00A53250, render_visibility_camera_collection_compute);
+
 void __cdecl render_visibility_add_current_visible_clusters_to_frame_visible_clusters()
 {
 	INVOKE(0x00A52C20, render_visibility_add_current_visible_clusters_to_frame_visible_clusters);
@@ -26,7 +30,11 @@ int32 __cdecl render_visibility_add_object_to_items(int32 object_index, int32 pl
 
 void __cdecl render_visibility_camera_collection_compute(const render_camera* camera, s_cluster_reference camera_cluster_reference, const render_projection* projection, int32 user_index, int32 player_window_index, bool single_cluster_only, bool a7)
 {
-	INVOKE(0x00A53250, render_visibility_camera_collection_compute, camera, camera_cluster_reference, projection, user_index, player_window_index, single_cluster_only, a7);
+	//INVOKE(0x00A53250, render_visibility_camera_collection_compute, camera, camera_cluster_reference, projection, user_index, player_window_index, single_cluster_only, a7);
+
+	render_software_occlusion_view_begin(camera, player_window_index);
+	HOOK_INVOKE(, render_visibility_camera_collection_compute, camera, camera_cluster_reference, projection, user_index, player_window_index, single_cluster_only, a7);
+	render_software_occlusion_view_end();
 
 	//visibility_projection visibility_projection{};
 	//render_visibility_build_projection(camera, projection, camera_cluster_reference, &visibility_projection);
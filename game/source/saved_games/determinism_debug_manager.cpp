@@ -1,5 +1,236 @@
 #include "saved_games/determinism_debug_manager.hpp"
 
+#include "cache/restricted_memory.hpp"
+#include "cseries/cseries_events.hpp"
+#include "game/game_time.hpp"
+#include "main/main_headless.hpp"
+#include "memory/data.hpp"
+#include "networking/logic/network_life_cycle.hpp"
+#include "networking/session/network_session.hpp"
+#include "profiler/profiler_stopwatch.hpp"
+#include "saved_games/game_state.hpp"
+
+s_determinism_hash_globals g_determinism_hash_globals{};
+
+static c_stop_watch* determinism_hash_stop_watch()
+{
+	static c_stop_watch stop_watch(true);
+	return &stop_watch;
+}
+
+// odd weights keep the sum sensitive to which sector holds which bytes
+static uns32 determinism_hash_sector_weight(int32 sector_index)
+{
+	return (uns32(sector_index) * 2 + 1) * 0x9E3779B1;
+}
+
+// four independent lanes of xor and multiply by an odd constant, 16 bytes per step, every step of a lane is invertible
+// so a change to any single word always changes the hash, far cheaper per byte than a table driven crc
+static uns32 determinism_hash_sector(const byte* sector, uns32 size)
+{
+	uns32 lanes[4]{ 0x811C9DC5, 0x811C9DC5 ^ 1, 0x811C9DC5 ^ 2, 0x811C9DC5 ^ 3 };
+
+	const uns32* words = (const uns32*)sector;
+	uns32 block_count = size / (4 * sizeof(uns32));
+	for (uns32 block_index = 0; block_index < block_count; block_index++, words += 4)
+	{
+		lanes[0] = (lanes[0] ^ words[0]) * 0x01000193;
+		lanes[1] = (lanes[1] ^ words[1]) * 0x01000193;
+		lanes[2] = (lanes[2] ^ words[2]) * 0x01000193;
+		lanes[3] = (lanes[3] ^ words[3]) * 0x01000193;
+	}
+
+	for (uns32 byte_index = block_count * 4 * sizeof(uns32); byte_index < size; byte_index++)
+	{
+		lanes[byte_index % 4] = (lanes[byte_index % 4] ^ sector[byte_index]) * 0x01000193;
+	}
+
+	uns32 hash = size;
+	for (int32 lane_index = 0; lane_index < NUMBEROF(lanes); lane_index++)
+	{
+		hash = (hash ^ lanes[lane_index]) * 0x9E3779B1;
+		hash ^= hash >> 15;
+	}
+	return hash;
+}
+
+static void determinism_hash_layout_dispose()
+{
+	s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+
+	globals->subsystem_count = 0;
+	globals->sector_count = 0;
+	globals->layout_valid = false;
+	globals->layout_time = NONE;
+	globals->last_tick_time = NONE;
+	csmemset(globals->history_times, 0xFF, sizeof(globals->history_times));
+	csmemset(globals->remote_history_times, 0xFF, sizeof(globals->remote_history_times));
+}
+
+static uns32 determinism_hash_subsystem_sector(const s_determinism_hash_subsystem* subsystem, int32 sector_index)
+{
+	uns32 sector_offset = sector_index * k_determinism_hash_sector_size;
+	uns32 sector_size = MIN(uns32(k_determinism_hash_sector_size), subsystem->size - sector_offset);
+	return determinism_hash_sector(subsystem->address + sector_offset, sector_size);
+}
+
+// hashes every sector of the deterministic allocations, the stripes start over from here
+static void determinism_hash_layout_build(int32 game_time)
+{
+	s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+
+	determinism_hash_layout_dispose();
+	globals->layout_generation = g_game_state_deterministic_allocations.generation;
+	globals->layout_time = game_time;
+	globals->layout_builds++;
+
+	for (int32 allocation_index = 0; allocation_index < g_game_state_deterministic_allocations.count; allocation_index++)
+	{
+		const s_game_state_deterministic_allocation* allocation = &g_game_state_deterministic_allocations.allocations[allocation_index];
+		if ((allocation->region_index != k_game_state_update_region && allocation->region_index != k_game_state_shared_region)
+			|| !main_headless_allocation_is_simulation(allocation->name)
+			|| allocation->size == 0)
+		{
+			continue;
+		}
+
+		int32 sector_count = int32((allocation->size + k_determinism_hash_sector_size - 1) / k_determinism_hash_sector_size);
+		if (globals->subsystem_count >= k_maximum_determinism_hash_subsystems
+			|| globals->sector_count + sector_count > k_maximum_determinism_hash_sectors)
+		{
+			event(_event_warning, "determinism: game state hashing does not cover '%s' and the allocations after it", allocation->name);
+			break;
+		}
+
+		s_determinism_hash_subsystem* subsystem = &globals->subsystems[globals->subsystem_count];
+		csmemset(subsystem, 0, sizeof(s_determinism_hash_subsystem));
+		subsystem->name = allocation->name;
+		subsystem->address = (const byte*)allocation->primary_address;
+		subsystem->size = allocation->size;
+		subsystem->first_sector = globals->sector_count;
+		subsystem->sector_count = sector_count;
+		subsystem->consumer_index = globals->subsystem_count % 30;
+		subsystem->last_change_time = NONE;
+		subsystem->first_dirty_sector = NONE;
+		subsystem->last_dirty_sector = NONE;
+
+		const s_data_array* data_array = (const s_data_array*)subsystem->address;
+		if (subsystem->size >= sizeof(s_data_array)
+			&& data_array->signature == k_data_signature
+			&& data_array->size > 0
+			&& (const byte*)data_array->data >= subsystem->address
+			&& (const byte*)data_array->data < subsystem->address + subsystem->size)
+		{
+			subsystem->datum_offset = uns32((const byte*)data_array->data - subsystem->address);
+			subsystem->datum_size = data_array->size;
+			subsystem->maximum_count = data_array->maximum_count;
+		}
+
+		for (int32 sector_index = 0; sector_index < sector_count; sector_index++)
+		{
+			uns32 sector_hash = determinism_hash_subsystem_sector(subsystem, sector_index);
+			globals->sector_hashes[subsystem->first_sector + sector_index] = sector_hash;
+			subsystem->hash += sector_hash * determinism_hash_sector_weight(sector_index);
+		}
+
+		globals->subsystem_count++;
+		globals->sector_count += sector_count;
+	}
+
+	globals->layout_valid = true;
+}
+
+// hashes the sectors of the stripe of this tick again, returns the number of them that changed
+static int32 determinism_hash_update_subsystem(s_determinism_hash_subsystem* subsystem, int32 game_time, int32* sectors_hashed)
+{
+	s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+	ASSERT(sectors_hashed);
+
+	int32 stripe_index = game_time % k_determinism_hash_stripe_count;
+	int32 first_sector_index = (stripe_index - subsystem->first_sector % k_determinism_hash_stripe_count + k_determinism_hash_stripe_count) % k_determinism_hash_stripe_count;
+
+	int32 sectors_dirty = 0;
+	for (int32 sector_index = first_sector_index; sector_index < subsystem->sector_count; sector_index += k_determinism_hash_stripe_count)
+	{
+		(*sectors_hashed)++;
+
+		uns32* sector_hash = &globals->sector_hashes[subsystem->first_sector + sector_index];
+		uns32 new_sector_hash = determinism_hash_subsystem_sector(subsystem, sector_index);
+		if (new_sector_hash == *sector_hash)
+		{
+			continue;
+		}
+
+		subsystem->hash += (new_sector_hash - *sector_hash) * determinism_hash_sector_weight(sector_index);
+		*sector_hash = new_sector_hash;
+
+		if (sectors_dirty++ == 0)
+		{
+			subsystem->last_change_time = game_time;
+			subsystem->first_dirty_sector = sector_index;
+		}
+		subsystem->last_dirty_sector = sector_index;
+	}
+
+	return sectors_dirty;
+}
+
+static void determinism_hash_compare(int32 game_time, const s_determinism_verification* remote_verification, const s_determinism_verification* local_verification)
+{
+	s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+
+	globals->compare_count++;
+	if (!determinism_debug_manager_compare_game_state_checksum(remote_verification, local_verification))
+	{
+		event(_event_error, "determinism: a client's game state differs from ours at game time %d", game_time);
+	}
+}
+
+static void determinism_hash_dump_consumer(int32 consumer_index)
+{
+	s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+
+	for (int32 subsystem_index = 0; subsystem_index < globals->subsystem_count; subsystem_index++)
+	{
+		const s_determinism_hash_subsystem* subsystem = &globals->subsystems[subsystem_index];
+		if (subsystem->consumer_index != consumer_index)
+		{
+			continue;
+		}
+
+		if (subsystem->last_change_time == NONE)
+		{
+			event(_event_error, "determinism: '%s' hash %08X, unchanged since hashing began", subsystem->name, subsystem->hash);
+			continue;
+		}
+
+		uns32 dirty_begin = subsystem->first_dirty_sector * k_determinism_hash_sector_size;
+		uns32 dirty_end = MIN(uns32(subsystem->last_dirty_sector + 1) * k_determinism_hash_sector_size, subsystem->size);
+		if (subsystem->datum_size > 0 && dirty_end > subsystem->datum_offset)
+		{
+			int32 first_datum = int32((MAX(dirty_begin, subsystem->datum_offset) - subsystem->datum_offset) / subsystem->datum_size);
+			int32 last_datum = MIN(int32((dirty_end - 1 - subsystem->datum_offset) / subsystem->datum_size), subsystem->maximum_count - 1);
+			event(_event_error, "determinism: '%s' hash %08X, last written at game time %d in bytes 0x%X-0x%X, datums %d-%d",
+				subsystem->name,
+				subsystem->hash,
+				subsystem->last_change_time,
+				dirty_begin,
+				dirty_end,
+				first_datum,
+				last_datum);
+		}
+		else
+		{
+			event(_event_error, "determinism: '%s' hash %08X, last written at game time %d in bytes 0x%X-0x%X",
+				subsystem->name,
+				subsystem->hash,
+				subsystem->last_change_time,
+				dirty_begin,
+				dirty_end);
+		}
+	}
+}
+
 void __cdecl determinism_debug_manager_initialize()
 {
 	INVOKE(0x00530270, determinism_debug_manager_initialize);
@@ -13,10 +244,219 @@ void __cdecl determinism_debug_manager_dispose()
 void __cdecl determinism_debug_manager_initialize_for_new_map()
 {
 	INVOKE(0x00530290, determinism_debug_manager_initialize_for_new_map);
+
+	// the allocations of the map are still being made, the layout is built on the first tick
+	determinism_hash_layout_dispose();
 }
 
 void __cdecl determinism_debug_manager_dispose_from_old_map()
 {
 	INVOKE(0x005302A0, determinism_debug_manager_dispose_from_old_map);
+
+	determinism_hash_layout_dispose();
+}
+
+// reverts, core loads and film seeks replace the game state wholesale, the sector hashes describe the state before them
+void __cdecl determinism_debug_manager_game_state_loaded()
+{
+	s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+
+	if (globals->layout_valid)
+	{
+		globals->discontinuity_count++;
+	}
+	determinism_hash_layout_dispose();
+}
+
+void __cdecl determinism_debug_manager_set_game_state_hashing(bool enabled)
+{
+	s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+
+	// nothing written while hashing was off was seen, it starts over from a full hash
+	determinism_hash_layout_dispose();
+	globals->enabled = enabled;
+}
+
+void __cdecl determinism_debug_manager_game_tick_end()
+{
+	s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+
+	if (!globals->enabled)
+	{
+		return;
+	}
+
+	c_stop_watch* stop_watch = determinism_hash_stop_watch();
+	stop_watch->reset();
+	stop_watch->start();
+
+	// a tick that doesn't follow the last one came after a game state load that didn't go through the load procs
+	int32 game_time = game_time_get();
+	if (globals->layout_valid && game_time != globals->last_tick_time + 1)
+	{
+		determinism_debug_manager_game_state_loaded();
+	}
+
+	int32 sectors_hashed = 0;
+	int32 sectors_dirty = 0;
+	if (!globals->layout_valid || globals->layout_generation != g_game_state_deterministic_allocations.generation)
+	{
+		determinism_hash_layout_build(game_time);
+		sectors_hashed = globals->sector_count;
+	}
+	else
+	{
+		for (int32 subsystem_index = 0; subsystem_index < globals->subsystem_count; subsystem_index++)
+		{
+			sectors_dirty += determinism_hash_update_subsystem(&globals->subsystems[subsystem_index], game_time, &sectors_hashed);
+		}
+	}
+
+	// until every stripe has been hashed since the layout was built some sectors still hold the state of that tick
+	if (game_time - globals->layout_time >= k_determinism_hash_stripe_count - 1)
+	{
+		int32 history_index = game_time % k_determinism_hash_history_count;
+		int32 previous_history_index = (game_time + k_determinism_hash_history_count - 1) % k_determinism_hash_history_count;
+		const s_determinism_verification* previous_verification = &globals->history[previous_history_index];
+		bool previous_valid = globals->history_times[previous_history_index] == game_time - 1;
+
+		s_determinism_verification verification{};
+		uns32 game_state_check = 0;
+		for (int32 subsystem_index = 0; subsystem_index < globals->subsystem_count; subsystem_index++)
+		{
+			const s_determinism_hash_subsystem* subsystem = &globals->subsystems[subsystem_index];
+			uns32 weighted_hash = subsystem->hash * determinism_hash_sector_weight(subsystem_index);
+			verification.consumer_check[subsystem->consumer_index] += int32(weighted_hash);
+			game_state_check += weighted_hash;
+		}
+		verification.game_state_check = int32(game_state_check);
+
+		if (previous_valid)
+		{
+			for (int32 consumer_index = 0; consumer_index < verification.consumer_check.get_count(); consumer_index++)
+			{
+				if (verification.consumer_check[consumer_index] == previous_verification->consumer_check[consumer_index])
+				{
+					verification.unchanged_field_mask |= FLAG(consumer_index);
+				}
+			}
+
+			if (verification.game_state_check == previous_verification->game_state_check)
+			{
+				verification.unchanged_field_mask |= FLAG(_determinism_verification_game_state_unchanged_bit);
+			}
+
+			verification.unchanged_field_mask |= FLAG(_determinism_verification_cheats_unchanged_bit);
+		}
+
+		globals->history[history_index] = verification;
+		globals->history_times[history_index] = game_time;
+
+		if (globals->remote_history_times[history_index] == game_time)
+		{
+			globals->remote_history_times[history_index] = NONE;
+			determinism_hash_compare(game_time, &globals->remote_history[history_index], &verification);
+		}
+
+		// every sector is hashed again once per round of stripes, sending one verification per round covers all of them
+		c_network_session* session = life_cycle_globals.life_cycle_state_manager.get_active_squad_session();
+		if (game_time % k_determinism_hash_stripe_count == 0
+			&& session && session->established() && !session->is_host()
+			&& session->peer_send_determinism_verification(game_time, &verification))
+		{
+			globals->sent_count++;
+		}
+	}
+
+	globals->last_tick_time = game_time;
+	globals->last_tick_sectors_hashed = sectors_hashed;
+	globals->last_tick_sectors_dirty = sectors_dirty;
+	globals->last_tick_cycles = stop_watch->stop();
+	globals->tick_count++;
+	globals->total_sectors_hashed += sectors_hashed;
+	globals->total_sectors_dirty += sectors_dirty;
+	globals->total_cycles += globals->last_tick_cycles;
 }
 
+// the verification of the last tick, false when game state hashing is off or has none for it yet
+bool __cdecl determinism_debug_manager_generate_game_state_checksum(s_determinism_verification* verification)
+{
+	ASSERT(verification);
+
+	return determinism_debug_manager_get_game_state_checksum(game_time_get(), verification);
+}
+
+bool __cdecl determinism_debug_manager_get_game_state_checksum(int32 game_time, s_determinism_verification* verification)
+{
+	s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+	ASSERT(verification);
+
+	int32 history_index = game_time % k_determinism_hash_history_count;
+	if (!globals->enabled || game_time < 0 || globals->history_times[history_index] != game_time)
+	{
+		return false;
+	}
+
+	*verification = globals->history[history_index];
+	return true;
+}
+
+// logs the first consumer that differs and what each subsystem folded into it last wrote
+bool __cdecl determinism_debug_manager_compare_game_state_checksum(const s_determinism_verification* remote_verification, const s_determinism_verification* local_verification)
+{
+	s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+	ASSERT(remote_verification);
+	ASSERT(local_verification);
+
+	if (remote_verification->game_state_check == local_verification->game_state_check)
+	{
+		return true;
+	}
+
+	globals->mismatch_count++;
+
+	for (int32 consumer_index = 0; consumer_index < local_verification->consumer_check.get_count(); consumer_index++)
+	{
+		if (remote_verification->consumer_check[consumer_index] != local_verification->consumer_check[consumer_index])
+		{
+			event(_event_error, "determinism: game state differs in consumer %d, remote %08X local %08X",
+				consumer_index,
+				remote_verification->consumer_check[consumer_index],
+				local_verification->consumer_check[consumer_index]);
+
+			determinism_hash_dump_consumer(consumer_index);
+			break;
+		}
+	}
+
+	return false;
+}
+
+// a verification a client sent us as its host, compared now when we have ours of the same tick, otherwise once we do
+void __cdecl determinism_debug_manager_handle_remote_game_state_checksum(int32 game_time, const s_determinism_verification* remote_verification)
+{
+	s_determinism_hash_globals* globals = &g_determinism_hash_globals;
+	ASSERT(remote_verification);
+
+	if (!globals->enabled || game_time < 0)
+	{
+		return;
+	}
+
+	s_determinism_verification local_verification{};
+	if (determinism_debug_manager_get_game_state_checksum(game_time, &local_verification))
+	{
+		determinism_hash_compare(game_time, remote_verification, &local_verification);
+		return;
+	}
+
+	// too old to ever be compared
+	if (game_time <= game_time_get())
+	{
+		return;
+	}
+
+	int32 history_index = game_time % k_determinism_hash_history_count;
+	globals->remote_history[history_index] = *remote_verification;
+	globals->remote_history_times[history_index] = game_time;
+}
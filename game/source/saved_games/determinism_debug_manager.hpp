@@ -11,8 +11,107 @@ struct s_determinism_verification
 };
 static_assert(sizeof(s_determinism_verification) == 0x84);
 
+// every deterministic update and shared region allocation outside the presentation systems is a subsystem, its hash is
+// the weighted sum of the crcs of its sectors, sectors are hashed in stripes, a tick hashes again only the sectors whose
+// index is the game time modulo `k_determinism_hash_stripe_count`, so a tick costs a fraction of the game state and a
+// sector hash is at most that many ticks old, subsystems are folded into the consumer checks of a verification by index,
+// the game state check folds all of them
+
+// which tick every sector was last hashed at only depends on the game time, so once every stripe has been hashed since
+// the layout was built the verifications of two peers at the same game time cover the same state
+
+// clients send the verification of one tick per round of stripes to the host of their session, the host compares them
+// against its own of the same tick, whichever of the two it has first waits in the history for the other
+
+// a revert, core load or film seek starts hashing over from a full hash, as does any tick that doesn't follow the last
+
+// `unchanged_field_mask` of a generated verification has bit `n` set when `consumer_check[n]` is the same as it was the
+// tick before, `_determinism_verification_game_state_unchanged_bit` and `_determinism_verification_cheats_unchanged_bit`
+// cover the other two checks
+
+enum
+{
+	k_determinism_hash_sector_size = 0x1000,
+	k_determinism_hash_stripe_count = 8,
+	k_maximum_determinism_hash_subsystems = 512,
+	k_maximum_determinism_hash_sectors = 0x1000,
+	k_determinism_hash_history_count = 32,
+
+	_determinism_verification_game_state_unchanged_bit = 30,
+	_determinism_verification_cheats_unchanged_bit,
+};
+
+struct s_determinism_hash_subsystem
+{
+	const char* name;
+	const byte* address;
+	uns32 size;
+	int32 first_sector;
+	int32 sector_count;
+	int32 consumer_index;
+	uns32 hash;
+
+	// the last tick a sector of the subsystem was seen to change and the range of its sectors that changed then, a change
+	// is seen up to `k_determinism_hash_stripe_count` ticks after it was made
+	int32 last_change_time;
+	int32 first_dirty_sector;
+	int32 last_dirty_sector;
+
+	// data arrays report the datums their dirty sectors cover, `datum_size` is 0 for anything else
+	uns32 datum_offset;
+	int32 datum_size;
+	int32 maximum_count;
+};
+
+struct s_determinism_hash_globals
+{
+	bool enabled;
+
+	// cleared whenever the deterministic allocations change, the next tick hashes everything again
+	bool layout_valid;
+	int32 layout_generation;
+	int32 layout_time;
+	int32 last_tick_time;
+
+	int32 subsystem_count;
+	s_determinism_hash_subsystem subsystems[k_maximum_determinism_hash_subsystems];
+
+	int32 sector_count;
+	uns32 sector_hashes[k_maximum_determinism_hash_sectors];
+
+	// the verifications of the last ticks and those sent by clients the host had none of yet, by game time modulo the
+	// history count
+	int32 history_times[k_determinism_hash_history_count];
+	s_determinism_verification history[k_determinism_hash_history_count];
+	int32 remote_history_times[k_determinism_hash_history_count];
+	s_determinism_verification remote_history[k_determinism_hash_history_count];
+
+	int32 last_tick_sectors_hashed;
+	int32 last_tick_sectors_dirty;
+	int64 last_tick_cycles;
+
+	int32 tick_count;
+	int32 layout_builds;
+	int32 discontinuity_count;
+	int32 sent_count;
+	int32 compare_count;
+	int32 mismatch_count;
+	int64 total_sectors_hashed;
+	int64 total_sectors_dirty;
+	int64 total_cycles;
+};
+
+extern s_determinism_hash_globals g_determinism_hash_globals;
+
 extern void __cdecl determinism_debug_manager_initialize();
 extern void __cdecl determinism_debug_manager_dispose();
 extern void __cdecl determinism_debug_manager_initialize_for_new_map();
 extern void __cdecl determinism_debug_manager_dispose_from_old_map();
+extern void __cdecl determinism_debug_manager_game_state_loaded();
+extern void __cdecl determinism_debug_manager_set_game_state_hashing(bool enabled);
+extern void __cdecl determinism_debug_manager_game_tick_end();
+extern bool __cdecl determinism_debug_manager_generate_game_state_checksum(s_determinism_verification* verification);
+extern bool __cdecl determinism_debug_manager_get_game_state_checksum(int32 game_time, s_determinism_verification* verification);
+extern bool __cdecl determinism_debug_manager_compare_game_state_checksum(const s_determinism_verification* remote_verification, const s_determinism_verification* local_verification);
+extern void __cdecl determinism_debug_manager_handle_remote_game_state_checksum(int32 game_time, const s_determinism_verification* remote_verification);
 
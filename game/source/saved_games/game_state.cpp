@@ -33,6 +33,7 @@ _game_state_test_option s_game_state_globals::game_state_test_option = GAME_STAT
 c_gamestate_deterministic_allocation_callbacks g_gamestate_deterministic_allocation_callbacks{};
 c_gamestate_nondeterministic_allocation_callbacks g_gamestate_nondeterministic_allocation_callbacks{};
 c_gamestate_allocation_record_allocation_callbacks g_gamestate_allocation_record_allocation_callbacks{};
+s_game_state_deterministic_allocations g_game_state_deterministic_allocations{};
 
 s_file_reference g_game_state_allocation_file_reference{};
 bool g_game_state_allocation_file_reference_valid = false;
@@ -813,6 +814,17 @@ void __thiscall c_gamestate_deterministic_allocation_callbacks::handle_allocatio
 	game_state_allocation_record(manager->m_region_index, name, type_name, size);
 	game_state_globals.allocation_size_checksum = crc_checksum_buffer(game_state_globals.allocation_size_checksum, (byte*)&size, 4);
 	//determinism_debug_manager_register_game_state_allocation(name, primary_address, size);
+
+	// every consumer of the list assumes it holds every deterministic allocation, running out of room is fatal
+	ASSERT(VALID_INDEX(g_game_state_deterministic_allocations.count, k_game_state_deterministic_allocation_maximum_count));
+
+	s_game_state_deterministic_allocation* allocation = &g_game_state_deterministic_allocations.allocations[g_game_state_deterministic_allocations.count++];
+	allocation->name = name;
+	allocation->type_name = type_name;
+	allocation->region_index = manager->m_region_index;
+	allocation->primary_address = primary_address;
+	allocation->size = size;
+	g_game_state_deterministic_allocations.generation++;
 }
 
 //.text:00511090 ; c_gamestate_nondeterministic_allocation_callbacks::handle_allocation
@@ -837,6 +849,18 @@ void c_restricted_memory_callbacks::handle_allocation(const c_restricted_memory*
 //.text:005110C0 ; c_gamestate_deterministic_allocation_callbacks::handle_release
 void c_gamestate_deterministic_allocation_callbacks::handle_release(const c_restricted_memory* memory, int32 member_index, void* base_address, unsigned int allocation_size)
 {
+	for (int32 allocation_index = 0; allocation_index < g_game_state_deterministic_allocations.count; allocation_index++)
+	{
+		s_game_state_deterministic_allocation* allocation = &g_game_state_deterministic_allocations.allocations[allocation_index];
+		if (allocation->region_index == memory->m_region_index && allocation->primary_address == base_address)
+		{
+			// keep the list in allocation order
+			int32 following_count = --g_game_state_deterministic_allocations.count - allocation_index;
+			memmove(allocation, allocation + 1, following_count * sizeof(s_game_state_deterministic_allocation));
+			g_game_state_deterministic_allocations.generation++;
+			break;
+		}
+	}
 }
 
 //.text:005110D0 ; c_gamestate_nondeterministic_allocation_callbacks::handle_release
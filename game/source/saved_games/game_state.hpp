@@ -43,7 +43,27 @@ enum _game_state_test_option
 
 enum
 {
-	k_saved_game_storage_max_count = 2
+	k_saved_game_storage_max_count = 2,
+	k_game_state_deterministic_allocation_maximum_count = 512,
+};
+
+// every member added to a deterministic game state region, in allocation order
+struct s_game_state_deterministic_allocation
+{
+	const char* name;
+	const char* type_name;
+	int32 region_index;
+	void* primary_address;
+	uns32 size;
+};
+
+struct s_game_state_deterministic_allocations
+{
+	// bumped by every allocation and release, a release followed by an allocation of the same size leaves `count` as it was
+	int32 generation;
+
+	int32 count;
+	s_game_state_deterministic_allocation allocations[k_game_state_deterministic_allocation_maximum_count];
 };
 
 class c_game_state_compressor_callback :
@@ -175,6 +195,7 @@ extern c_gamestate_deterministic_allocation_callbacks g_gamestate_deterministic_
 extern c_gamestate_nondeterministic_allocation_callbacks g_gamestate_nondeterministic_allocation_callbacks;
 extern c_gamestate_allocation_record_allocation_callbacks g_gamestate_allocation_record_allocation_callbacks;
 extern s_game_state_globals& game_state_globals;
+extern s_game_state_deterministic_allocations g_game_state_deterministic_allocations;
 
 struct s_player_identifier;
 extern bool __cdecl create_file_from_buffer(const char* file_name, const char* file_contents);
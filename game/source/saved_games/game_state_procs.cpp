@@ -1,10 +1,19 @@
 #include "saved_games/game_state_procs.hpp"
 
 #include "cseries/cseries.hpp"
+#include "memory/module.hpp"
+#include "saved_games/determinism_debug_manager.hpp"
+
+HOOK_DECLARE(0x0058A4B0, game_state_call_after_load_procs);
 
 void __cdecl game_state_call_after_load_procs(int32 game_state_proc_flags)
 {
-	INVOKE(0x0058A4B0, game_state_call_after_load_procs, game_state_proc_flags);
+	//INVOKE(0x0058A4B0, game_state_call_after_load_procs, game_state_proc_flags);
+
+	HOOK_INVOKE(, game_state_call_after_load_procs, game_state_proc_flags);
+
+	// reverts, core loads and film seeks all end here
+	determinism_debug_manager_game_state_loaded();
 }
 
 void __cdecl game_state_call_after_save_procs(int32 game_state_proc_flags)
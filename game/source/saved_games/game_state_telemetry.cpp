@@ -0,0 +1,311 @@
+#include "saved_games/game_state_telemetry.hpp"
+
+#include "config/version.hpp"
+#include "cseries/cseries_events.hpp"
+#include "game/game.hpp"
+#include "game/game_time.hpp"
+#include "memory/data.hpp"
+#include "memory/memory_pool.hpp"
+#include "multithreading/threads.hpp"
+#include "tag_files/files.hpp"
+
+s_game_state_telemetry_globals g_game_state_telemetry_globals
+{
+	.allocation_generation = NONE,
+};
+
+const char* const k_game_state_telemetry_allocation_type_names[k_game_state_telemetry_allocation_type_count]
+{
+	"unknown",
+	"data array",
+	"memory pool",
+};
+
+static e_game_state_telemetry_allocation_type game_state_telemetry_allocation_classify(const s_game_state_deterministic_allocation* allocation)
+{
+	if (allocation->size >= sizeof(s_data_array))
+	{
+		const s_data_array* data_array = (const s_data_array*)allocation->primary_address;
+		if (data_array->signature == k_data_signature
+			&& data_array->maximum_count > 0
+			&& VALID_COUNT(data_array->count, data_array->maximum_count)
+			&& VALID_COUNT(data_array->actual_count, data_array->count))
+		{
+			return _game_state_telemetry_allocation_data_array;
+		}
+	}
+
+	if (allocation->size >= sizeof(s_memory_pool))
+	{
+		const s_memory_pool* memory_pool = (const s_memory_pool*)allocation->primary_address;
+		if (memory_pool->size > 0
+			&& uns32(memory_pool->size) <= allocation->size - sizeof(s_memory_pool)
+			&& VALID_COUNT(memory_pool->free_size, memory_pool->size)
+			&& memory_pool->name.is_equal(allocation->name))
+		{
+			return _game_state_telemetry_allocation_memory_pool;
+		}
+	}
+
+	return _game_state_telemetry_allocation_unknown;
+}
+
+static uns32 game_state_telemetry_address_hash(const void* address)
+{
+	uns32 hash = uns32(uintptr_t(address)) * 0x9E3779B1;
+	return hash ^ (hash >> 15);
+}
+
+static s_game_state_telemetry_allocation* game_state_telemetry_allocation_find(const void* address)
+{
+	s_game_state_telemetry_globals* globals = &g_game_state_telemetry_globals;
+
+	uns32 slot_mask = NUMBEROF(globals->allocation_hash_table) - 1;
+	for (uns32 slot = game_state_telemetry_address_hash(address) & slot_mask; globals->allocation_hash_table[slot] != NONE; slot = (slot + 1) & slot_mask)
+	{
+		s_game_state_telemetry_allocation* allocation = &globals->allocations[globals->allocation_hash_table[slot]];
+		if (allocation->address == address)
+		{
+			return allocation;
+		}
+	}
+
+	return NULL;
+}
+
+static void game_state_telemetry_allocation_update_peak(s_game_state_telemetry_allocation* allocation)
+{
+	int32 used = game_state_telemetry_allocation_get_used(allocation);
+	if (used > allocation->peak_used)
+	{
+		allocation->peak_used = used;
+		allocation->peak_time = game_time_get();
+	}
+
+	if (allocation->type == _game_state_telemetry_allocation_data_array)
+	{
+		const s_data_array* data_array = (const s_data_array*)allocation->address;
+		allocation->peak_high_water_count = MAX(allocation->peak_high_water_count, data_array->count);
+	}
+}
+
+// looks the allocations up again, the peaks of the ones that were already followed are kept
+static void game_state_telemetry_allocations_build()
+{
+	s_game_state_telemetry_globals* globals = &g_game_state_telemetry_globals;
+
+	static s_game_state_telemetry_allocation previous_allocations[k_maximum_game_state_telemetry_allocations];
+	int32 previous_allocation_count = globals->allocation_count;
+	csmemcpy(previous_allocations, globals->allocations, previous_allocation_count * sizeof(s_game_state_telemetry_allocation));
+
+	globals->allocation_generation = g_game_state_deterministic_allocations.generation;
+	globals->allocation_count = 0;
+	csmemset(globals->allocation_hash_table, 0xFF, sizeof(globals->allocation_hash_table));
+
+	uns32 slot_mask = NUMBEROF(globals->allocation_hash_table) - 1;
+	int32 previous_allocation_index = 0;
+	for (int32 allocation_index = 0; allocation_index < g_game_state_deterministic_allocations.count; allocation_index++)
+	{
+		const s_game_state_deterministic_allocation* deterministic_allocation = &g_game_state_deterministic_allocations.allocations[allocation_index];
+		e_game_state_telemetry_allocation_type type = game_state_telemetry_allocation_classify(deterministic_allocation);
+		if (type == _game_state_telemetry_allocation_unknown)
+		{
+			continue;
+		}
+
+		s_game_state_telemetry_allocation* allocation = &globals->allocations[globals->allocation_count];
+		csmemset(allocation, 0, sizeof(s_game_state_telemetry_allocation));
+		allocation->name = deterministic_allocation->name;
+		allocation->address = deterministic_allocation->primary_address;
+		allocation->type = type;
+		allocation->capacity = type == _game_state_telemetry_allocation_data_array ?
+			((const s_data_array*)allocation->address)->maximum_count :
+			((const s_memory_pool*)allocation->address)->size;
+		allocation->peak_time = NONE;
+
+		// both lists are in allocation order, an allocation still around is further along the previous list
+		for (; previous_allocation_index < previous_allocation_count; previous_allocation_index++)
+		{
+			const s_game_state_telemetry_allocation* previous_allocation = &previous_allocations[previous_allocation_index];
+			if (previous_allocation->address == allocation->address && previous_allocation->type == type)
+			{
+				allocation->peak_used = previous_allocation->peak_used;
+				allocation->peak_time = previous_allocation->peak_time;
+				allocation->peak_high_water_count = previous_allocation->peak_high_water_count;
+				previous_allocation_index++;
+				break;
+			}
+		}
+
+		uns32 slot = game_state_telemetry_address_hash(allocation->address) & slot_mask;
+		while (globals->allocation_hash_table[slot] != NONE)
+		{
+			slot = (slot + 1) & slot_mask;
+		}
+		globals->allocation_hash_table[slot] = int16(globals->allocation_count++);
+	}
+}
+
+// the peaks are only taken on the main thread, where the game state is written
+void game_state_telemetry_notify_datum_new(const s_data_array* data)
+{
+	s_game_state_telemetry_globals* globals = &g_game_state_telemetry_globals;
+
+	if (!globals->match_in_progress || !is_main_thread())
+	{
+		return;
+	}
+
+	s_game_state_telemetry_allocation* allocation = game_state_telemetry_allocation_find(data);
+	if (allocation && allocation->type == _game_state_telemetry_allocation_data_array)
+	{
+		game_state_telemetry_allocation_update_peak(allocation);
+	}
+}
+
+void game_state_telemetry_notify_memory_pool_block_allocate(const s_memory_pool* pool)
+{
+	s_game_state_telemetry_globals* globals = &g_game_state_telemetry_globals;
+
+	if (!globals->match_in_progress || !is_main_thread())
+	{
+		return;
+	}
+
+	s_game_state_telemetry_allocation* allocation = game_state_telemetry_allocation_find(pool);
+	if (allocation && allocation->type == _game_state_telemetry_allocation_memory_pool)
+	{
+		game_state_telemetry_allocation_update_peak(allocation);
+	}
+}
+
+// whatever the map load left allocated is where the peaks start from
+void game_state_telemetry_match_begin()
+{
+	s_game_state_telemetry_globals* globals = &g_game_state_telemetry_globals;
+
+	game_state_telemetry_allocations_build();
+	for (int32 allocation_index = 0; allocation_index < globals->allocation_count; allocation_index++)
+	{
+		s_game_state_telemetry_allocation* allocation = &globals->allocations[allocation_index];
+		allocation->peak_used = 0;
+		allocation->peak_time = NONE;
+		allocation->peak_high_water_count = 0;
+		game_state_telemetry_allocation_update_peak(allocation);
+	}
+
+	globals->match_in_progress = true;
+	globals->match_tick_count = 0;
+}
+
+// logs the peaks of the match and appends them to a report, each line is the allocation, its capacity and its peak
+void game_state_telemetry_match_end()
+{
+	s_game_state_telemetry_globals* globals = &g_game_state_telemetry_globals;
+
+	if (!globals->match_in_progress)
+	{
+		return;
+	}
+
+	globals->match_in_progress = false;
+	globals->match_count++;
+
+	const char* scenario_path = game_options_get()->scenario_path.get_string();
+	event(_event_message, "game_state:telemetry: '%s' peaks over %d ticks", scenario_path, globals->match_tick_count);
+
+	s_file_reference report_file{};
+	create_report_file_reference(&report_file, "game_state_budgets.txt", true);
+
+	uns32 error = 0;
+	if (!file_exists(&report_file))
+	{
+		file_create(&report_file);
+	}
+
+	bool report_open = file_open(&report_file, FLAG(_file_open_flag_desired_access_write), &error);
+	if (report_open)
+	{
+		uns32 file_size = 0;
+		file_get_size(&report_file, &file_size);
+		file_set_position(&report_file, file_size, false);
+
+		file_printf(&report_file, "%s, %s, %d ticks\r\n", version_get_full_string(), scenario_path, globals->match_tick_count);
+	}
+
+	for (int32 allocation_index = 0; allocation_index < globals->allocation_count; allocation_index++)
+	{
+		const s_game_state_telemetry_allocation* allocation = &globals->allocations[allocation_index];
+		real32 peak_fraction = allocation->capacity > 0 ? real32(allocation->peak_used) / allocation->capacity : 0.0f;
+		event(_event_message, "game_state:telemetry: %s '%s' peak %d/%d (%.0f%%) at game time %d, high water %d",
+			game_state_telemetry_allocation_type_get_name(allocation->type),
+			allocation->name,
+			allocation->peak_used,
+			allocation->capacity,
+			100.0f * peak_fraction,
+			allocation->peak_time,
+			allocation->peak_high_water_count);
+
+		if (report_open)
+		{
+			file_printf(&report_file, "% 44s,% 12s,% 12d,% 12d,% 12d,% 12d\r\n",
+				allocation->name,
+				game_state_telemetry_allocation_type_get_name(allocation->type),
+				allocation->capacity,
+				allocation->peak_used,
+				allocation->peak_high_water_count,
+				allocation->peak_time);
+		}
+	}
+
+	if (report_open)
+	{
+		file_close(&report_file);
+	}
+}
+
+void game_state_telemetry_game_tick_end()
+{
+	s_game_state_telemetry_globals* globals = &g_game_state_telemetry_globals;
+
+	if (!globals->match_in_progress)
+	{
+		return;
+	}
+
+	if (globals->allocation_generation != g_game_state_deterministic_allocations.generation)
+	{
+		game_state_telemetry_allocations_build();
+	}
+
+	globals->match_tick_count++;
+}
+
+int32 game_state_telemetry_allocation_get_used(const s_game_state_telemetry_allocation* allocation)
+{
+	ASSERT(allocation);
+
+	switch (allocation->type)
+	{
+	case _game_state_telemetry_allocation_data_array:
+		return ((const s_data_array*)allocation->address)->actual_count;
+	case _game_state_telemetry_allocation_memory_pool:
+	{
+		const s_memory_pool* memory_pool = (const s_memory_pool*)allocation->address;
+		return memory_pool->size - memory_pool->free_size;
+	}
+	}
+
+	return 0;
+}
+
+const char* game_state_telemetry_allocation_type_get_name(e_game_state_telemetry_allocation_type type)
+{
+	if (!VALID_INDEX(type, k_game_state_telemetry_allocation_type_count))
+	{
+		return "<invalid>";
+	}
+
+	return k_game_state_telemetry_allocation_type_names[type];
+}
+
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "cseries/cseries.hpp"
+#include "saved_games/game_state.hpp"
+
+// the allocations followed are the deterministic game state allocations holding a data array or a memory pool, looked up
+// again from `g_game_state_deterministic_allocations` whenever its generation changes, the peaks of the match are taken
+// as datums and memory pool blocks are allocated, so they are exact, and are logged and appended to a report when the
+// match finishes, which is what `maximum_count` budgets should be sized from
+
+// allocations are told apart by what they hold when they are looked up, a data array by its signature, a memory pool by
+// carrying the name of its allocation and sizes that fit inside it
+
+enum
+{
+	k_maximum_game_state_telemetry_allocations = k_game_state_deterministic_allocation_maximum_count,
+};
+
+enum e_game_state_telemetry_allocation_type
+{
+	_game_state_telemetry_allocation_unknown = 0,
+	_game_state_telemetry_allocation_data_array,
+	_game_state_telemetry_allocation_memory_pool,
+
+	k_game_state_telemetry_allocation_type_count
+};
+
+struct s_game_state_telemetry_allocation
+{
+	const char* name;
+	const void* address;
+
+	e_game_state_telemetry_allocation_type type;
+
+	// data arrays count datums, memory pools count bytes
+	int32 capacity;
+	int32 peak_used;
+	int32 peak_time;
+
+	// data arrays only, the highest absolute index in use, the array can't shrink below it
+	int32 peak_high_water_count;
+};
+
+struct s_game_state_telemetry_globals
+{
+	// the generation of the deterministic allocations the allocations were looked up from, `NONE` before the first time
+	int32 allocation_generation;
+	int32 allocation_count;
+	s_game_state_telemetry_allocation allocations[k_maximum_game_state_telemetry_allocations];
+	int16 allocation_hash_table[k_maximum_game_state_telemetry_allocations * 2];
+
+	bool match_in_progress;
+	int32 match_tick_count;
+	int32 match_count;
+};
+
+extern s_game_state_telemetry_globals g_game_state_telemetry_globals;
+
+struct s_data_array;
+struct s_memory_pool;
+extern void game_state_telemetry_notify_datum_new(const s_data_array* data);
+extern void game_state_telemetry_notify_memory_pool_block_allocate(const s_memory_pool* pool);
+extern void game_state_telemetry_match_begin();
+extern void game_state_telemetry_match_end();
+extern void game_state_telemetry_game_tick_end();
+extern int32 game_state_telemetry_allocation_get_used(const s_game_state_telemetry_allocation* allocation);
+extern const char* game_state_telemetry_allocation_type_get_name(e_game_state_telemetry_allocation_type type);
+
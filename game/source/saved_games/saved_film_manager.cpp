@@ -27,6 +27,7 @@
 #include "saved_games/saved_film_scratch_memory.hpp"
 #include "saved_games/saved_film_snippet.hpp"
 #include "simulation/simulation.hpp"
+#include "simulation/simulation_replay_benchmark.hpp"
 
 namespace
 {
@@ -187,6 +188,7 @@ void saved_film_manager_close()
 	else
 	{
 		saved_film_manager_globals.film_close_in_progress = true;
+		simulation_replay_notify_film_closed();
 		saved_film_manager_globals.saved_film.close();
 		saved_film_manager_clear_playback_state();
 		saved_film_manager_globals.pending_gamestate_load = false;
@@ -1053,6 +1055,7 @@ bool saved_film_manager_open_film_for_writing(const char* film_name, const game_
 		if (success)
 		{
 			saved_film_manager_globals.saved_film_name.set(film_name);
+			simulation_replay_notify_film_opened_for_writing(saved_film_path.get_string());
 		}
 		else
 		{
@@ -6,6 +6,7 @@
 #include "main/console.hpp"
 #include "main/global_preferences.hpp"
 #include "main/main.hpp"
+#include "main/main_headless.hpp"
 #include "memory/module.hpp"
 #include "multithreading/threads.hpp"
 #include "rasterizer/rasterizer.hpp"
@@ -528,6 +529,11 @@ int WINAPI _WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLin
 		g_physical_memory_cache_size_increase_mb = static_cast<uns32>(cache_size_increase);
 	}
 
+	if (shell_get_command_line_parameter(g_windows_params.cmd_line, "-headless", NULL, 0))
+	{
+		main_headless_set_enabled(true);
+	}
+
 	if (shell_get_command_line_parameter(g_windows_params.cmd_line, "-editor", NULL, 0))
 	{
 		g_windows_params.editor_window_create = true;
@@ -0,0 +1,468 @@
+#include "simulation/simulation_replay_benchmark.hpp"
+
+#include "config/version.hpp"
+#include "cseries/cseries_events.hpp"
+#include "game/game.hpp"
+#include "game/game_time.hpp"
+#include "main/main.hpp"
+#include "main/main_headless.hpp"
+#include "main/main_time.hpp"
+#include "saved_games/saved_film_manager.hpp"
+#include "tag_files/files.hpp"
+
+enum
+{
+	k_simulation_replay_playback_game_speed = 30,
+};
+
+s_simulation_replay_globals g_simulation_replay_globals
+{
+	.record_checksums = false,
+	.recording = false,
+	.requested_checkpoint_interval = k_simulation_replay_default_checkpoint_interval,
+	.checkpoint_interval = k_simulation_replay_default_checkpoint_interval,
+};
+
+static const char* const k_simulation_replay_phase_names[k_simulation_replay_phase_count]
+{
+	"ai_update",
+	"objects_update",
+	"havok_update",
+	"hs_update",
+	"game_engine_update",
+};
+
+static c_stop_watch* simulation_replay_tick_stop_watch()
+{
+	static c_stop_watch stop_watch(true);
+	return &stop_watch;
+}
+
+static real32 simulation_replay_cycles_to_milliseconds(int64 cycles)
+{
+	return 1000.0f * c_stop_watch::cycles_to_seconds(cycles);
+}
+
+c_simulation_replay_phase_timer::c_simulation_replay_phase_timer(e_simulation_replay_phase phase) :
+	m_phase(phase),
+	m_running(true),
+	m_timing(g_simulation_replay_globals.benchmark_running),
+	m_stop_watch(true)
+{
+	if (m_timing)
+	{
+		m_stop_watch.reset();
+		m_stop_watch.start();
+	}
+}
+
+bool c_simulation_replay_phase_timer::running() const
+{
+	return m_running;
+}
+
+void c_simulation_replay_phase_timer::stop()
+{
+	m_running = false;
+
+	if (m_timing)
+	{
+		int64 cycles = m_stop_watch.stop();
+		g_simulation_replay_globals.phase_cycles[m_phase] += cycles;
+		g_simulation_replay_globals.maximum_phase_cycles[m_phase] = MAX(g_simulation_replay_globals.maximum_phase_cycles[m_phase], cycles);
+	}
+}
+
+const char* simulation_replay_phase_get_name(e_simulation_replay_phase phase)
+{
+	ASSERT(VALID_INDEX(phase, k_simulation_replay_phase_count));
+
+	return k_simulation_replay_phase_names[phase];
+}
+
+static void simulation_replay_build_checksums_path(const char* film_path, c_static_string<256>* checksums_path)
+{
+	checksums_path->print("%s.checksums", film_path);
+}
+
+void simulation_replay_record_checksums(bool record_checksums, int32 checkpoint_interval)
+{
+	g_simulation_replay_globals.record_checksums = record_checksums;
+	if (checkpoint_interval > 0)
+	{
+		g_simulation_replay_globals.requested_checkpoint_interval = checkpoint_interval;
+	}
+}
+
+void simulation_replay_notify_film_opened_for_writing(const char* film_path)
+{
+	ASSERT(film_path);
+
+	g_simulation_replay_globals.recording = g_simulation_replay_globals.record_checksums;
+	g_simulation_replay_globals.checkpoint_interval = g_simulation_replay_globals.requested_checkpoint_interval;
+	g_simulation_replay_globals.checkpoint_count = 0;
+	simulation_replay_build_checksums_path(film_path, &g_simulation_replay_globals.checksums_path);
+}
+
+void simulation_replay_notify_film_closed()
+{
+	if (!g_simulation_replay_globals.recording)
+	{
+		return;
+	}
+
+	g_simulation_replay_globals.recording = false;
+
+	s_simulation_replay_checksums_header header{};
+	header.signature = k_simulation_replay_checksums_signature;
+	header.version = k_simulation_replay_checksums_version;
+	header.checkpoint_interval = g_simulation_replay_globals.checkpoint_interval;
+	header.checkpoint_count = g_simulation_replay_globals.checkpoint_count;
+
+	s_file_reference file{};
+	file_reference_create_from_path(&file, g_simulation_replay_globals.checksums_path.get_string(), false);
+
+	uns32 error = 0;
+	if (!file_exists(&file))
+	{
+		file_create(&file);
+	}
+
+	if (!file_open(&file, FLAG(_file_open_flag_desired_access_write), &error))
+	{
+		event(_event_warning, "networking:simulation:replay: failed to create checksums '%s' (error %d)",
+			g_simulation_replay_globals.checksums_path.get_string(),
+			error);
+		return;
+	}
+
+	bool success = file_write(&file, sizeof(header), &header)
+		&& file_write(&file, header.checkpoint_count * sizeof(s_simulation_replay_checkpoint), g_simulation_replay_globals.checkpoints);
+	file_close(&file);
+
+	if (!success)
+	{
+		event(_event_warning, "networking:simulation:replay: failed to write checksums '%s'",
+			g_simulation_replay_globals.checksums_path.get_string());
+	}
+}
+
+static bool simulation_replay_read_checksums(const char* film_name)
+{
+	c_static_string<128> film_path{};
+	saved_film_manager_build_file_path_from_name(film_name, _file_path_for_reading, &film_path);
+
+	c_static_string<256> checksums_path{};
+	simulation_replay_build_checksums_path(film_path.get_string(), &checksums_path);
+
+	s_file_reference file{};
+	file_reference_create_from_path(&file, checksums_path.get_string(), false);
+
+	uns32 error = 0;
+	if (!file_open(&file, FLAG(_file_open_flag_desired_access_read), &error))
+	{
+		event(_event_warning, "networking:simulation:replay: no checksums recorded for '%s' (error %d)",
+			film_name,
+			error);
+		return false;
+	}
+
+	s_simulation_replay_checksums_header header{};
+	bool success = file_read(&file, sizeof(header), false, &header)
+		&& header.signature == k_simulation_replay_checksums_signature
+		&& header.version == k_simulation_replay_checksums_version
+		&& IN_RANGE_INCLUSIVE(header.checkpoint_count, 0, k_simulation_replay_maximum_checkpoint_count)
+		&& file_read(&file, header.checkpoint_count * sizeof(s_simulation_replay_checkpoint), false, g_simulation_replay_globals.checkpoints);
+	file_close(&file);
+
+	if (!success)
+	{
+		event(_event_warning, "networking:simulation:replay: checksums for '%s' are invalid",
+			film_name);
+		return false;
+	}
+
+	g_simulation_replay_globals.checkpoint_count = header.checkpoint_count;
+	return true;
+}
+
+static void simulation_replay_record_checkpoint(int32 tick)
+{
+	if (tick % g_simulation_replay_globals.checkpoint_interval != 0)
+	{
+		return;
+	}
+
+	// a long recording doubles the interval and keeps the checkpoints on it instead of dropping its end
+	if (g_simulation_replay_globals.checkpoint_count == k_simulation_replay_maximum_checkpoint_count)
+	{
+		g_simulation_replay_globals.checkpoint_interval *= 2;
+
+		int32 kept_count = 0;
+		for (int32 checkpoint_index = 0; checkpoint_index < g_simulation_replay_globals.checkpoint_count; checkpoint_index++)
+		{
+			if (g_simulation_replay_globals.checkpoints[checkpoint_index].tick % g_simulation_replay_globals.checkpoint_interval == 0)
+			{
+				g_simulation_replay_globals.checkpoints[kept_count++] = g_simulation_replay_globals.checkpoints[checkpoint_index];
+			}
+		}
+		g_simulation_replay_globals.checkpoint_count = kept_count;
+
+		if (tick % g_simulation_replay_globals.checkpoint_interval != 0)
+		{
+			return;
+		}
+	}
+
+	s_simulation_replay_checkpoint* checkpoint = &g_simulation_replay_globals.checkpoints[g_simulation_replay_globals.checkpoint_count++];
+	checkpoint->tick = tick;
+	checkpoint->checksum = main_headless_simulation_checksum();
+}
+
+static void simulation_replay_verify_checkpoint(int32 tick)
+{
+	s_simulation_replay_benchmark_result* result = &g_simulation_replay_globals.result;
+
+	// checkpoints the playback skipped past, a snippet or a seek, are never verified
+	while (g_simulation_replay_globals.next_checkpoint_index < g_simulation_replay_globals.checkpoint_count
+		&& g_simulation_replay_globals.checkpoints[g_simulation_replay_globals.next_checkpoint_index].tick < tick)
+	{
+		g_simulation_replay_globals.next_checkpoint_index++;
+	}
+
+	if (g_simulation_replay_globals.next_checkpoint_index >= g_simulation_replay_globals.checkpoint_count)
+	{
+		return;
+	}
+
+	const s_simulation_replay_checkpoint* checkpoint = &g_simulation_replay_globals.checkpoints[g_simulation_replay_globals.next_checkpoint_index];
+	if (checkpoint->tick != tick)
+	{
+		return;
+	}
+
+	g_simulation_replay_globals.next_checkpoint_index++;
+
+	uns32 checksum = main_headless_simulation_checksum();
+	if (checksum == checkpoint->checksum)
+	{
+		result->verified_checkpoint_count++;
+	}
+	else
+	{
+		if (result->mismatched_checkpoint_count++ == 0)
+		{
+			result->first_mismatch_tick = tick;
+			event(_event_warning, "networking:simulation:replay: checksum %08X at tick %d doesn't match the recorded %08X",
+				checksum,
+				tick,
+				checkpoint->checksum);
+		}
+	}
+
+	if (g_simulation_replay_globals.next_checkpoint_index == g_simulation_replay_globals.checkpoint_count)
+	{
+		result->final_checksum_matched = checksum == checkpoint->checksum;
+	}
+}
+
+bool simulation_replay_benchmark_start(const char* film_name)
+{
+	ASSERT(film_name);
+
+	if (g_simulation_replay_globals.benchmark_pending || g_simulation_replay_globals.benchmark_running)
+	{
+		event(_event_warning, "networking:simulation:replay: a benchmark is already running");
+		return false;
+	}
+
+	if (!simulation_replay_read_checksums(film_name))
+	{
+		return false;
+	}
+
+	if (!main_headless_server())
+	{
+		event(_event_warning, "networking:simulation:replay: not running headless, tick timings include presentation work");
+	}
+
+	csmemset(&g_simulation_replay_globals.result, 0, sizeof(g_simulation_replay_globals.result));
+	g_simulation_replay_globals.result.checkpoint_count = g_simulation_replay_globals.checkpoint_count;
+	g_simulation_replay_globals.result.first_mismatch_tick = NONE;
+	g_simulation_replay_globals.result.final_tick = NONE;
+	if (g_simulation_replay_globals.checkpoint_count > 0)
+	{
+		const s_simulation_replay_checkpoint* final_checkpoint = &g_simulation_replay_globals.checkpoints[g_simulation_replay_globals.checkpoint_count - 1];
+		g_simulation_replay_globals.result.final_tick = final_checkpoint->tick;
+		g_simulation_replay_globals.result.final_checksum = final_checkpoint->checksum;
+	}
+
+	g_simulation_replay_globals.next_checkpoint_index = 0;
+	g_simulation_replay_globals.tick_cycles = 0;
+	g_simulation_replay_globals.maximum_tick_cycles = 0;
+	csmemset(g_simulation_replay_globals.phase_cycles, 0, sizeof(g_simulation_replay_globals.phase_cycles));
+	csmemset(g_simulation_replay_globals.maximum_phase_cycles, 0, sizeof(g_simulation_replay_globals.maximum_phase_cycles));
+
+	// nothing waits on vblanks or game tick deadlines while the benchmark runs
+	g_simulation_replay_globals.previous_disable_main_loop_throttle = disable_main_loop_throttle;
+	g_simulation_replay_globals.previous_debug_disable_frame_rate_throttle = debug_disable_frame_rate_throttle;
+	g_simulation_replay_globals.previous_pace_to_game_ticks = g_main_headless_globals.pace_to_game_ticks;
+	disable_main_loop_throttle = true;
+	debug_disable_frame_rate_throttle = true;
+	g_main_headless_globals.pace_to_game_ticks = false;
+
+	g_simulation_replay_globals.film_name.set(film_name);
+	g_simulation_replay_globals.playback_speed_set = false;
+	g_simulation_replay_globals.benchmark_pending = true;
+
+	saved_film_manager_play(k_no_controller, film_name);
+
+	return true;
+}
+
+static void simulation_replay_benchmark_finish()
+{
+	s_simulation_replay_benchmark_result* result = &g_simulation_replay_globals.result;
+
+	g_simulation_replay_globals.benchmark_pending = false;
+	g_simulation_replay_globals.benchmark_running = false;
+
+	disable_main_loop_throttle = g_simulation_replay_globals.previous_disable_main_loop_throttle;
+	debug_disable_frame_rate_throttle = g_simulation_replay_globals.previous_debug_disable_frame_rate_throttle;
+	g_main_headless_globals.pace_to_game_ticks = g_simulation_replay_globals.previous_pace_to_game_ticks;
+
+	result->wall_seconds = 0.001f * (system_milliseconds() - g_simulation_replay_globals.start_milliseconds);
+	if (result->tick_count > 0)
+	{
+		result->tick_milliseconds = simulation_replay_cycles_to_milliseconds(g_simulation_replay_globals.tick_cycles) / result->tick_count;
+		for (int32 phase = 0; phase < k_simulation_replay_phase_count; phase++)
+		{
+			result->phase_milliseconds[phase] = simulation_replay_cycles_to_milliseconds(g_simulation_replay_globals.phase_cycles[phase]) / result->tick_count;
+		}
+	}
+	result->maximum_tick_milliseconds = simulation_replay_cycles_to_milliseconds(g_simulation_replay_globals.maximum_tick_cycles);
+	for (int32 phase = 0; phase < k_simulation_replay_phase_count; phase++)
+	{
+		result->maximum_phase_milliseconds[phase] = simulation_replay_cycles_to_milliseconds(g_simulation_replay_globals.maximum_phase_cycles[phase]);
+	}
+
+	// appended to a report file so every run leaves a baseline behind
+	s_file_reference report_file{};
+	create_report_file_reference(&report_file, "replay_benchmark.txt", true);
+
+	uns32 error = 0;
+	if (!file_exists(&report_file))
+	{
+		file_create(&report_file);
+	}
+
+	if (file_open(&report_file, FLAG(_file_open_flag_desired_access_write), &error))
+	{
+		uns32 file_size = 0;
+		file_get_size(&report_file, &file_size);
+		file_set_position(&report_file, file_size, false);
+
+		file_printf(&report_file, "%s, %s, %d ticks, %.2f s, %.3f ms per tick, %.3f ms maximum",
+			version_get_full_string(),
+			g_simulation_replay_globals.film_name.get_string(),
+			result->tick_count,
+			result->wall_seconds,
+			result->tick_milliseconds,
+			result->maximum_tick_milliseconds);
+
+		for (int32 phase = 0; phase < k_simulation_replay_phase_count; phase++)
+		{
+			file_printf(&report_file, ", %s %.3f ms", k_simulation_replay_phase_names[phase], result->phase_milliseconds[phase]);
+		}
+
+		file_printf(&report_file, ", %d/%d checkpoints verified, final checksum %s\r\n",
+			result->verified_checkpoint_count,
+			result->checkpoint_count,
+			result->final_checksum_matched ? "matched" : "mismatched");
+
+		file_close(&report_file);
+	}
+
+	event(_event_message, "networking:simulation:replay: '%s' %d ticks in %.2f s, %d/%d checkpoints verified, final checksum %s",
+		g_simulation_replay_globals.film_name.get_string(),
+		result->tick_count,
+		result->wall_seconds,
+		result->verified_checkpoint_count,
+		result->checkpoint_count,
+		result->final_checksum_matched ? "matched" : "mismatched");
+}
+
+void simulation_replay_benchmark_update()
+{
+	if (g_simulation_replay_globals.benchmark_pending)
+	{
+		if (!game_in_progress() || !game_is_authoritative_playback())
+		{
+			return;
+		}
+
+		g_simulation_replay_globals.benchmark_pending = false;
+		g_simulation_replay_globals.benchmark_running = true;
+		g_simulation_replay_globals.start_milliseconds = system_milliseconds();
+	}
+
+	if (!g_simulation_replay_globals.benchmark_running)
+	{
+		return;
+	}
+
+	if (!g_simulation_replay_globals.playback_speed_set)
+	{
+		saved_film_manager_playback_lock_set(real32(k_simulation_replay_playback_game_speed), true);
+		g_simulation_replay_globals.playback_speed_set = true;
+	}
+
+	if (!game_in_progress() || saved_film_manager_film_is_ended(NULL) || saved_film_manager_playback_aborted())
+	{
+		simulation_replay_benchmark_finish();
+	}
+}
+
+bool simulation_replay_benchmark_running()
+{
+	return g_simulation_replay_globals.benchmark_pending || g_simulation_replay_globals.benchmark_running;
+}
+
+const s_simulation_replay_benchmark_result* simulation_replay_benchmark_get_result()
+{
+	return &g_simulation_replay_globals.result;
+}
+
+void simulation_replay_game_tick_begin()
+{
+	if (!g_simulation_replay_globals.benchmark_running)
+	{
+		return;
+	}
+
+	c_stop_watch* stop_watch = simulation_replay_tick_stop_watch();
+	stop_watch->reset();
+	stop_watch->start();
+}
+
+void simulation_replay_game_tick_end()
+{
+	if (g_simulation_replay_globals.recording && !game_is_playback())
+	{
+		simulation_replay_record_checkpoint(game_time_get());
+	}
+
+	if (!g_simulation_replay_globals.benchmark_running)
+	{
+		return;
+	}
+
+	int64 cycles = simulation_replay_tick_stop_watch()->stop();
+	g_simulation_replay_globals.tick_cycles += cycles;
+	g_simulation_replay_globals.maximum_tick_cycles = MAX(g_simulation_replay_globals.maximum_tick_cycles, cycles);
+	g_simulation_replay_globals.result.tick_count++;
+
+	// verified outside the tick timing so the checksum doesn't count against the phases
+	simulation_replay_verify_checkpoint(game_time_get());
+}
+
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "cseries/cseries.hpp"
+#include "profiler/profiler_stopwatch.hpp"
+
+// films are recorded with a checksum of the simulation every `checkpoint_interval` ticks, written next to the film,
+// the benchmark plays a film back at the fastest playback speed, times the heavy phases of every game tick
+// and verifies each checkpoint it reaches against the recording
+
+#define SIMULATION_REPLAY_PHASE(phase) for (c_simulation_replay_phase_timer _phase_timer(phase); _phase_timer.running(); _phase_timer.stop())
+
+enum e_simulation_replay_phase
+{
+	_simulation_replay_phase_ai = 0,
+	_simulation_replay_phase_objects,
+	_simulation_replay_phase_havok,
+	_simulation_replay_phase_hs,
+	_simulation_replay_phase_game_engine,
+
+	k_simulation_replay_phase_count
+};
+
+enum
+{
+	k_simulation_replay_checksums_signature = 'srck',
+	k_simulation_replay_checksums_version = 1,
+
+	k_simulation_replay_maximum_checkpoint_count = 4096,
+	k_simulation_replay_default_checkpoint_interval = 30,
+};
+
+struct s_simulation_replay_checkpoint
+{
+	int32 tick;
+	uns32 checksum;
+};
+static_assert(sizeof(s_simulation_replay_checkpoint) == 0x8);
+
+struct s_simulation_replay_checksums_header
+{
+	tag signature;
+	int32 version;
+	int32 checkpoint_interval;
+	int32 checkpoint_count;
+};
+static_assert(sizeof(s_simulation_replay_checksums_header) == 0x10);
+
+struct s_simulation_replay_benchmark_result
+{
+	int32 tick_count;
+	real32 wall_seconds;
+	real32 tick_milliseconds;
+	real32 maximum_tick_milliseconds;
+	real32 phase_milliseconds[k_simulation_replay_phase_count];
+	real32 maximum_phase_milliseconds[k_simulation_replay_phase_count];
+
+	int32 checkpoint_count;
+	int32 verified_checkpoint_count;
+	int32 mismatched_checkpoint_count;
+	int32 first_mismatch_tick;
+
+	// the last checkpoint of the recording, the final state the playback is verified against
+	int32 final_tick;
+	uns32 final_checksum;
+	bool final_checksum_matched;
+};
+
+struct s_simulation_replay_globals
+{
+	// recording
+	bool record_checksums;
+	bool recording;
+	int32 requested_checkpoint_interval;
+	int32 checkpoint_interval;
+	c_static_string<256> checksums_path;
+
+	// the recorded checkpoints while recording, the expected checkpoints while benchmarking
+	int32 checkpoint_count;
+	s_simulation_replay_checkpoint checkpoints[k_simulation_replay_maximum_checkpoint_count];
+
+	// benchmark
+	bool benchmark_pending;
+	bool benchmark_running;
+	bool playback_speed_set;
+	c_static_string<256> film_name;
+	int32 next_checkpoint_index;
+	uns32 start_milliseconds;
+	int64 tick_cycles;
+	int64 maximum_tick_cycles;
+	int64 phase_cycles[k_simulation_replay_phase_count];
+	int64 maximum_phase_cycles[k_simulation_replay_phase_count];
+	s_simulation_replay_benchmark_result result;
+
+	bool previous_disable_main_loop_throttle;
+	bool previous_debug_disable_frame_rate_throttle;
+	bool previous_pace_to_game_ticks;
+};
+
+class c_simulation_replay_phase_timer
+{
+public:
+	c_simulation_replay_phase_timer(e_simulation_replay_phase phase);
+
+	bool running() const;
+	void stop();
+
+protected:
+	e_simulation_replay_phase m_phase;
+	bool m_running;
+	bool m_timing;
+	c_stop_watch m_stop_watch;
+};
+
+extern s_simulation_replay_globals g_simulation_replay_globals;
+
+extern void simulation_replay_record_checksums(bool record_checksums, int32 checkpoint_interval);
+extern void simulation_replay_notify_film_opened_for_writing(const char* film_path);
+extern void simulation_replay_notify_film_closed();
+extern bool simulation_replay_benchmark_start(const char* film_name);
+extern void simulation_replay_benchmark_update();
+extern void simulation_replay_game_tick_begin();
+extern void simulation_replay_game_tick_end();
+extern bool simulation_replay_benchmark_running();
+extern const s_simulation_replay_benchmark_result* simulation_replay_benchmark_get_result();
+extern const char* simulation_replay_phase_get_name(e_simulation_replay_phase phase);
+
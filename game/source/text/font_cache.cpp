@@ -2,8 +2,10 @@
 
 #include "memory/module.hpp"
 #include "text/font_fallback.hpp"
+#include "text/font_glyph_cache.hpp"
 #include "text/font_loading.hpp"
 
+HOOK_DECLARE(0x0065A670, font_cache_load_internal);
 HOOK_DECLARE(0x0065A960, font_cache_retrieve_character);
 
 c_font_cache_base::c_font_cache_base() :
@@ -38,11 +40,15 @@ c_font_cache_mt_safe::~c_font_cache_mt_safe()
 void __cdecl font_cache_delete()
 {
 	INVOKE(0x0065A0E0, font_cache_delete);
+
+	font_glyph_cache_invalidate();
 }
 
 void __cdecl font_cache_flush()
 {
 	INVOKE(0x0065A200, font_cache_flush);
+
+	font_glyph_cache_invalidate();
 }
 
 void __cdecl font_cache_idle()
@@ -50,11 +56,42 @@ void __cdecl font_cache_idle()
 	INVOKE(0x0065A510, font_cache_idle);
 }
 
-//.text:0065A670 ; e_character_status __cdecl font_cache_load_internal(c_font_cache_mt_safe*, e_font_id, e_utf32, c_flags<e_font_cache_flags, uns32, 3>, uns32*, e_character_data_index*, const s_font_character**)
+e_character_status __cdecl font_cache_load_internal(c_font_cache_mt_safe* font_cache, e_font_id font_id, e_utf32 character, c_flags<e_font_cache_flags, uns32, k_font_cache_flag_count> flags, uns32* a5, e_character_data_index* out_character_data_index, const s_font_character** out_font_character)
+{
+	//return INVOKE(0x0065A670, font_cache_load_internal, font_cache, font_id, character, flags, a5, out_character_data_index, out_font_character);
+
+	// every character load, through `font_cache_retrieve_character` or the vtable, can take the slot of one the glyph cache holds,
+	// the slot it hands back tells the glyph cache which entries that evicted
+	if (out_character_data_index)
+	{
+		*out_character_data_index = e_character_data_index(NONE);
+	}
+
+	e_character_status result = _character_status_invalid;
+	HOOK_INVOKE(result =, font_cache_load_internal, font_cache, font_id, character, flags, a5, out_character_data_index, out_font_character);
+
+	if (!out_character_data_index)
+	{
+		// without the slot there's no telling what was evicted
+		if (result != _character_status_invalid)
+		{
+			font_glyph_cache_invalidate();
+		}
+	}
+	else if (*out_character_data_index != e_character_data_index(NONE))
+	{
+		uns32 key = (uns32(font_get_font_index(font_id)) << 16) | (uns32(character) & 0xFFFF);
+		font_glyph_cache_character_loaded(key, *out_character_data_index);
+	}
+
+	return result;
+}
 
 void __cdecl font_cache_new()
 {
 	INVOKE(0x0065A890, font_cache_new);
+
+	font_glyph_cache_invalidate();
 }
 
 //.text:0065A950 ; void __cdecl font_cache_precache()
@@ -68,8 +105,15 @@ e_character_status __cdecl font_cache_retrieve_character(uns32 key, c_flags<e_fo
 		return _character_status_ready;
 	}
 
+	int32 generation = NONE;
+	if (font_glyph_cache_lookup(key, out_character, out_pixel_data, &generation))
+	{
+		return _character_status_ready;
+	}
+
 	e_character_status result = _character_status_invalid;
 	HOOK_INVOKE(result =, font_cache_retrieve_character, key, flags, out_character, out_pixel_data);
+	font_glyph_cache_retrieved(key, result, *out_character, *out_pixel_data, generation);
 	return result;
 }
 
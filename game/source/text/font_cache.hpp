@@ -90,5 +90,6 @@ extern void __cdecl font_cache_delete();
 extern void __cdecl font_cache_flush();
 extern void __cdecl font_cache_idle();
 extern void __cdecl font_cache_new();
+extern e_character_status __cdecl font_cache_load_internal(c_font_cache_mt_safe* font_cache, e_font_id font_id, e_utf32 character, c_flags<e_font_cache_flags, uns32, k_font_cache_flag_count> flags, uns32* a5, e_character_data_index* out_character_data_index, const s_font_character** out_font_character);
 extern e_character_status __cdecl font_cache_retrieve_character(uns32 key, c_flags<e_font_cache_flags, uns32, k_font_cache_flag_count> flags, const s_font_character** out_character, const void** out_pixel_data);
 
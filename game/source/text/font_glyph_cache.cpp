@@ -0,0 +1,528 @@
+#include "text/font_glyph_cache.hpp"
+
+#include "interface/interface.hpp"
+#include "main/console.hpp"
+#include "profiler/profiler_stopwatch.hpp"
+#include "text/draw_string.hpp"
+#include "text/font_cache.hpp"
+#include "text/font_loading.hpp"
+#include "text/unicode.hpp"
+
+enum
+{
+	k_font_glyph_cache_batch_hash_count = 2048,
+
+	k_font_glyph_cache_scoreboard_player_count = 16,
+	k_font_glyph_cache_scoreboard_string_count = 1 + 2 + k_font_glyph_cache_scoreboard_player_count + 3,
+	k_font_glyph_cache_scoreboard_string_length = 128,
+	k_font_glyph_cache_scoreboard_line_height = 16,
+};
+
+s_font_glyph_cache_globals g_font_glyph_cache_globals
+{
+	.enabled = true,
+	.generation = 1,
+};
+
+// the character data slot the last load on this thread put `key` in, and the generation it claimed the slot with
+struct s_font_glyph_cache_thread_load
+{
+	uns32 key;
+	int32 data_slot_index;
+	int32 data_slot_generation;
+};
+thread_local s_font_glyph_cache_thread_load g_font_glyph_cache_thread_load{ .key = NONE };
+
+static int32 font_glyph_cache_hash(uns32 key)
+{
+	return int32(((key & 0xFFFF) * 0x9E3779B1) >> 23) & (k_font_glyph_cache_entries_per_font - 1);
+}
+
+static int32 font_glyph_cache_data_slot_hash(int32 character_data_index)
+{
+	return int32((uns32(character_data_index) * 0x9E3779B1) >> 21) & (k_font_glyph_cache_data_slot_count - 1);
+}
+
+// called by every font cache character load, a slot that now holds a different character was evicted,
+// a character that was already resident comes back with its own slot and invalidates nothing
+void font_glyph_cache_character_loaded(uns32 key, int32 character_data_index)
+{
+	int32 data_slot_index = font_glyph_cache_data_slot_hash(character_data_index);
+	int32 data_slot_generation = g_font_glyph_cache_globals.data_slot_generations[data_slot_index].peek();
+	if (g_font_glyph_cache_globals.data_slot_keys[data_slot_index] != key)
+	{
+		g_font_glyph_cache_globals.data_slot_keys[data_slot_index] = key;
+		data_slot_generation = g_font_glyph_cache_globals.data_slot_generations[data_slot_index].increment();
+		g_font_glyph_cache_globals.statistics.eviction_count.increment();
+	}
+
+	g_font_glyph_cache_thread_load.key = key;
+	g_font_glyph_cache_thread_load.data_slot_index = data_slot_index;
+	g_font_glyph_cache_thread_load.data_slot_generation = data_slot_generation;
+}
+
+void font_glyph_cache_invalidate()
+{
+	g_font_glyph_cache_globals.generation.increment();
+	g_font_glyph_cache_globals.statistics.invalidation_count.increment();
+}
+
+// `out_generation` is the generation the lookup saw, a miss hands it back to `font_glyph_cache_retrieved`
+// so a character retrieved before an invalidation can't be stamped with the generation after it
+bool font_glyph_cache_lookup(uns32 key, const s_font_character** out_character, const void** out_pixel_data, int32* out_generation)
+{
+	int32 generation = g_font_glyph_cache_globals.generation.peek();
+	*out_generation = generation;
+
+	uns16 font_index = uns16(key >> 16);
+	if (!g_font_glyph_cache_globals.enabled || font_index >= k_font_glyph_cache_font_count)
+	{
+		return false;
+	}
+
+	s_font_glyph_cache_entry* entries = g_font_glyph_cache_globals.entries[font_index];
+	int32 home_index = font_glyph_cache_hash(key);
+	for (int32 probe_index = 0; probe_index < k_font_glyph_cache_maximum_probes; probe_index++)
+	{
+		s_font_glyph_cache_entry* entry = &entries[(home_index + probe_index) & (k_font_glyph_cache_entries_per_font - 1)];
+
+		int32 sequence = entry->sequence.peek();
+		if (TEST_BIT(sequence, 0))
+		{
+			continue;
+		}
+
+		uns32 entry_key = entry->key;
+		const s_font_character* character = entry->character;
+		const void* pixel_data = entry->pixel_data;
+		int32 entry_generation = entry->generation.peek();
+		int32 data_slot_index = entry->data_slot_index;
+		int32 data_slot_generation = entry->data_slot_generation;
+
+		if (entry->sequence.peek() != sequence)
+		{
+			continue;
+		}
+
+		// slots are only ever filled in probe order within a generation, so an empty one ends the chain
+		if (entry_generation != generation)
+		{
+			break;
+		}
+
+		if (entry_key == key)
+		{
+			// a key has one entry per generation, if its character was evicted there is nothing further along the chain
+			if (g_font_glyph_cache_globals.data_slot_generations[data_slot_index].peek() != data_slot_generation)
+			{
+				g_font_glyph_cache_globals.statistics.stale_count.increment();
+				break;
+			}
+
+			*out_character = character;
+			*out_pixel_data = pixel_data;
+			g_font_glyph_cache_globals.statistics.hit_count.increment();
+			return true;
+		}
+	}
+
+	g_font_glyph_cache_globals.statistics.miss_count.increment();
+	return false;
+}
+
+static void font_glyph_cache_insert(uns32 key, const s_font_character* character, const void* pixel_data, int32 generation, const s_font_glyph_cache_thread_load* load)
+{
+	// writers only show up on misses, a spin lock keeps two of them from filling the same slot
+	while (g_font_glyph_cache_globals.writer_lock.set_if_equal(1, 0) != 0)
+	{
+	}
+
+	if (g_font_glyph_cache_globals.generation.peek() == generation)
+	{
+		s_font_glyph_cache_entry* entries = g_font_glyph_cache_globals.entries[uns16(key >> 16)];
+		int32 home_index = font_glyph_cache_hash(key);
+
+		// the entry already holding the key is reused, failing that the first empty or evicted one
+		s_font_glyph_cache_entry* slot = NULL;
+		for (int32 probe_index = 0; probe_index < k_font_glyph_cache_maximum_probes; probe_index++)
+		{
+			s_font_glyph_cache_entry* entry = &entries[(home_index + probe_index) & (k_font_glyph_cache_entries_per_font - 1)];
+			if (entry->generation.peek() != generation)
+			{
+				if (!slot)
+				{
+					slot = entry;
+				}
+				break;
+			}
+
+			if (entry->key == key)
+			{
+				slot = entry;
+				break;
+			}
+
+			if (!slot && g_font_glyph_cache_globals.data_slot_generations[entry->data_slot_index].peek() != entry->data_slot_generation)
+			{
+				slot = entry;
+			}
+		}
+
+		if (!slot)
+		{
+			slot = &entries[home_index];
+			g_font_glyph_cache_globals.statistics.collision_count.increment();
+		}
+
+		slot->sequence.increment();
+		slot->key = key;
+		slot->character = character;
+		slot->pixel_data = pixel_data;
+		slot->data_slot_index = load->data_slot_index;
+		slot->data_slot_generation = load->data_slot_generation;
+		slot->generation.set(generation);
+		slot->sequence.increment();
+
+		g_font_glyph_cache_globals.statistics.insert_count.increment();
+	}
+
+	g_font_glyph_cache_globals.writer_lock.set(0);
+}
+
+void font_glyph_cache_retrieved(uns32 key, e_character_status status, const s_font_character* character, const void* pixel_data, int32 generation)
+{
+	if (status != _character_status_ready
+		|| !g_font_glyph_cache_globals.enabled
+		|| uns16(key >> 16) >= k_font_glyph_cache_font_count)
+	{
+		return;
+	}
+
+	// only a character whose data slot this thread saw it loaded into can be cached, if the slot has been
+	// taken by another character since then the entry is stale from the start and the next lookup misses
+	const s_font_glyph_cache_thread_load* load = &g_font_glyph_cache_thread_load;
+	if (load->key != key)
+	{
+		return;
+	}
+
+	font_glyph_cache_insert(key, character, pixel_data, generation, load);
+}
+
+int32 font_glyph_cache_resolve_string(e_font_id font, const wchar_t* string, int32 string_length, s_font_glyph* glyphs)
+{
+	ASSERT(string);
+	ASSERT(glyphs);
+	ASSERT(IN_RANGE_INCLUSIVE(string_length, 0, k_font_glyph_cache_maximum_batch_characters));
+
+	g_font_glyph_cache_globals.statistics.batch_count.increment();
+
+	int32 generation = g_font_glyph_cache_globals.generation.peek();
+	int32 eviction_count = g_font_glyph_cache_globals.statistics.eviction_count.peek();
+
+	e_font_index font_index = font_get_font_index(font);
+	if (font_index == _font_index_none)
+	{
+		csmemset(glyphs, 0, sizeof(s_font_glyph) * string_length);
+		return string_length;
+	}
+
+	// every distinct missing character is retrieved once however many times it shows up in the string
+	int16 miss_slots[k_font_glyph_cache_batch_hash_count];
+	uns32 miss_keys[k_font_glyph_cache_maximum_batch_characters];
+	int16 glyph_miss_indices[k_font_glyph_cache_maximum_batch_characters];
+	int32 miss_count = 0;
+	csmemset(miss_slots, NONE, sizeof(miss_slots));
+
+	for (int32 character_index = 0; character_index < string_length; character_index++)
+	{
+		s_font_glyph* glyph = &glyphs[character_index];
+		uns32 key = (uns32(font_index) << 16) | (uns32(string[character_index]) & 0xFFFF);
+
+		int32 lookup_generation = NONE;
+		glyph_miss_indices[character_index] = NONE;
+		if (font_glyph_cache_lookup(key, &glyph->character, &glyph->pixel_data, &lookup_generation))
+		{
+			glyph->status = _character_status_ready;
+			continue;
+		}
+
+		glyph->status = _character_status_invalid;
+		glyph->character = NULL;
+		glyph->pixel_data = NULL;
+
+		int32 slot_index = font_glyph_cache_hash(key) << 2;
+		while (miss_slots[slot_index] != NONE && miss_keys[miss_slots[slot_index]] != key)
+		{
+			slot_index = (slot_index + 1) & (k_font_glyph_cache_batch_hash_count - 1);
+		}
+
+		if (miss_slots[slot_index] == NONE)
+		{
+			miss_slots[slot_index] = int16(miss_count);
+			miss_keys[miss_count++] = key;
+		}
+		else
+		{
+			g_font_glyph_cache_globals.statistics.deduplicated_count.increment();
+		}
+		glyph_miss_indices[character_index] = miss_slots[slot_index];
+	}
+
+	if (miss_count == 0)
+	{
+		return 0;
+	}
+
+	// without the block bit the font cache queues anything not resident on the async loader and returns loading
+	s_font_glyph miss_glyphs[k_font_glyph_cache_maximum_batch_characters];
+	for (int32 miss_index = 0; miss_index < miss_count; miss_index++)
+	{
+		s_font_glyph* miss_glyph = &miss_glyphs[miss_index];
+		miss_glyph->character = NULL;
+		miss_glyph->pixel_data = NULL;
+		miss_glyph->status = font_cache_retrieve_character(miss_keys[miss_index], FLAG(_font_cache_load_bit), &miss_glyph->character, &miss_glyph->pixel_data);
+	}
+
+	// only if loading the misses evicted something can the hits from before them be gone and have to be retrieved again
+	bool hits_stale = g_font_glyph_cache_globals.generation.peek() != generation
+		|| g_font_glyph_cache_globals.statistics.eviction_count.peek() != eviction_count;
+
+	int32 unresolved_count = 0;
+	for (int32 character_index = 0; character_index < string_length; character_index++)
+	{
+		int32 miss_index = glyph_miss_indices[character_index];
+		if (miss_index == NONE)
+		{
+			if (hits_stale)
+			{
+				s_font_glyph* glyph = &glyphs[character_index];
+				uns32 key = (uns32(font_index) << 16) | (uns32(string[character_index]) & 0xFFFF);
+				glyph->status = font_cache_retrieve_character(key, FLAG(_font_cache_load_bit), &glyph->character, &glyph->pixel_data);
+				if (glyph->status != _character_status_ready)
+				{
+					unresolved_count++;
+				}
+			}
+			continue;
+		}
+
+		glyphs[character_index] = miss_glyphs[miss_index];
+		if (glyphs[character_index].status != _character_status_ready)
+		{
+			unresolved_count++;
+		}
+	}
+
+	return unresolved_count;
+}
+
+void font_glyph_cache_set_enabled(bool enabled)
+{
+	if (g_font_glyph_cache_globals.enabled != enabled)
+	{
+		font_glyph_cache_invalidate();
+		g_font_glyph_cache_globals.enabled = enabled;
+	}
+}
+
+void font_glyph_cache_benchmark_start(int32 iterations)
+{
+	g_font_glyph_cache_globals.benchmark_pending_iterations = MAX(1, iterations);
+}
+
+// the text of a full 16 player multiplayer scoreboard, names and numbers differ per row so most characters of the font get touched
+static int32 font_glyph_cache_build_scoreboard(wchar_t(*strings)[k_font_glyph_cache_scoreboard_string_length])
+{
+	static const wchar_t* const player_names[k_font_glyph_cache_scoreboard_player_count]
+	{
+		L"Spartan-117", L"Noble Six", L"Thel 'Vadam", L"Buck", L"Romeo", L"Dutch", L"Mickey", L"Rookie",
+		L"Jorge-052", L"Kat-B320", L"Emile-A239", L"Carter-A259", L"Jun-A266", L"Palmer", L"Lasky", L"Roland",
+	};
+
+	int32 string_count = 0;
+	usnzprintf(strings[string_count++], k_font_glyph_cache_scoreboard_string_length, L"Slayer on Guardian - 12:34 remaining - Round 2 of 3");
+	usnzprintf(strings[string_count++], k_font_glyph_cache_scoreboard_string_length, L"Red Team\t%d\tKills\tDeaths\tAssists\tPing", 47);
+	usnzprintf(strings[string_count++], k_font_glyph_cache_scoreboard_string_length, L"Blue Team\t%d\tKills\tDeaths\tAssists\tPing", 43);
+
+	for (int32 player_index = 0; player_index < k_font_glyph_cache_scoreboard_player_count; player_index++)
+	{
+		usnzprintf(strings[string_count++], k_font_glyph_cache_scoreboard_string_length, L"%2d. %ls [%ls]\t%d\t%d\t%d\t%d\t%dms",
+			player_index + 1,
+			player_names[player_index],
+			player_index % 2 ? L"BLUE" : L"RED",
+			50 - 3 * player_index,
+			(7 * player_index + 3) % 25,
+			(5 * player_index + 11) % 19,
+			(3 * player_index + 2) % 13,
+			24 + 17 * player_index);
+	}
+
+	usnzprintf(strings[string_count++], k_font_glyph_cache_scoreboard_string_length, L"Score to win: 50 - Time limit: 15:00 - Respawn: 5 seconds");
+	usnzprintf(strings[string_count++], k_font_glyph_cache_scoreboard_string_length, L"Press <Back> for game details, <Y> to toggle team view");
+	usnzprintf(strings[string_count++], k_font_glyph_cache_scoreboard_string_length, L"Host: Noble Six (Party of 8) - Quality: Excellent");
+
+	ASSERT(string_count == k_font_glyph_cache_scoreboard_string_count);
+	return string_count;
+}
+
+static int64 font_glyph_cache_draw_scoreboard(const wchar_t(*strings)[k_font_glyph_cache_scoreboard_string_length], int32 string_count)
+{
+	c_stop_watch stop_watch{};
+	stop_watch.reset();
+	stop_watch.stop();
+	stop_watch.start();
+
+	for (int32 string_index = 0; string_index < string_count; string_index++)
+	{
+		c_rasterizer_draw_string draw_string{};
+		c_font_cache_mt_safe font_cache{};
+		rectangle2d bounds{};
+
+		bounds.x0 = 0x0040;
+		bounds.y0 = int16(0x0040 + k_font_glyph_cache_scoreboard_line_height * string_index);
+		bounds.x1 = 0x7FFF;
+		bounds.y1 = 0x7FFF;
+
+		interface_set_bitmap_text_draw_mode(
+			&draw_string,
+			_body_text_font,
+			_text_style_plain,
+			_text_justification_left,
+			0,
+			5,
+			0);
+
+		draw_string.set_color(global_real_argb_white);
+		draw_string.set_bounds(&bounds);
+		draw_string.draw(&font_cache, strings[string_index]);
+	}
+
+	return stop_watch.stop();
+}
+
+static int64 font_glyph_cache_resolve_scoreboard(const wchar_t(*strings)[k_font_glyph_cache_scoreboard_string_length], int32 string_count, bool batched, int32* out_character_count, int32* out_unresolved_count)
+{
+	s_font_glyph glyphs[k_font_glyph_cache_scoreboard_string_length];
+	uns32 font_key = uns32(font_get_font_index(_body_text_font)) << 16;
+
+	c_stop_watch stop_watch{};
+	stop_watch.reset();
+	stop_watch.stop();
+	stop_watch.start();
+
+	for (int32 string_index = 0; string_index < string_count; string_index++)
+	{
+		int32 string_length = ustrnlen(strings[string_index], k_font_glyph_cache_scoreboard_string_length);
+		if (batched)
+		{
+			*out_unresolved_count += font_glyph_cache_resolve_string(_body_text_font, strings[string_index], string_length, glyphs);
+		}
+		else
+		{
+			// one locked lookup per character, the way `draw_string` resolves them
+			for (int32 character_index = 0; character_index < string_length; character_index++)
+			{
+				s_font_glyph* glyph = &glyphs[character_index];
+				uns32 key = font_key | (uns32(strings[string_index][character_index]) & 0xFFFF);
+				glyph->status = font_cache_retrieve_character(key, FLAG(_font_cache_load_bit), &glyph->character, &glyph->pixel_data);
+				if (glyph->status != _character_status_ready)
+				{
+					*out_unresolved_count += 1;
+				}
+			}
+		}
+		*out_character_count += string_length;
+	}
+
+	return stop_watch.stop();
+}
+
+real32 font_glyph_cache_hit_rate(int32 hit_count, int32 miss_count)
+{
+	int32 lookup_count = hit_count + miss_count;
+	return lookup_count > 0 ? 100.0f * hit_count / lookup_count : 0.0f;
+}
+
+void font_glyph_cache_render_debug()
+{
+	int32 iterations = g_font_glyph_cache_globals.benchmark_pending_iterations;
+	if (iterations <= 0)
+	{
+		return;
+	}
+	g_font_glyph_cache_globals.benchmark_pending_iterations = 0;
+
+	wchar_t strings[k_font_glyph_cache_scoreboard_string_count][k_font_glyph_cache_scoreboard_string_length]{};
+	int32 string_count = font_glyph_cache_build_scoreboard(strings);
+
+	bool enabled = g_font_glyph_cache_globals.enabled;
+
+	int64 uncached_draw_cycles = 0;
+	int64 cached_draw_cycles = 0;
+	int64 uncached_resolve_cycles = 0;
+	int64 batch_resolve_cycles = 0;
+	int32 character_count = 0;
+	int32 unresolved_count = 0;
+
+	font_glyph_cache_set_enabled(false);
+	for (int32 iteration = 0; iteration < iterations; iteration++)
+	{
+		int32 iteration_character_count = 0;
+		int32 iteration_unresolved_count = 0;
+
+		uncached_draw_cycles += font_glyph_cache_draw_scoreboard(strings, string_count);
+		uncached_resolve_cycles += font_glyph_cache_resolve_scoreboard(strings, string_count, false, &iteration_character_count, &iteration_unresolved_count);
+	}
+
+	// the cache starts out empty and stays warm across iterations as it would across frames,
+	// the hit rate includes the misses filling it on the first iteration
+	font_glyph_cache_set_enabled(true);
+	font_glyph_cache_invalidate();
+	int32 hit_count = g_font_glyph_cache_globals.statistics.hit_count.peek();
+	int32 miss_count = g_font_glyph_cache_globals.statistics.miss_count.peek();
+	for (int32 iteration = 0; iteration < iterations; iteration++)
+	{
+		int32 iteration_character_count = 0;
+		int32 iteration_unresolved_count = 0;
+
+		cached_draw_cycles += font_glyph_cache_draw_scoreboard(strings, string_count);
+		batch_resolve_cycles += font_glyph_cache_resolve_scoreboard(strings, string_count, true, &iteration_character_count, &iteration_unresolved_count);
+
+		character_count = iteration_character_count;
+		unresolved_count = iteration_unresolved_count;
+	}
+	hit_count = g_font_glyph_cache_globals.statistics.hit_count.peek() - hit_count;
+	miss_count = g_font_glyph_cache_globals.statistics.miss_count.peek() - miss_count;
+
+	font_glyph_cache_set_enabled(enabled);
+
+	s_font_glyph_cache_benchmark_results* results = &g_font_glyph_cache_globals.benchmark_results;
+	results->iterations = iterations;
+	results->string_count = string_count;
+	results->character_count = character_count;
+	results->unresolved_count = unresolved_count;
+	results->hit_count = hit_count;
+	results->miss_count = miss_count;
+	results->uncached_draw_milliseconds = 1000.0f * c_stop_watch::cycles_to_seconds(uncached_draw_cycles);
+	results->cached_draw_milliseconds = 1000.0f * c_stop_watch::cycles_to_seconds(cached_draw_cycles);
+	results->uncached_resolve_milliseconds = 1000.0f * c_stop_watch::cycles_to_seconds(uncached_resolve_cycles);
+	results->batch_resolve_milliseconds = 1000.0f * c_stop_watch::cycles_to_seconds(batch_resolve_cycles);
+
+	console_printf("font glyph cache: %d scoreboard strings, %d characters (%d not resident), %d iterations",
+		string_count,
+		character_count,
+		unresolved_count,
+		iterations);
+	console_printf("draw_string: %.3f ms uncached, %.3f ms cached",
+		results->uncached_draw_milliseconds,
+		results->cached_draw_milliseconds);
+	console_printf("resolve: %.3f ms per character, %.3f ms batched",
+		results->uncached_resolve_milliseconds,
+		results->batch_resolve_milliseconds);
+	console_printf("hit rate: %.1f%% (%d hits, %d misses)",
+		font_glyph_cache_hit_rate(results->hit_count, results->miss_count),
+		results->hit_count,
+		results->miss_count);
+}
+
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "cseries/cseries.hpp"
+#include "multithreading/synchronized_value.hpp"
+
+struct s_font_character;
+
+// resident glyphs returned by `font_cache_retrieve_character` kept in a hash per font index,
+// readers probe it without taking `FONT_CACHE_SCOPE_LOCK`, every slot is guarded by a sequence count that's odd while a writer is filling it,
+// an entry remembers the font cache character data slot its glyph was loaded into and the generation of that slot,
+// a load that puts another character into the slot bumps its generation and only entries pointing at it go stale,
+// `generation` is only bumped when the whole font cache is rebuilt or flushed
+
+enum
+{
+	k_font_glyph_cache_font_count = k_maximum_font_index_count,
+	k_font_glyph_cache_entries_per_font = 512,
+	k_font_glyph_cache_maximum_probes = 8,
+
+	k_font_glyph_cache_maximum_batch_characters = 1024,
+
+	// character data slots are folded into this many generations, two slots sharing one only invalidate each other early
+	k_font_glyph_cache_data_slot_count = 2048,
+};
+
+struct s_font_glyph_cache_entry
+{
+	c_synchronized_long sequence;
+	c_synchronized_long generation;
+	uns32 key;
+	const s_font_character* character;
+	const void* pixel_data;
+	int32 data_slot_index;
+	int32 data_slot_generation;
+};
+static_assert(sizeof(s_font_glyph_cache_entry) == 0x1C);
+
+struct s_font_glyph
+{
+	e_character_status status;
+	const s_font_character* character;
+	const void* pixel_data;
+};
+static_assert(sizeof(s_font_glyph) == 0xC);
+
+struct s_font_glyph_cache_statistics
+{
+	c_synchronized_long hit_count;
+	c_synchronized_long miss_count;
+	c_synchronized_long insert_count;
+	c_synchronized_long invalidation_count;
+	c_synchronized_long eviction_count;
+	c_synchronized_long stale_count;
+	c_synchronized_long collision_count;
+	c_synchronized_long batch_count;
+	c_synchronized_long deduplicated_count;
+};
+
+struct s_font_glyph_cache_benchmark_results
+{
+	int32 iterations;
+	int32 string_count;
+	int32 character_count;
+	int32 unresolved_count;
+	int32 hit_count;
+	int32 miss_count;
+	real32 uncached_draw_milliseconds;
+	real32 cached_draw_milliseconds;
+	real32 uncached_resolve_milliseconds;
+	real32 batch_resolve_milliseconds;
+};
+
+struct s_font_glyph_cache_globals
+{
+	bool enabled;
+
+	// entries stamped with an older generation are misses
+	c_synchronized_long generation;
+	c_synchronized_long writer_lock;
+
+	// loads are serialized by the font cache lock, `data_slot_keys` is only written from `font_glyph_cache_character_loaded`
+	uns32 data_slot_keys[k_font_glyph_cache_data_slot_count];
+	c_synchronized_long data_slot_generations[k_font_glyph_cache_data_slot_count];
+
+	s_font_glyph_cache_entry entries[k_font_glyph_cache_font_count][k_font_glyph_cache_entries_per_font];
+	s_font_glyph_cache_statistics statistics;
+
+	// the scoreboard benchmark runs from `font_glyph_cache_render_debug` as drawing needs an active render target
+	int32 benchmark_pending_iterations;
+	s_font_glyph_cache_benchmark_results benchmark_results;
+};
+
+extern s_font_glyph_cache_globals g_font_glyph_cache_globals;
+
+extern void font_glyph_cache_benchmark_start(int32 iterations);
+extern void font_glyph_cache_character_loaded(uns32 key, int32 character_data_index);
+extern real32 font_glyph_cache_hit_rate(int32 hit_count, int32 miss_count);
+extern void font_glyph_cache_invalidate();
+extern bool font_glyph_cache_lookup(uns32 key, const s_font_character** out_character, const void** out_pixel_data, int32* out_generation);
+extern void font_glyph_cache_render_debug();
+extern int32 font_glyph_cache_resolve_string(e_font_id font, const wchar_t* string, int32 string_length, s_font_glyph* glyphs);
+extern void font_glyph_cache_retrieved(uns32 key, e_character_status status, const s_font_character* character, const void* pixel_data, int32 generation);
+extern void font_glyph_cache_set_enabled(bool enabled);
+